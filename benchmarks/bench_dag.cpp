@@ -0,0 +1,73 @@
+/**
+ * @file bench_dag.cpp
+ * @brief libvssdag DAG evaluation per transform kind, by mapping size
+ *
+ * Every iteration updates all inputs once and evaluates the DAG, so the time
+ * per item is the cost of one node of that kind.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "mapping_loader.h"
+#include "synthetic_mappings.h"
+
+#include <chrono>
+#include <vector>
+
+namespace {
+
+using can2vss::bench::MappingKind;
+
+void run_dag(benchmark::State& bench, MappingKind kind) {
+    const auto count = static_cast<size_t>(bench.range(0));
+    auto config = can2vss::load_mappings(YAML::Load(can2vss::bench::synthetic_mapping_yaml(count, kind)));
+    if (!config.ok()) {
+        bench.SkipWithError(std::string(config.status().message()).c_str());
+        return;
+    }
+    vssdag::SignalProcessorDAG processor;
+    if (!processor.initialize(config->mappings)) {
+        bench.SkipWithError("DAG initialization failed");
+        return;
+    }
+
+    // Alternate between two batches so every evaluation sees changed values
+    std::vector<vssdag::SignalUpdate> batches[2];
+    for (size_t b = 0; b < 2; ++b) {
+        for (size_t i = 0; i < count; ++i) {
+            vssdag::SignalUpdate update;
+            update.signal_name = can2vss::bench::synthetic_source(i);
+            if (kind == MappingKind::VALUE_MAP) {
+                update.value = static_cast<int64_t>(b);
+            } else {
+                update.value = static_cast<double>(i + b);
+            }
+            update.timestamp = std::chrono::steady_clock::now();
+            batches[b].push_back(std::move(update));
+        }
+    }
+
+    size_t iteration = 0;
+    for (auto _ : bench) {
+        auto signals = processor.process_signal_updates(batches[iteration++ % 2]);
+        benchmark::DoNotOptimize(signals.data());
+    }
+    bench.SetItemsProcessed(bench.iterations() * static_cast<int64_t>(count));
+}
+
+void BM_DagDirect(benchmark::State& bench) {
+    run_dag(bench, MappingKind::DIRECT);
+}
+BENCHMARK(BM_DagDirect)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_DagCode(benchmark::State& bench) {
+    run_dag(bench, MappingKind::CODE);
+}
+BENCHMARK(BM_DagCode)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_DagValueMapping(benchmark::State& bench) {
+    run_dag(bench, MappingKind::VALUE_MAP);
+}
+BENCHMARK(BM_DagValueMapping)->RangeMultiplier(4)->Range(16, 1024);
+
+}  // namespace
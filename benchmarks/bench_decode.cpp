@@ -0,0 +1,167 @@
+/**
+ * @file bench_decode.cpp
+ * @brief DBC parsing and per-message decoding: linear-scan baseline vs generated
+ *
+ * Both decode benchmarks decode the Model 3 messages used by
+ * benchmarks/data/struct_mappings.yaml, restricted to its mapped signals.
+ * The baseline is a hand-rolled scan over the parsed DBC, not libvssdag's
+ * decoder, so it bounds a naive decoder rather than the generic feeder.
+ * The parse benchmarks compare reading a whole DBC with indexing it and
+ * parsing only the mapped messages, on the Model 3 DBC and on synthetic
+ * OEM-sized ones.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "can2vss_generated_decoders.h"
+#include "dbc_parser.h"
+
+#include <array>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace decoders = can2vss::generated;
+
+namespace {
+
+struct Frame {
+    uint32_t can_id;
+    uint8_t data[8];
+};
+
+constexpr std::array<Frame, 4> kFrames = {{
+    {0x257, {0x00, 0x80, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00}},
+    {0x108, {0x00, 0x00, 0x00, 0x20, 0x03, 0x10, 0x27, 0x00}},
+    {0x132, {0x10, 0x9C, 0x00, 0x00, 0x40, 0x40, 0x00, 0x00}},
+    {0x118, {0x00, 0x00, 0x08, 0x00, 0x64, 0x00, 0x00, 0x00}},
+}};
+
+void BM_DbcParse(benchmark::State& bench) {
+    for (auto _ : bench) {
+        auto db = can2vss::parse_dbc_file(CAN2VSS_BENCH_DBC);
+        if (!db.ok()) {
+            bench.SkipWithError(std::string(db.status().message()).c_str());
+            return;
+        }
+        benchmark::DoNotOptimize(db->messages.data());
+    }
+}
+BENCHMARK(BM_DbcParse)->Unit(benchmark::kMillisecond);
+
+void BM_DbcParseMapped(benchmark::State& bench) {
+    const std::set<std::string> mapped(decoders::kSignalNames.begin(), decoders::kSignalNames.end());
+    for (auto _ : bench) {
+        auto db = can2vss::parse_dbc_file_for_signals(CAN2VSS_BENCH_DBC, mapped);
+        if (!db.ok()) {
+            bench.SkipWithError(std::string(db.status().message()).c_str());
+            return;
+        }
+        benchmark::DoNotOptimize(db->messages.data());
+    }
+}
+BENCHMARK(BM_DbcParseMapped)->Unit(benchmark::kMillisecond);
+
+/// A DBC of `messages` messages with 20 signals each
+std::string synthetic_dbc(int messages) {
+    std::string dbc = "VERSION \"\"\n\nBU_: Receiver VehicleBus\n\n";
+    for (int m = 0; m < messages; ++m) {
+        dbc += "BO_ " + std::to_string(m + 1) + " Message" + std::to_string(m) + ": 8 VehicleBus\n";
+        for (int s = 0; s < 20; ++s) {
+            dbc += " SG_ Signal" + std::to_string(m) + "_" + std::to_string(s) + " : " + std::to_string(s * 3) +
+                   "|3@1+ (0.5,-10) [-10|-6.5] \"unit\"  Receiver\n";
+        }
+        dbc += "\n";
+    }
+    for (int m = 0; m < messages; ++m) {
+        dbc += "CM_ SG_ " + std::to_string(m + 1) + " Signal" + std::to_string(m) + "_0 \"comment\";\n";
+    }
+    return dbc;
+}
+
+void BM_DbcParseSynthetic_Full(benchmark::State& bench) {
+    const std::string dbc = synthetic_dbc(static_cast<int>(bench.range(0)));
+    for (auto _ : bench) {
+        std::istringstream in(dbc);
+        auto db = can2vss::parse_dbc(in);
+        benchmark::DoNotOptimize(db->messages.data());
+    }
+    bench.counters["signals"] = static_cast<double>(bench.range(0) * 20);
+}
+BENCHMARK(BM_DbcParseSynthetic_Full)->Arg(100)->Arg(1000)->Arg(5000)->Unit(benchmark::kMillisecond);
+
+// Indexes the whole DBC and parses the 4 messages a small mapping uses
+void BM_DbcParseSynthetic_Mapped(benchmark::State& bench) {
+    const std::string dbc = synthetic_dbc(static_cast<int>(bench.range(0)));
+    std::set<std::string> mapped;
+    for (int64_t m = 0; m < bench.range(0); m += bench.range(0) / 4) {
+        mapped.insert("Signal" + std::to_string(m) + "_1");
+    }
+    for (auto _ : bench) {
+        auto index = can2vss::DbcIndex::build(dbc);
+        auto db = (*index)->load_messages(mapped);
+        benchmark::DoNotOptimize(db->messages.data());
+    }
+    bench.counters["signals"] = static_cast<double>(bench.range(0) * 20);
+}
+BENCHMARK(BM_DbcParseSynthetic_Mapped)->Arg(100)->Arg(1000)->Arg(5000)->Unit(benchmark::kMillisecond);
+
+// Baseline: scans the parsed messages for the ID and decodes the mapped signal layouts
+void BM_DecodeLinearScan(benchmark::State& bench) {
+    auto db = can2vss::parse_dbc_file(CAN2VSS_BENCH_DBC);
+    if (!db.ok()) {
+        bench.SkipWithError(std::string(db.status().message()).c_str());
+        return;
+    }
+    std::vector<std::vector<const can2vss::DbcSignal*>> by_frame(kFrames.size());
+    std::vector<const can2vss::DbcMessage*> messages;
+    for (auto name : decoders::kSignalNames) {
+        const auto* message = db->find_message_for_signal(std::string(name));
+        for (size_t f = 0; f < kFrames.size(); ++f) {
+            if (message != nullptr && message->id == kFrames[f].can_id) {
+                for (const auto& signal : message->signals) {
+                    if (signal.name == name) {
+                        by_frame[f].push_back(&signal);
+                    }
+                }
+            }
+        }
+    }
+
+    size_t frame = 0;
+    int64_t decoded = 0;
+    for (auto _ : bench) {
+        const size_t f = frame++ % kFrames.size();
+        const can2vss::DbcMessage* message = nullptr;
+        for (const auto& candidate : db->messages) {
+            if (candidate.id == kFrames[f].can_id) {
+                message = &candidate;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(message);
+        for (const auto* signal : by_frame[f]) {
+            benchmark::DoNotOptimize(can2vss::decode_physical(*signal, kFrames[f].data));
+            ++decoded;
+        }
+    }
+    bench.counters["signals/msg"] = benchmark::Counter(static_cast<double>(decoded) / bench.iterations());
+}
+BENCHMARK(BM_DecodeLinearScan);
+
+void BM_DecodeGenerated(benchmark::State& bench) {
+    size_t frame = 0;
+    int64_t decoded = 0;
+    for (auto _ : bench) {
+        const Frame& f = kFrames[frame++ % kFrames.size()];
+        decoders::decode_frame(f.can_id, f.data, 8, [&](size_t, double value) {
+            benchmark::DoNotOptimize(value);
+            ++decoded;
+        });
+    }
+    bench.counters["signals/msg"] = benchmark::Counter(static_cast<double>(decoded) / bench.iterations());
+}
+BENCHMARK(BM_DecodeGenerated);
+
+}  // namespace
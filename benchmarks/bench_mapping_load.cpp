@@ -0,0 +1,39 @@
+/**
+ * @file bench_mapping_load.cpp
+ * @brief Mapping YAML parsing and conversion, by mapping size
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "mapping_loader.h"
+#include "synthetic_mappings.h"
+
+namespace {
+
+using can2vss::bench::MappingKind;
+
+void BM_MappingLoad(benchmark::State& bench) {
+    const auto count = static_cast<size_t>(bench.range(0));
+    const std::string yaml = can2vss::bench::synthetic_mapping_yaml(count, MappingKind::MIXED);
+    for (auto _ : bench) {
+        auto config = can2vss::load_mappings(YAML::Load(yaml));
+        benchmark::DoNotOptimize(config);
+    }
+    bench.SetItemsProcessed(bench.iterations() * static_cast<int64_t>(count));
+    bench.SetBytesProcessed(bench.iterations() * static_cast<int64_t>(yaml.size()));
+}
+BENCHMARK(BM_MappingLoad)->RangeMultiplier(4)->Range(16, 4096)->Unit(benchmark::kMicrosecond);
+
+// Conversion alone, without YAML parsing
+void BM_MappingConvert(benchmark::State& bench) {
+    const auto count = static_cast<size_t>(bench.range(0));
+    const YAML::Node root = YAML::Load(can2vss::bench::synthetic_mapping_yaml(count, MappingKind::MIXED));
+    for (auto _ : bench) {
+        auto config = can2vss::load_mappings(root);
+        benchmark::DoNotOptimize(config);
+    }
+    bench.SetItemsProcessed(bench.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_MappingConvert)->RangeMultiplier(4)->Range(16, 4096)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
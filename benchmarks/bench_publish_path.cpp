@@ -0,0 +1,144 @@
+/**
+ * @file bench_publish_path.cpp
+ * @brief Per-signal work on the loop thread's publish path
+ *
+ * Handle lookup mirrors the feeder's table of pre-resolved handles keyed by
+ * VSS path; QualifiedValue construction is what each published value costs
+ * before it is queued. The struct conversions compare building a fresh
+ * value per publish with the lanes' PublishValueCache.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "alloc_tracker.h"
+#include "publisher.h"
+#include "signal_priority.h"
+#include "struct_buffer.h"
+#include "synthetic_mappings.h"
+#include "typed_value.h"
+
+#include <vss/types/quality.hpp>
+#include <vss/types/value.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Same shape as the feeder's PublishTarget, without a live KUKSA handle
+struct Target {
+    std::shared_ptr<void> handle;
+    can2vss::SignalPriority priority = can2vss::SignalPriority::NORMAL;
+};
+
+void BM_HandleLookup(benchmark::State& bench) {
+    const auto count = static_cast<size_t>(bench.range(0));
+    std::unordered_map<std::string, Target> handles;
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < count; ++i) {
+        handles[can2vss::bench::synthetic_path(i)] = Target{std::make_shared<int>(0)};
+        paths.push_back(can2vss::bench::synthetic_path(i));
+    }
+
+    size_t i = 0;
+    for (auto _ : bench) {
+        auto it = handles.find(paths[i++ % count]);
+        benchmark::DoNotOptimize(it);
+    }
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_HandleLookup)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_QualifiedValueDouble(benchmark::State& bench) {
+    double value = 0.0;
+    for (auto _ : bench) {
+        vss::types::QualifiedValue<vss::types::Value> qualified;
+        qualified.value = value += 0.5;
+        qualified.quality = vss::types::SignalQuality::VALID;
+        qualified.timestamp = std::chrono::system_clock::now();
+        benchmark::DoNotOptimize(qualified);
+    }
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_QualifiedValueDouble);
+
+void BM_QualifiedValueString(benchmark::State& bench) {
+    const std::string values[2] = {"PARK", "DRIVE_WITH_A_NAME_PAST_SSO"};
+    size_t i = 0;
+    for (auto _ : bench) {
+        vss::types::QualifiedValue<vss::types::Value> qualified;
+        qualified.value = values[i++ % 2];
+        qualified.quality = vss::types::SignalQuality::VALID;
+        qualified.timestamp = std::chrono::system_clock::now();
+        benchmark::DoNotOptimize(qualified);
+    }
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_QualifiedValueString);
+
+// What compiled-in signals queue instead: a 16-byte tagged value
+void BM_TypedValue(benchmark::State& bench) {
+    double value = 0.0;
+    for (auto _ : bench) {
+        auto typed = can2vss::TypedValue::of(value += 0.5);
+        benchmark::DoNotOptimize(typed);
+    }
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_TypedValue);
+
+// Six fields, the width of the widest struct in benchmarks/data/struct_mappings.yaml
+std::unique_ptr<can2vss::StructBuffer> make_struct_buffer() {
+    std::vector<can2vss::StructBuffer::Field> fields;
+    std::vector<can2vss::TypedValue> values;
+    for (int i = 0; i < 6; ++i) {
+        fields.push_back({"FieldWithDescriptiveName" + std::to_string(i), can2vss::SlotType::DOUBLE});
+        values.push_back(can2vss::TypedValue::of(i * 1.5));
+    }
+    auto buffer = std::make_unique<can2vss::StructBuffer>("Vehicle.Synthetic.Struct", std::move(fields));
+    buffer->store(values.data());
+    return buffer;
+}
+
+void BM_StructValueFresh(benchmark::State& bench) {
+    auto buffer = make_struct_buffer();
+    std::vector<can2vss::TypedValue> fields;
+    can2vss::AllocationGuard allocations;
+    for (auto _ : bench) {
+        vss::types::QualifiedValue<vss::types::Value> qualified;
+        qualified.value = can2vss::to_vss_struct(*buffer, fields);
+        qualified.quality = vss::types::SignalQuality::VALID;
+        qualified.timestamp = std::chrono::system_clock::now();
+        benchmark::DoNotOptimize(qualified);
+    }
+    bench.SetItemsProcessed(bench.iterations());
+    bench.counters["allocs/op"] =
+        benchmark::Counter(static_cast<double>(allocations.allocations()) / bench.iterations());
+}
+BENCHMARK(BM_StructValueFresh);
+
+void BM_StructValueCached(benchmark::State& bench) {
+    auto buffer = make_struct_buffer();
+    const std::string path = "Vehicle.Synthetic.Struct";
+    can2vss::PublishRequest request;
+    request.path = &path;
+    request.typed = can2vss::TypedValue::structure({0});
+    request.structure = buffer.get();
+    request.enqueued_at = std::chrono::steady_clock::now();
+
+    can2vss::PublishValueCache cache;
+    cache.build(request);
+    can2vss::AllocationGuard allocations;
+    for (auto _ : bench) {
+        benchmark::DoNotOptimize(&cache.build(request));
+    }
+    bench.SetItemsProcessed(bench.iterations());
+    bench.counters["allocs/op"] =
+        benchmark::Counter(static_cast<double>(allocations.allocations()) / bench.iterations());
+}
+BENCHMARK(BM_StructValueCached);
+
+}  // namespace
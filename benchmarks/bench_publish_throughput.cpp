@@ -0,0 +1,204 @@
+/**
+ * @file bench_publish_throughput.cpp
+ * @brief Sustained publish throughput and queueing latency against a fake broker
+ *
+ * Each iteration is one 10 ms feeder loop cycle producing `batch` VSS
+ * updates, published through a broker with 0, 1 or 10 ms round-trip time.
+ * Inline publishing calls set() on the loop thread, as the feeder did before
+ * publish lanes, so the cycle stretches to batch * RTT; the lane hands
+ * updates to its own thread and keeps the cycle at 10 ms, until the broker
+ * link saturates and the queue fills. The lanes drop on a full queue here
+ * (--publish-drop), so a saturated link shows as drops rather than as a
+ * stretched cycle.
+ *
+ * Streaming publishing writes each batch of queued values as one message on
+ * a long-lived stream, with up to 8 unacknowledged batches in flight; the
+ * same lane against a broker without a stream falls back to one set() per
+ * value.
+ *
+ * Multi-channel publishing spreads the signals over several main lanes,
+ * each with its own broker connection (here: its own fake broker), so that
+ * several set() calls are in flight at once.
+ *
+ * Counters: updates/s reaching the broker, dropped updates, and queueing
+ * latency percentiles (enqueue to set() start). Run with
+ * --benchmark_filter=Publish to skip the CPU microbenchmarks.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "fake_broker.h"
+#include "publisher.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using can2vss::bench::FakeBroker;
+using can2vss::bench::FakeStreamBroker;
+
+constexpr auto kCycle = std::chrono::milliseconds(10);
+const std::string kPath = "Vehicle.Bench.Signal";
+
+can2vss::PublishRequest make_request(double value, std::chrono::steady_clock::time_point enqueued_at) {
+    can2vss::PublishRequest request;
+    request.path = &kPath;
+    request.qualified_value.value = value;
+    request.qualified_value.quality = vss::types::SignalQuality::VALID;
+    request.qualified_value.timestamp = std::chrono::system_clock::now();
+    request.enqueued_at = enqueued_at;
+    return request;
+}
+
+void wait_for_next_cycle(std::chrono::steady_clock::time_point cycle_start) {
+    auto elapsed = std::chrono::steady_clock::now() - cycle_start;
+    if (elapsed < kCycle) {
+        std::this_thread::sleep_for(kCycle - elapsed);
+    }
+}
+
+void report(benchmark::State& bench, const FakeBroker& broker, uint64_t dropped) {
+    bench.counters["updates/s"] = benchmark::Counter(static_cast<double>(broker.received()),
+                                                     benchmark::Counter::kIsRate);
+    bench.counters["dropped"] = benchmark::Counter(static_cast<double>(dropped));
+    bench.counters["queue_p50_us"] = benchmark::Counter(broker.queue_latency().percentile_ns(50) / 1e3);
+    bench.counters["queue_p99_us"] = benchmark::Counter(broker.queue_latency().percentile_ns(99) / 1e3);
+}
+
+void BM_PublishInline(benchmark::State& bench) {
+    FakeBroker broker(std::chrono::milliseconds(bench.range(0)));
+    const auto batch = bench.range(1);
+    double value = 0.0;
+    for (auto _ : bench) {
+        const auto cycle_start = std::chrono::steady_clock::now();
+        for (int64_t i = 0; i < batch; ++i) {
+            auto request = make_request(value += 1.0, std::chrono::steady_clock::now());
+            benchmark::DoNotOptimize(broker.set(request, request.qualified_value));
+        }
+        wait_for_next_cycle(cycle_start);
+    }
+    broker.finish();
+    report(bench, broker, 0);
+}
+
+void BM_PublishLane(benchmark::State& bench) {
+    FakeBroker broker(std::chrono::milliseconds(bench.range(0)));
+    const auto batch = bench.range(1);
+    can2vss::Publisher lane("bench", &broker,
+                            {{can2vss::SignalPriority::NORMAL, 1, 4096, can2vss::QueueFullPolicy::DROP}});
+    lane.start();
+
+    double value = 0.0;
+    for (auto _ : bench) {
+        const auto cycle_start = std::chrono::steady_clock::now();
+        for (int64_t i = 0; i < batch; ++i) {
+            lane.enqueue(can2vss::SignalPriority::NORMAL, make_request(value += 1.0, cycle_start));
+        }
+        wait_for_next_cycle(cycle_start);
+    }
+    // Timing has stopped; drain what is still queued without the RTT
+    broker.finish();
+    lane.stop();
+    report(bench, broker, lane.dropped());
+}
+
+void BM_PublishChannels(benchmark::State& bench) {
+    const auto batch = bench.range(1);
+    const auto channels = static_cast<size_t>(bench.range(2));
+    std::vector<std::unique_ptr<FakeBroker>> brokers;
+    std::vector<can2vss::PublishBackend*> backends;
+    for (size_t i = 0; i < channels; ++i) {
+        brokers.push_back(std::make_unique<FakeBroker>(std::chrono::milliseconds(bench.range(0))));
+        backends.push_back(brokers.back().get());
+    }
+    auto lanes = can2vss::PublishLanes::create(backends, nullptr, 4096, can2vss::QueueFullPolicy::DROP);
+    lanes->start();
+
+    // Lanes are chosen per signal, so publish a realistic number of them
+    std::vector<std::string> paths;
+    for (int i = 0; i < 512; ++i) {
+        paths.push_back(kPath + std::to_string(i));
+    }
+
+    double value = 0.0;
+    size_t next_path = 0;
+    for (auto _ : bench) {
+        const auto cycle_start = std::chrono::steady_clock::now();
+        for (int64_t i = 0; i < batch; ++i) {
+            auto request = make_request(value += 1.0, cycle_start);
+            request.path = &paths[next_path++ % paths.size()];
+            lanes->enqueue(can2vss::SignalPriority::NORMAL, std::move(request));
+        }
+        wait_for_next_cycle(cycle_start);
+    }
+    for (auto& broker : brokers) {
+        broker->finish();
+    }
+    lanes->stop();
+
+    uint64_t received = 0;
+    can2vss::LatencyHistogram queue_latency("queue");
+    for (const auto& broker : brokers) {
+        received += broker->received();
+        queue_latency.merge(broker->queue_latency());
+    }
+    bench.counters["updates/s"] = benchmark::Counter(static_cast<double>(received), benchmark::Counter::kIsRate);
+    bench.counters["dropped"] = benchmark::Counter(static_cast<double>(lanes->dropped()));
+    bench.counters["queue_p50_us"] = benchmark::Counter(queue_latency.percentile_ns(50) / 1e3);
+    bench.counters["queue_p99_us"] = benchmark::Counter(queue_latency.percentile_ns(99) / 1e3);
+}
+
+// Second argument: 1 = broker offers a publish stream, 0 = unary fallback
+void BM_PublishStream(benchmark::State& bench) {
+    FakeStreamBroker broker(std::chrono::milliseconds(bench.range(0)), bench.range(2) != 0);
+    const auto batch = bench.range(1);
+    can2vss::Publisher lane("bench", &broker,
+                            {{can2vss::SignalPriority::NORMAL, 1, 4096, can2vss::QueueFullPolicy::DROP}});
+    lane.start();
+
+    double value = 0.0;
+    for (auto _ : bench) {
+        const auto cycle_start = std::chrono::steady_clock::now();
+        for (int64_t i = 0; i < batch; ++i) {
+            lane.enqueue(can2vss::SignalPriority::NORMAL, make_request(value += 1.0, cycle_start));
+        }
+        wait_for_next_cycle(cycle_start);
+    }
+    broker.finish();
+    lane.stop();
+    report(bench, broker, lane.dropped());
+    bench.counters["stream_writes"] = benchmark::Counter(static_cast<double>(broker.batches()));
+}
+
+// RTT in ms, updates per 10 ms cycle
+void throughput_args(benchmark::internal::Benchmark* b) {
+    for (int64_t rtt : {0, 1, 10}) {
+        for (int64_t batch : {16, 256}) {
+            b->Args({rtt, batch});
+        }
+    }
+    b->ArgNames({"rtt_ms", "batch"})->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_PublishInline)->Apply(throughput_args);
+BENCHMARK(BM_PublishLane)->Apply(throughput_args);
+
+// RTT in ms, updates per 10 ms cycle, stream offered
+BENCHMARK(BM_PublishStream)
+    ->ArgsProduct({{1, 10}, {16, 256}, {0, 1}})
+    ->ArgNames({"rtt_ms", "batch", "stream"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// RTT in ms, updates per 10 ms cycle, main lanes
+BENCHMARK(BM_PublishChannels)
+    ->ArgsProduct({{1, 10}, {256}, {1, 2, 4, 8}})
+    ->ArgNames({"rtt_ms", "batch", "channels"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,125 @@
+/**
+ * @file bench_signal_operators.cpp
+ * @brief Native operators: cost per input sample, by window size
+ *
+ * Samples arrive every millisecond, so a window of N ms holds N samples.
+ * The incremental aggregator should cost the same for every N; the baseline
+ * rescans the window on every sample, as a Lua transform keeping a history
+ * table does. The filters and the event detector are O(1) per sample, the median O(N) with a
+ * small constant.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "alloc_tracker.h"
+#include "signal_operators.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace {
+
+using can2vss::OperatorClock;
+using can2vss::WindowFunction;
+
+std::vector<double> speeds() {
+    std::mt19937 random(7);
+    std::normal_distribution<double> speed(80.0, 15.0);
+    std::vector<double> values(4096);
+    for (auto& value : values) {
+        value = speed(random);
+    }
+    return values;
+}
+
+void run_window(benchmark::State& bench, WindowFunction function) {
+    const int samples = static_cast<int>(bench.range(0));
+    can2vss::WindowAggregator window({function, samples, 0, static_cast<size_t>(samples) + 1});
+    const auto values = speeds();
+
+    auto time = OperatorClock::now();
+    size_t i = 0;
+    int64_t emitted = 0;
+    can2vss::OperatorSample out;
+    can2vss::AllocationGuard allocations;
+    for (auto _ : bench) {
+        time += std::chrono::milliseconds(1);
+        emitted += window.update(values[i++ % values.size()], time, &out);
+        benchmark::DoNotOptimize(out);
+    }
+    bench.SetItemsProcessed(bench.iterations());
+    bench.counters["emitted"] = benchmark::Counter(static_cast<double>(emitted));
+    bench.counters["allocs/sample"] =
+        benchmark::Counter(static_cast<double>(allocations.allocations()) / bench.iterations());
+}
+
+void BM_WindowMax(benchmark::State& bench) {
+    run_window(bench, WindowFunction::MAX);
+}
+BENCHMARK(BM_WindowMax)->RangeMultiplier(8)->Range(64, 32768);
+
+void BM_WindowStddev(benchmark::State& bench) {
+    run_window(bench, WindowFunction::STDDEV);
+}
+BENCHMARK(BM_WindowStddev)->RangeMultiplier(8)->Range(64, 32768);
+
+template <typename Operator, typename Spec>
+void run_filter(benchmark::State& bench, const Spec& spec) {
+    Operator filter(spec);
+    const auto values = speeds();
+
+    auto time = OperatorClock::now();
+    size_t i = 0;
+    can2vss::OperatorSample out;
+    can2vss::AllocationGuard allocations;
+    for (auto _ : bench) {
+        time += std::chrono::milliseconds(1);
+        benchmark::DoNotOptimize(filter.update(values[i++ % values.size()], time, &out));
+        benchmark::DoNotOptimize(out);
+    }
+    bench.SetItemsProcessed(bench.iterations());
+    bench.counters["allocs/sample"] =
+        benchmark::Counter(static_cast<double>(allocations.allocations()) / bench.iterations());
+}
+
+void BM_LowPass(benchmark::State& bench) {
+    run_filter<can2vss::LowPassFilter>(bench, can2vss::LowPassSpec{200});
+}
+BENCHMARK(BM_LowPass);
+
+void BM_Median(benchmark::State& bench) {
+    run_filter<can2vss::MovingMedian>(bench, can2vss::MedianSpec{static_cast<size_t>(bench.range(0))});
+}
+BENCHMARK(BM_Median)->Arg(5)->Arg(31)->Arg(255);
+
+void BM_Event(benchmark::State& bench) {
+    can2vss::EventSpec spec;
+    spec.threshold = 95.0;
+    spec.hysteresis = 5.0;
+    spec.min_duration_ms = 20;
+    run_filter<can2vss::EventDetector>(bench, spec);
+}
+BENCHMARK(BM_Event);
+
+// Baseline: keep a history and rescan it for the maximum on every sample
+void BM_WindowMaxRescan(benchmark::State& bench) {
+    const auto samples = static_cast<size_t>(bench.range(0));
+    std::deque<double> history;
+    const auto values = speeds();
+
+    size_t i = 0;
+    for (auto _ : bench) {
+        history.push_back(values[i++ % values.size()]);
+        if (history.size() > samples) {
+            history.pop_front();
+        }
+        benchmark::DoNotOptimize(*std::max_element(history.begin(), history.end()));
+    }
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_WindowMaxRescan)->RangeMultiplier(8)->Range(64, 32768);
+
+}  // namespace
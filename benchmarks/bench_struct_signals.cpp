@@ -0,0 +1,164 @@
+/**
+ * @file bench_struct_signals.cpp
+ * @brief Struct signal assembly: preallocated seqlock buffers vs. a map per update
+ *
+ * Both benchmarks decode the same Model 3 frames with the decoders and DAG
+ * generated from benchmarks/data/struct_mappings.yaml. They differ only in
+ * what happens when a struct node changes: the feeder's path gathers the
+ * field slots into a StructBuffer and loads them back as a publish lane
+ * would; the baseline rebuilds a name-keyed map per update, as a dynamic
+ * struct value does.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "alloc_tracker.h"
+#include "can2vss_generated_dag.h"
+#include "can2vss_generated_decoders.h"
+#include "struct_buffer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace dag = can2vss::generated_dag;
+namespace decoders = can2vss::generated;
+
+namespace {
+
+struct Frame {
+    uint32_t can_id;
+    uint8_t data[8];
+};
+
+// One frame per struct source plus the scalars they depend on
+constexpr std::array<Frame, 4> kFrames = {{
+    {0x257, {0x00, 0x80, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00}},  // DI_vehicleSpeed
+    {0x108, {0x00, 0x00, 0x00, 0x20, 0x03, 0x10, 0x27, 0x00}},  // DIR_torqueActual, DIR_axleSpeed
+    {0x132, {0x10, 0x9C, 0x00, 0x00, 0x40, 0x40, 0x00, 0x00}},  // BattVoltage132, RawBattCurrent132
+    {0x118, {0x00, 0x00, 0x08, 0x00, 0x64, 0x00, 0x00, 0x00}},  // DI_accelPedalPos, DI_brakePedalState
+}};
+
+using DynamicField = std::variant<bool, int64_t, uint64_t, float, double>;
+using DynamicStruct = std::map<std::string, DynamicField>;
+
+/// Feeds decoded signals into the DAG by input slot, like GeneratedDagProcessor
+class Pipeline {
+public:
+    Pipeline() {
+        for (size_t signal = 0; signal < decoders::kSignalCount; ++signal) {
+            inputs_[signal] = -1;
+            for (size_t i = 0; i < dag::kInputNames.size(); ++i) {
+                if (dag::kInputNames[i] == decoders::kSignalNames[signal]) {
+                    inputs_[signal] = static_cast<int>(i);
+                }
+            }
+        }
+    }
+
+    template <typename Sink>
+    void process(const Frame& frame, Sink&& sink) {
+        decoders::decode_frame(frame.can_id, frame.data, 8, [&](size_t signal, double value) {
+            if (inputs_[signal] >= 0) {
+                dag::set_input(state_, static_cast<size_t>(inputs_[signal]), value);
+            }
+        });
+        dag::evaluate(state_, std::chrono::steady_clock::now(), sink);
+    }
+
+    const dag::State& state() const { return state_; }
+
+private:
+    dag::State state_;
+    std::array<int, decoders::kSignalCount> inputs_{};
+};
+
+void BM_StructSignals_Preallocated(benchmark::State& bench) {
+    Pipeline pipeline;
+    std::vector<std::unique_ptr<can2vss::StructBuffer>> buffers;
+    size_t widest = 0;
+    for (const auto& info : dag::kStructs) {
+        std::vector<can2vss::StructBuffer::Field> fields;
+        for (size_t f = info.first_field; f < info.first_field + info.field_count; ++f) {
+            fields.push_back({std::string(dag::kStructFields[f].name), dag::kStructFields[f].slot.type});
+        }
+        buffers.push_back(std::make_unique<can2vss::StructBuffer>(std::string(info.type), std::move(fields)));
+        widest = std::max<size_t>(widest, info.field_count);
+    }
+    std::vector<can2vss::TypedValue> scratch(widest);
+    std::vector<can2vss::TypedValue> published(widest);
+
+    size_t frame = 0;
+    int64_t structs = 0;
+    can2vss::AllocationGuard allocations;
+    for (auto _ : bench) {
+        pipeline.process(kFrames[frame++ % kFrames.size()], [&](size_t, auto value) {
+            if constexpr (std::is_same_v<decltype(value), can2vss::StructRef>) {
+                const auto& info = dag::kStructs[value.index];
+                for (size_t f = 0; f < info.field_count; ++f) {
+                    scratch[f] = dag::read_slot(pipeline.state(), dag::kStructFields[info.first_field + f].slot);
+                }
+                buffers[value.index]->store(scratch.data());
+                buffers[value.index]->load(published.data());
+                benchmark::DoNotOptimize(published.data());
+                ++structs;
+            }
+        });
+    }
+    bench.counters["structs/frame"] = benchmark::Counter(static_cast<double>(structs) / bench.iterations());
+    bench.counters["allocs/frame"] =
+        benchmark::Counter(static_cast<double>(allocations.allocations()) / bench.iterations());
+}
+BENCHMARK(BM_StructSignals_Preallocated);
+
+void BM_StructSignals_MapPerUpdate(benchmark::State& bench) {
+    Pipeline pipeline;
+    std::vector<std::shared_ptr<const DynamicStruct>> latest(dag::kStructCount);
+
+    size_t frame = 0;
+    int64_t structs = 0;
+    can2vss::AllocationGuard allocations;
+    for (auto _ : bench) {
+        pipeline.process(kFrames[frame++ % kFrames.size()], [&](size_t, auto value) {
+            if constexpr (std::is_same_v<decltype(value), can2vss::StructRef>) {
+                const auto& info = dag::kStructs[value.index];
+                auto fields = std::make_shared<DynamicStruct>();
+                for (size_t f = info.first_field; f < info.first_field + info.field_count; ++f) {
+                    const auto typed = dag::read_slot(pipeline.state(), dag::kStructFields[f].slot);
+                    DynamicField field;
+                    switch (typed.type) {
+                        case can2vss::SlotType::BOOL:
+                            field = typed.b;
+                            break;
+                        case can2vss::SlotType::FLOAT:
+                            field = typed.f;
+                            break;
+                        case can2vss::SlotType::DOUBLE:
+                            field = typed.d;
+                            break;
+                        default:
+                            field = typed.u;
+                            break;
+                    }
+                    (*fields)[std::string(dag::kStructFields[f].name)] = field;
+                }
+                latest[value.index] = std::move(fields);
+                auto published = latest[value.index];
+                benchmark::DoNotOptimize(published.get());
+                ++structs;
+            }
+        });
+    }
+    bench.counters["structs/frame"] = benchmark::Counter(static_cast<double>(structs) / bench.iterations());
+    bench.counters["allocs/frame"] =
+        benchmark::Counter(static_cast<double>(allocations.allocations()) / bench.iterations());
+}
+BENCHMARK(BM_StructSignals_MapPerUpdate);
+
+}  // namespace
@@ -0,0 +1,133 @@
+/**
+ * @file fake_broker.h
+ * @brief In-process stand-in for the KUKSA databroker with injected round-trip time
+ */
+
+#pragma once
+
+#include "latency_histogram.h"
+#include "publisher.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <vector>
+
+namespace can2vss::bench {
+
+/**
+ * @brief Accepts every set() after one round-trip time, like a unary RPC
+ *
+ * Records how long each request waited between being queued and its set()
+ * call starting (queueing latency). Recording is single-threaded: read the
+ * histogram only after the publishing thread has stopped.
+ */
+class FakeBroker : public PublishBackend {
+public:
+    explicit FakeBroker(std::chrono::microseconds rtt) : rtt_us_(rtt.count()) {}
+
+    absl::Status set(const PublishRequest& request,
+                     const vss::types::QualifiedValue<vss::types::Value>&) override {
+        if (recording()) {
+            record(std::chrono::steady_clock::now() - request.enqueued_at);
+        }
+        if (auto rtt = rtt_us_.load(std::memory_order_relaxed); rtt > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(rtt));
+        }
+        return absl::OkStatus();
+    }
+
+    /// Stops recording and answers immediately, to drain queues quickly
+    void finish() {
+        recording_.store(false, std::memory_order_relaxed);
+        rtt_us_.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t received() const { return received_.load(std::memory_order_relaxed); }
+    const LatencyHistogram& queue_latency() const { return queue_latency_; }
+
+protected:
+    std::chrono::microseconds rtt() const {
+        return std::chrono::microseconds(rtt_us_.load(std::memory_order_relaxed));
+    }
+
+    bool recording() const { return recording_.load(std::memory_order_relaxed); }
+
+    void record(std::chrono::steady_clock::duration queue_latency) {
+        queue_latency_.record(queue_latency);
+        received_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int64_t> rtt_us_;
+    std::atomic<bool> recording_{true};
+    std::atomic<uint64_t> received_{0};
+    LatencyHistogram queue_latency_{"queue"};
+};
+
+/**
+ * @brief FakeBroker that also accepts batches on a publish stream
+ *
+ * A stream write costs `write_cost` on the lane thread (serialization and
+ * handing the message to the transport); the broker acknowledges each batch
+ * one RTT after it was written. With `stream` false the broker refuses to
+ * open a stream, so the lane falls back to set().
+ */
+class FakeStreamBroker : public FakeBroker {
+public:
+    FakeStreamBroker(std::chrono::microseconds rtt, bool stream = true,
+                     std::chrono::microseconds write_cost = std::chrono::microseconds(20))
+        : FakeBroker(rtt), stream_(stream), write_cost_(write_cost) {}
+
+    absl::Status open_stream() override {
+        if (!stream_) {
+            return absl::UnimplementedError("fake broker without publish stream");
+        }
+        acks_due_.clear();
+        acknowledged_ = 0;
+        return absl::OkStatus();
+    }
+
+    absl::Status write_batch(const std::vector<PublishEntry>& batch) override {
+        const auto now = std::chrono::steady_clock::now();
+        if (recording()) {
+            for (const auto& entry : batch) {
+                record(now - entry.enqueued_at);
+            }
+        }
+        if (write_cost_.count() > 0) {
+            std::this_thread::sleep_for(write_cost_);
+        }
+        acks_due_.push_back(std::chrono::steady_clock::now() + rtt());
+        ++batches_;
+        return absl::OkStatus();
+    }
+
+    bool wait_acknowledged(uint64_t batches, std::chrono::milliseconds timeout) override {
+        while (acknowledged_ < batches) {
+            if (acks_due_.empty()) {
+                return false;
+            }
+            const auto due = acks_due_.front();
+            if (due > std::chrono::steady_clock::now() + timeout) {
+                return false;
+            }
+            std::this_thread::sleep_until(due);
+            acks_due_.pop_front();
+            ++acknowledged_;
+        }
+        return true;
+    }
+
+    uint64_t batches() const { return batches_; }
+
+private:
+    bool stream_;
+    std::chrono::microseconds write_cost_;
+    std::deque<std::chrono::steady_clock::time_point> acks_due_;
+    uint64_t acknowledged_ = 0;
+    uint64_t batches_ = 0;
+};
+
+}  // namespace can2vss::bench
@@ -0,0 +1,55 @@
+/**
+ * @file synthetic_mappings.h
+ * @brief Mapping YAML of a given size for parameterized benchmarks
+ */
+
+#pragma once
+
+#include <string>
+
+namespace can2vss::bench {
+
+enum class MappingKind { DIRECT, CODE, VALUE_MAP, MIXED };
+
+/// VSS path of the i-th synthetic mapping
+inline std::string synthetic_path(size_t i) {
+    return "Vehicle.Bench.Signal" + std::to_string(i);
+}
+
+/// CAN signal feeding the i-th synthetic mapping
+inline std::string synthetic_source(size_t i) {
+    return "BENCH_signal" + std::to_string(i);
+}
+
+/**
+ * @brief Mapping YAML with `count` source-driven mappings of one transform kind
+ *
+ * Direct and code mappings are doubles (`x * 0.5 + 1` for code); value
+ * mappings turn 0/1 into "OFF"/"ON". MIXED cycles through the three kinds.
+ */
+inline std::string synthetic_mapping_yaml(size_t count, MappingKind kind) {
+    std::string yaml = "mappings:\n";
+    for (size_t i = 0; i < count; ++i) {
+        MappingKind entry = kind == MappingKind::MIXED ? static_cast<MappingKind>(i % 3) : kind;
+        yaml += "  - signal: " + synthetic_path(i) + "\n";
+        yaml += "    source:\n      type: dbc\n      name: " + synthetic_source(i) + "\n";
+        switch (entry) {
+            case MappingKind::VALUE_MAP:
+                yaml += "    datatype: string\n";
+                yaml += "    transform:\n      mapping:\n";
+                yaml += "        - from: 0\n          to: \"OFF\"\n";
+                yaml += "        - from: 1\n          to: \"ON\"\n";
+                break;
+            case MappingKind::CODE:
+                yaml += "    datatype: double\n";
+                yaml += "    transform:\n      code: \"x * 0.5 + 1\"\n";
+                break;
+            default:
+                yaml += "    datatype: double\n";
+                break;
+        }
+    }
+    return yaml;
+}
+
+}  // namespace can2vss::bench
@@ -0,0 +1,39 @@
+/**
+ * @file adaptive_poll.cpp
+ * @brief Adapts the main loop's wait time to frame arrival rate and publish latency
+ */
+
+#include "adaptive_poll.h"
+
+#include <algorithm>
+
+namespace can2vss {
+
+std::chrono::microseconds AdaptivePollController::update(size_t updates,
+                                                         std::chrono::nanoseconds since_last_poll,
+                                                         std::chrono::nanoseconds publish_latency) {
+    using std::chrono::duration;
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    double elapsed_s = duration<double>(since_last_poll).count();
+    if (elapsed_s > 0.0) {
+        double sample = updates / elapsed_s;
+        rate_ = sample >= rate_ ? sample : rate_ + config_.decay * (sample - rate_);
+    }
+
+    // Below one update per max_wait there is nothing worth waking up for
+    double idle_rate = 1.0 / duration<double>(config_.max_wait).count();
+    if (rate_ < idle_rate) {
+        wait_ = config_.max_wait;
+        return wait_;
+    }
+
+    auto batch_wait = duration<double>(config_.target_batch / rate_);
+    auto headroom = duration<double>(config_.latency_budget - duration_cast<microseconds>(publish_latency));
+    auto wait = duration_cast<microseconds>(std::min(batch_wait, headroom));
+    wait_ = std::clamp(wait, config_.min_wait, config_.max_wait);
+    return wait_;
+}
+
+}  // namespace can2vss
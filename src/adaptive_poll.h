@@ -0,0 +1,65 @@
+/**
+ * @file adaptive_poll.h
+ * @brief Adapts the main loop's wait time to frame arrival rate and publish latency
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace can2vss {
+
+struct AdaptivePollConfig {
+    std::chrono::microseconds min_wait{500};
+    std::chrono::microseconds max_wait{50000};
+
+    // Updates per DAG pass the controller aims for under load
+    size_t target_batch = 32;
+
+    // Upper bound for loop wait plus publish latency while traffic is flowing
+    std::chrono::microseconds latency_budget{10000};
+
+    // EWMA weight for a falling arrival rate; a rising rate is taken at once
+    double decay = 0.1;
+};
+
+/**
+ * @brief Chooses how long the main loop waits before polling again
+ *
+ * The wait is sized so that one poll collects about `target_batch` updates at
+ * the observed arrival rate, but never so long that wait plus the lanes'
+ * publish latency exceeds `latency_budget`. With no traffic the wait grows
+ * to `max_wait`. The arrival rate estimate rises immediately and decays
+ * slowly, so a burst after an idle period shortens the wait on the next poll.
+ */
+class AdaptivePollController {
+public:
+    explicit AdaptivePollController(AdaptivePollConfig config = {}) : config_(config) {}
+
+    /**
+     * @brief Feeds one poll result and returns the wait before the next poll
+     *
+     * @param updates Number of signal updates returned by this poll
+     * @param since_last_poll Time since the previous poll
+     * @param publish_latency Current enqueue-to-published latency of the lanes
+     */
+    std::chrono::microseconds update(size_t updates,
+                                     std::chrono::nanoseconds since_last_poll,
+                                     std::chrono::nanoseconds publish_latency);
+
+    /// Smoothed arrival rate in updates per second
+    double arrival_rate() const { return rate_; }
+
+    /// Updates expected per poll at the current wait
+    double expected_batch() const { return rate_ * std::chrono::duration<double>(wait_).count(); }
+
+    std::chrono::microseconds wait() const { return wait_; }
+
+private:
+    AdaptivePollConfig config_;
+    double rate_ = 0.0;
+    std::chrono::microseconds wait_{config_.max_wait};
+};
+
+}  // namespace can2vss
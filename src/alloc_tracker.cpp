@@ -0,0 +1,126 @@
+/**
+ * @file alloc_tracker.cpp
+ * @brief Global operator new/delete replacement backing AllocationGuard
+ */
+
+#include "alloc_tracker.h"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace can2vss {
+
+namespace {
+
+thread_local int t_guard_depth = 0;
+thread_local int t_heap_depth = 0;
+thread_local uint64_t t_allocations = 0;
+thread_local uint64_t t_deallocations = 0;
+thread_local int64_t t_heap_bytes = 0;
+thread_local int64_t t_heap_peak = 0;
+
+inline void* note_allocation(void* ptr) {
+    if (t_guard_depth > 0) {
+        ++t_allocations;
+    }
+    if (t_heap_depth > 0) {
+        t_heap_bytes += static_cast<int64_t>(malloc_usable_size(ptr));
+        t_heap_peak = std::max(t_heap_peak, t_heap_bytes);
+    }
+    return ptr;
+}
+
+inline void note_deallocation(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (t_guard_depth > 0) {
+        ++t_deallocations;
+    }
+    if (t_heap_depth > 0) {
+        t_heap_bytes -= static_cast<int64_t>(malloc_usable_size(ptr));
+    }
+}
+
+}  // namespace
+
+AllocationGuard::AllocationGuard()
+    : start_allocations_(t_allocations), start_deallocations_(t_deallocations) {
+    ++t_guard_depth;
+}
+
+AllocationGuard::~AllocationGuard() {
+    --t_guard_depth;
+}
+
+uint64_t AllocationGuard::allocations() const {
+    return t_allocations - start_allocations_;
+}
+
+uint64_t AllocationGuard::deallocations() const {
+    return t_deallocations - start_deallocations_;
+}
+
+HeapAccountingScope::HeapAccountingScope() {
+    ++t_heap_depth;
+}
+
+HeapAccountingScope::~HeapAccountingScope() {
+    --t_heap_depth;
+}
+
+int64_t thread_heap_bytes() {
+    return t_heap_bytes;
+}
+
+int64_t thread_heap_peak_bytes() {
+    return t_heap_peak;
+}
+
+void reset_thread_heap_peak() {
+    t_heap_peak = t_heap_bytes;
+}
+
+}  // namespace can2vss
+
+// The array and nothrow forms of operator new/delete forward to these in
+// libstdc++, so replacing the scalar and aligned forms covers all of them.
+
+void* operator new(std::size_t size) {
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return can2vss::note_allocation(ptr);
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    auto align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (size + align - 1) / align * align;
+    if (void* ptr = std::aligned_alloc(align, rounded ? rounded : align)) {
+        return can2vss::note_allocation(ptr);
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    can2vss::note_deallocation(ptr);
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    can2vss::note_deallocation(ptr);
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    can2vss::note_deallocation(ptr);
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    can2vss::note_deallocation(ptr);
+    std::free(ptr);
+}
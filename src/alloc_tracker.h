@@ -0,0 +1,76 @@
+/**
+ * @file alloc_tracker.h
+ * @brief Detects heap allocations on real-time code paths
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace can2vss {
+
+/**
+ * @brief Counts heap allocations and frees made by the current thread while alive
+ *
+ * The feeder replaces the global operator new/delete with thin wrappers that
+ * bump a thread-local counter whenever a guard is active on the calling
+ * thread. Guards nest. Outside a guard and a HeapAccountingScope the only
+ * overhead is two thread-local loads per allocation.
+ *
+ * Only C++ allocations are observed; direct malloc() calls from C libraries
+ * are not.
+ */
+class AllocationGuard {
+public:
+    AllocationGuard();
+    ~AllocationGuard();
+
+    AllocationGuard(const AllocationGuard&) = delete;
+    AllocationGuard& operator=(const AllocationGuard&) = delete;
+
+    /// Allocations made on this thread since the guard was created
+    uint64_t allocations() const;
+
+    /// Frees made on this thread since the guard was created
+    uint64_t deallocations() const;
+
+    bool clean() const { return allocations() == 0 && deallocations() == 0; }
+
+private:
+    uint64_t start_allocations_;
+    uint64_t start_deallocations_;
+};
+
+/**
+ * @brief Counts the calling thread's live C++ heap bytes while alive
+ *
+ * Each allocation and free inside a scope costs a malloc_usable_size() call,
+ * so accounting is off outside one; MemoryLedger keeps a scope open for the
+ * startup phases it measures. Scopes nest.
+ */
+class HeapAccountingScope {
+public:
+    HeapAccountingScope();
+    ~HeapAccountingScope();
+
+    HeapAccountingScope(const HeapAccountingScope&) = delete;
+    HeapAccountingScope& operator=(const HeapAccountingScope&) = delete;
+};
+
+/**
+ * @brief Live C++ heap bytes allocated minus freed by the calling thread
+ *
+ * Only allocations and frees inside a HeapAccountingScope are counted, from
+ * the allocator's usable size. Memory freed on another thread than it was
+ * allocated on, or freed inside a scope but allocated outside, lowers the
+ * count, so use differences taken on one thread within one scope, e.g.
+ * around startup phases.
+ */
+int64_t thread_heap_bytes();
+
+/// Highest thread_heap_bytes() since the last reset_thread_heap_peak()
+int64_t thread_heap_peak_bytes();
+
+void reset_thread_heap_peak();
+
+}  // namespace can2vss
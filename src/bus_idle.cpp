@@ -0,0 +1,170 @@
+/**
+ * @file bus_idle.cpp
+ * @brief Bus-silence detection and blocking wait for CAN traffic
+ */
+
+#include "bus_idle.h"
+
+#include <glog/logging.h>
+
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+namespace can2vss {
+
+namespace {
+
+constexpr auto kSampleInterval = std::chrono::seconds(1);
+
+}  // namespace
+
+BusIdleDetector::BusIdleDetector(std::string interface, std::chrono::milliseconds idle_after)
+    : BusIdleDetector(interface, idle_after, "/sys/class/net/" + interface + "/statistics/rx_packets") {}
+
+BusIdleDetector::BusIdleDetector(std::string interface, std::chrono::milliseconds idle_after,
+                                 std::string rx_packets_path)
+    : interface_(std::move(interface)),
+      idle_after_(idle_after),
+      rx_packets_path_(std::move(rx_packets_path)),
+      last_activity_(std::chrono::steady_clock::now()),
+      last_sample_(last_activity_) {}
+
+BusIdleDetector::~BusIdleDetector() {
+    if (can_fd_ >= 0) {
+        close(can_fd_);
+    }
+    if (event_fd_ >= 0) {
+        close(event_fd_);
+    }
+}
+
+bool BusIdleDetector::initialize() {
+    if (!read_rx_packets(last_rx_packets_)) {
+        LOG(ERROR) << "Cannot read RX counter " << rx_packets_path_;
+        return false;
+    }
+
+    event_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (event_fd_ < 0) {
+        LOG(ERROR) << "eventfd failed: " << std::strerror(errno);
+        return false;
+    }
+
+    can_fd_ = socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, CAN_RAW);
+    if (can_fd_ < 0) {
+        LOG(ERROR) << "Failed to open wake socket: " << std::strerror(errno);
+        return false;
+    }
+
+    // Reject everything until we actually wait
+    if (!set_accept_all(false)) {
+        return false;
+    }
+
+    sockaddr_can addr{};
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = static_cast<int>(if_nametoindex(interface_.c_str()));
+    if (addr.can_ifindex == 0) {
+        LOG(ERROR) << "Unknown CAN interface " << interface_;
+        return false;
+    }
+    if (bind(can_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        LOG(ERROR) << "Failed to bind wake socket to " << interface_ << ": " << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool BusIdleDetector::read_rx_packets(uint64_t& value) const {
+    std::ifstream in(rx_packets_path_);
+    return static_cast<bool>(in >> value);
+}
+
+bool BusIdleDetector::set_accept_all(bool accept_all) {
+    can_filter all{};  // id 0, mask 0 matches every frame
+    int rc = accept_all
+        ? setsockopt(can_fd_, SOL_CAN_RAW, CAN_RAW_FILTER, &all, sizeof(all))
+        : setsockopt(can_fd_, SOL_CAN_RAW, CAN_RAW_FILTER, nullptr, 0);
+    if (rc != 0) {
+        LOG(ERROR) << "Failed to set wake socket filter: " << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool BusIdleDetector::bus_silent(std::chrono::steady_clock::time_point now) {
+    if (now - last_sample_ >= kSampleInterval) {
+        last_sample_ = now;
+        uint64_t rx_packets = 0;
+        if (read_rx_packets(rx_packets) && rx_packets != last_rx_packets_) {
+            last_rx_packets_ = rx_packets;
+            last_activity_ = now;
+        }
+    }
+    return now - last_activity_ >= idle_after_;
+}
+
+bool BusIdleDetector::wait_for_traffic() {
+    if (!set_accept_all(true)) {
+        return false;
+    }
+
+    // A frame may have arrived between the last counter sample and enabling
+    // the filter; it would not be queued on the socket, so check again.
+    uint64_t rx_packets = 0;
+    bool resumed = read_rx_packets(rx_packets) && rx_packets != last_rx_packets_;
+
+    pollfd fds[2] = {
+        {can_fd_, POLLIN, 0},
+        {event_fd_, POLLIN, 0},
+    };
+    while (!resumed) {
+        int rc = ::poll(fds, 2, -1);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(ERROR) << "poll on wake socket failed: " << std::strerror(errno);
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            resumed = true;
+        }
+    }
+
+    set_accept_all(false);
+
+    // Drain frames queued while waiting and any pending wake
+    can_frame frame;
+    while (read(can_fd_, &frame, sizeof(frame)) > 0) {
+    }
+    uint64_t counter;
+    while (read(event_fd_, &counter, sizeof(counter)) > 0) {
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    last_activity_ = now;
+    last_sample_ = now;
+    read_rx_packets(last_rx_packets_);
+    return resumed;
+}
+
+void BusIdleDetector::wake() {
+    uint64_t one = 1;
+    // Only async-signal-safe calls here
+    [[maybe_unused]] auto n = ::write(event_fd_, &one, sizeof(one));
+}
+
+}  // namespace can2vss
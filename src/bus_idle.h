@@ -0,0 +1,76 @@
+/**
+ * @file bus_idle.h
+ * @brief Bus-silence detection and blocking wait for CAN traffic
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace can2vss {
+
+/**
+ * @brief Detects a silent CAN bus and sleeps until traffic resumes
+ *
+ * Silence is detected from the interface's kernel RX packet counter
+ * (/sys/class/net/<if>/statistics/rx_packets), sampled at most once per
+ * second, so detection costs nothing on the CAN path.
+ *
+ * To wait, the detector uses its own CAN_RAW socket on the interface. The
+ * socket's filter rejects every frame while the feeder is active, so the
+ * kernel does not duplicate traffic into it; it accepts all frames only while
+ * waiting. The wait has no timeout; wake() ends it early (e.g. on SIGTERM)
+ * and is async-signal-safe.
+ */
+class BusIdleDetector {
+public:
+    BusIdleDetector(std::string interface, std::chrono::milliseconds idle_after);
+    /// Reads the RX packet counter from `rx_packets_path` instead of sysfs (tests)
+    BusIdleDetector(std::string interface, std::chrono::milliseconds idle_after, std::string rx_packets_path);
+    ~BusIdleDetector();
+
+    BusIdleDetector(const BusIdleDetector&) = delete;
+    BusIdleDetector& operator=(const BusIdleDetector&) = delete;
+
+    /// Opens the wake socket and eventfd; @return false if either fails
+    bool initialize();
+
+    /// Marks the bus as active (e.g. when the source produced updates)
+    void note_activity(std::chrono::steady_clock::time_point now) { last_activity_ = now; }
+
+    /// @return true once no frame was received for `idle_after`
+    bool bus_silent(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Blocks until a frame arrives on the interface or wake() is called
+     * @return true if traffic resumed, false if woken or on error
+     */
+    bool wait_for_traffic();
+
+    /// Ends a pending wait_for_traffic(); safe to call from a signal handler
+    void wake();
+
+    /// File descriptor written by wake(), for use from a signal handler
+    int wake_fd() const { return event_fd_; }
+
+    std::chrono::milliseconds idle_after() const { return idle_after_; }
+
+private:
+    bool read_rx_packets(uint64_t& value) const;
+    bool set_accept_all(bool accept_all);
+
+    std::string interface_;
+    std::chrono::milliseconds idle_after_;
+    std::string rx_packets_path_;
+
+    int can_fd_ = -1;
+    int event_fd_ = -1;
+
+    uint64_t last_rx_packets_ = 0;
+    std::chrono::steady_clock::time_point last_activity_;
+    std::chrono::steady_clock::time_point last_sample_;
+};
+
+}  // namespace can2vss
@@ -0,0 +1,82 @@
+/**
+ * @file can_bits.h
+ * @brief Bit extraction for DBC signals in classic (8 byte) CAN frames
+ *
+ * The templated forms take the signal layout as compile-time constants and
+ * reduce to one 64-bit load, a shift and a mask; they are what generated
+ * decoders call. The runtime forms serve the DBC parser's reference decode.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace can2vss::can_bits {
+
+constexpr uint64_t load_le64(const uint8_t* data) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) {
+        v = (v << 8) | data[i];
+    }
+    return v;
+}
+
+constexpr uint64_t load_be64(const uint8_t* data) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) {
+        v = (v << 8) | data[i];
+    }
+    return v;
+}
+
+constexpr uint64_t mask(unsigned length) {
+    return length >= 64 ? ~uint64_t{0} : (uint64_t{1} << length) - 1;
+}
+
+/// Bit offset of a Motorola signal's MSB within the big-endian 64-bit word
+constexpr unsigned motorola_msb_offset(unsigned start_bit) {
+    return (start_bit / 8) * 8 + (7 - start_bit % 8);
+}
+
+/// Intel (little-endian, @1) signal: start_bit is the LSB
+template <unsigned StartBit, unsigned Length>
+constexpr uint64_t extract_intel(const uint8_t* data) {
+    static_assert(Length >= 1 && StartBit + Length <= 64, "signal exceeds 8 byte frame");
+    return (load_le64(data) >> StartBit) & mask(Length);
+}
+
+/// Motorola (big-endian, @0) signal: start_bit is the MSB in DBC numbering
+template <unsigned StartBit, unsigned Length>
+constexpr uint64_t extract_motorola(const uint8_t* data) {
+    constexpr unsigned msb = motorola_msb_offset(StartBit);
+    static_assert(Length >= 1 && msb + Length <= 64, "signal exceeds 8 byte frame");
+    return (load_be64(data) << msb) >> (64 - Length);
+}
+
+template <unsigned Length>
+constexpr int64_t sign_extend(uint64_t raw) {
+    static_assert(Length >= 1 && Length <= 64);
+    if constexpr (Length == 64) {
+        return static_cast<int64_t>(raw);
+    } else {
+        constexpr uint64_t sign_bit = uint64_t{1} << (Length - 1);
+        return static_cast<int64_t>((raw ^ sign_bit) - sign_bit);
+    }
+}
+
+inline uint64_t extract(const uint8_t* data, unsigned start_bit, unsigned length, bool little_endian) {
+    if (little_endian) {
+        return (load_le64(data) >> start_bit) & mask(length);
+    }
+    return (load_be64(data) << motorola_msb_offset(start_bit)) >> (64 - length);
+}
+
+inline int64_t sign_extend(uint64_t raw, unsigned length) {
+    if (length >= 64) {
+        return static_cast<int64_t>(raw);
+    }
+    uint64_t sign_bit = uint64_t{1} << (length - 1);
+    return static_cast<int64_t>((raw ^ sign_bit) - sign_bit);
+}
+
+}  // namespace can2vss::can_bits
@@ -0,0 +1,1103 @@
+/**
+ * @file dag_codegen.cpp
+ * @brief Generates typed C++ evaluation code for the mapping DAG
+ */
+
+#include "dag_codegen.h"
+
+#include "signal_operators.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+
+namespace can2vss {
+
+namespace {
+
+// Shortest representation that round-trips, always with a decimal point or
+// exponent so the literal is a double
+std::string double_literal(double value) {
+    char buf[64];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    std::string text(buf, end);
+    if (text.find_first_of(".en") == std::string::npos) {
+        text += ".0";
+    }
+    return text;
+}
+
+std::optional<double> parse_double(std::string_view text) {
+    double value = 0.0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/// C++ type for a mapping datatype, or empty if it cannot be compiled in
+std::string cpp_type(const std::string& datatype) {
+    static const std::map<std::string, std::string> kTypes = {
+        {"bool", "bool"},         {"boolean", "bool"},      {"int8", "int8_t"},
+        {"int16", "int16_t"},     {"int32", "int32_t"},     {"int64", "int64_t"},
+        {"uint8", "uint8_t"},     {"uint16", "uint16_t"},   {"uint32", "uint32_t"},
+        {"uint64", "uint64_t"},   {"float", "float"},       {"double", "double"},
+    };
+    auto it = kTypes.find(datatype);
+    return it == kTypes.end() ? std::string() : it->second;
+}
+
+/// Values [min, max + 1) an integer C++ type holds, or nullopt for other types
+std::optional<std::pair<double, double>> integer_range(const std::string& type) {
+    static const std::map<std::string, std::pair<double, double>> kRanges = {
+        {"int8_t", {-0x1p7, 0x1p7}},   {"int16_t", {-0x1p15, 0x1p15}}, {"int32_t", {-0x1p31, 0x1p31}},
+        {"int64_t", {-0x1p63, 0x1p63}}, {"uint8_t", {0.0, 0x1p8}},      {"uint16_t", {0.0, 0x1p16}},
+        {"uint32_t", {0.0, 0x1p32}},    {"uint64_t", {0.0, 0x1p64}},
+    };
+    auto it = kRanges.find(type);
+    return it == kRanges.end() ? std::nullopt : std::optional(it->second);
+}
+
+/// Typed slot array holding values of a C++ type, and its SlotType tag
+struct Storage {
+    const char* array;
+    const char* tag;
+};
+
+Storage storage_for(const std::string& type) {
+    static const std::map<std::string, Storage> kStorage = {
+        {"bool", {"bools", "BOOL"}},       {"int8_t", {"ints", "INT8"}},
+        {"int16_t", {"ints", "INT16"}},    {"int32_t", {"ints", "INT32"}},
+        {"int64_t", {"ints", "INT64"}},    {"uint8_t", {"uints", "UINT8"}},
+        {"uint16_t", {"uints", "UINT16"}}, {"uint32_t", {"uints", "UINT32"}},
+        {"uint64_t", {"uints", "UINT64"}}, {"float", {"floats", "FLOAT"}},
+        {"double", {"doubles", "DOUBLE"}},
+    };
+    return kStorage.at(type);
+}
+
+/**
+ * @brief Recursive-descent translator for the Lua expression subset
+ *
+ * Grammar, loosest binding first (Lua precedence):
+ *   comparison := additive [cmp additive]
+ *   additive   := term {(+|-) term}
+ *   term       := unary {(*|/|//|%) unary}
+ *   unary      := - unary | power
+ *   power      := primary [^ unary]
+ */
+class ExpressionTranslator {
+public:
+    ExpressionTranslator(std::string_view code, const std::vector<std::string>& depends_on, bool has_source)
+        : code_(code), depends_on_(depends_on), has_source_(has_source) {}
+
+    absl::StatusOr<std::string> translate(bool* is_boolean) {
+        skip_space();
+        if (consume_word("return")) {
+            skip_space();
+        }
+        auto result = comparison(is_boolean);
+        skip_space();
+        consume(";");
+        skip_space();
+        if (error_.empty() && pos_ != code_.size()) {
+            fail(absl::StrCat("unexpected '", std::string(code_.substr(pos_)), "'"));
+        }
+        if (!error_.empty()) {
+            return absl::InvalidArgumentError(absl::StrCat("unsupported transform: ", error_));
+        }
+        return result;
+    }
+
+    /// Translates a Lua table constructor `{ name = expr, ... }`
+    absl::StatusOr<std::vector<StructFieldExpression>> translate_table() {
+        std::vector<StructFieldExpression> fields;
+        skip_space();
+        if (consume_word("return")) {
+            skip_space();
+        }
+        if (!consume("{")) {
+            fail("struct transform must be a table constructor");
+        }
+        skip_space();
+        while (error_.empty() && !consume("}")) {
+            StructFieldExpression field;
+            field.name = identifier();
+            skip_space();
+            if (field.name.empty() || !consume("=") || peek("=")) {
+                fail("expected 'name = expression' in table constructor");
+                break;
+            }
+            used_deps_.clear();
+            uses_source_ = false;
+            field.expression = comparison(&field.is_boolean);
+            field.uses_source = uses_source_;
+            field.dependencies.assign(used_deps_.begin(), used_deps_.end());
+            for (const auto& existing : fields) {
+                if (existing.name == field.name) {
+                    fail(absl::StrCat("duplicate field '", field.name, "'"));
+                }
+            }
+            fields.push_back(std::move(field));
+            skip_space();
+            if (!consume(",") && !consume(";")) {
+                skip_space();
+                if (!consume("}")) {
+                    fail("expected ',' or '}' in table constructor");
+                }
+                break;
+            }
+            skip_space();
+        }
+        skip_space();
+        consume(";");
+        skip_space();
+        if (error_.empty() && pos_ != code_.size()) {
+            fail(absl::StrCat("unexpected '", std::string(code_.substr(pos_)), "'"));
+        }
+        if (error_.empty() && fields.empty()) {
+            fail("struct without fields");
+        }
+        if (!error_.empty()) {
+            return absl::InvalidArgumentError(absl::StrCat("unsupported transform: ", error_));
+        }
+        return fields;
+    }
+
+private:
+    std::string comparison(bool* is_boolean) {
+        std::string lhs = additive();
+        static constexpr std::pair<std::string_view, std::string_view> kOps[] = {
+            {"<=", "<="}, {">=", ">="}, {"==", "=="}, {"~=", "!="}, {"<", "<"}, {">", ">"},
+        };
+        skip_space();
+        *is_boolean = false;
+        for (const auto& [lua, cpp] : kOps) {
+            if (consume(lua)) {
+                std::string rhs = additive();
+                *is_boolean = true;
+                return absl::StrCat("(", lhs, " ", std::string(cpp), " ", rhs, ")");
+            }
+        }
+        return lhs;
+    }
+
+    std::string additive() {
+        std::string value = term();
+        while (error_.empty()) {
+            skip_space();
+            if (consume("+")) {
+                value = absl::StrCat("(", value, " + ", term(), ")");
+            } else if (peek("-")) {
+                ++pos_;
+                value = absl::StrCat("(", value, " - ", term(), ")");
+            } else {
+                break;
+            }
+        }
+        return value;
+    }
+
+    std::string term() {
+        std::string value = unary();
+        while (error_.empty()) {
+            skip_space();
+            if (consume("*")) {
+                value = absl::StrCat("(", value, " * ", unary(), ")");
+            } else if (consume("//")) {
+                value = absl::StrCat("std::floor(", value, " / ", unary(), ")");
+            } else if (consume("/")) {
+                value = absl::StrCat("(", value, " / ", unary(), ")");
+            } else if (consume("%")) {
+                value = absl::StrCat("lua_mod(", value, ", ", unary(), ")");
+            } else {
+                break;
+            }
+        }
+        return value;
+    }
+
+    std::string unary() {
+        skip_space();
+        if (consume("-")) {
+            return absl::StrCat("(-", unary(), ")");
+        }
+        return power();
+    }
+
+    std::string power() {
+        std::string base = primary();
+        skip_space();
+        if (consume("^")) {
+            return absl::StrCat("std::pow(", base, ", ", unary(), ")");
+        }
+        return base;
+    }
+
+    std::string primary() {
+        skip_space();
+        if (!error_.empty()) {
+            return {};
+        }
+        if (pos_ >= code_.size()) {
+            fail("unexpected end of expression");
+            return {};
+        }
+        char c = code_[pos_];
+        if (consume("(")) {
+            bool nested_boolean = false;
+            std::string inner = comparison(&nested_boolean);
+            if (nested_boolean) {
+                fail("comparison inside an arithmetic expression");
+            }
+            skip_space();
+            if (!consume(")")) {
+                fail("missing ')'");
+            }
+            return absl::StrCat("(", inner, ")");
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            return number();
+        }
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            std::string name = identifier();
+            if (name == "x") {
+                if (!has_source_) {
+                    fail("'x' used by a signal without source");
+                }
+                uses_source_ = true;
+                return "x";
+            }
+            if (name == "deps") {
+                return dependency();
+            }
+            if (name == "math") {
+                return math_call();
+            }
+            fail(absl::StrCat("unknown name '", name, "'"));
+            return {};
+        }
+        fail(absl::StrCat("unexpected '", std::string(1, c), "'"));
+        return {};
+    }
+
+    std::string number() {
+        size_t start = pos_;
+        auto digits = [&] {
+            while (pos_ < code_.size() && std::isdigit(static_cast<unsigned char>(code_[pos_]))) {
+                ++pos_;
+            }
+        };
+        digits();
+        if (consume(".")) {
+            digits();
+        }
+        if (pos_ < code_.size() && (code_[pos_] == 'e' || code_[pos_] == 'E')) {
+            ++pos_;
+            if (!consume("+")) {
+                consume("-");
+            }
+            digits();
+        }
+        std::string_view text = code_.substr(start, pos_ - start);
+        std::string normalized(text);
+        if (!normalized.empty() && normalized.front() == '.') {
+            normalized.insert(normalized.begin(), '0');
+        }
+        auto value = parse_double(normalized);
+        if (!value) {
+            fail(absl::StrCat("bad number '", normalized, "'"));
+            return {};
+        }
+        return double_literal(*value);
+    }
+
+    std::string dependency() {
+        skip_space();
+        std::string name;
+        if (consume("[")) {
+            skip_space();
+            if (pos_ >= code_.size() || (code_[pos_] != '"' && code_[pos_] != '\'')) {
+                fail("deps[] needs a string literal");
+                return {};
+            }
+            char quote = code_[pos_++];
+            size_t end = code_.find(quote, pos_);
+            if (end == std::string_view::npos) {
+                fail("unterminated string");
+                return {};
+            }
+            name = std::string(code_.substr(pos_, end - pos_));
+            pos_ = end + 1;
+            skip_space();
+            if (!consume("]")) {
+                fail("missing ']'");
+                return {};
+            }
+        } else {
+            fail("deps must be indexed as deps[\"Name\"]");
+            return {};
+        }
+        auto it = std::find(depends_on_.begin(), depends_on_.end(), name);
+        if (it == depends_on_.end()) {
+            fail(absl::StrCat("'", name, "' is not listed in depends_on"));
+            return {};
+        }
+        used_deps_.insert(static_cast<size_t>(it - depends_on_.begin()));
+        return absl::StrCat("d", it - depends_on_.begin());
+    }
+
+    std::string math_call() {
+        if (!consume(".")) {
+            fail("expected math.<function>");
+            return {};
+        }
+        std::string function = identifier();
+        static const std::map<std::string, std::pair<std::string, bool>> kFunctions = {
+            {"abs", {"std::abs", false}},   {"floor", {"std::floor", false}},
+            {"ceil", {"std::ceil", false}}, {"sqrt", {"std::sqrt", false}},
+            {"min", {"std::fmin", true}},   {"max", {"std::fmax", true}},
+        };
+        auto it = kFunctions.find(function);
+        if (it == kFunctions.end()) {
+            fail(absl::StrCat("math.", function, " is not supported"));
+            return {};
+        }
+        skip_space();
+        if (!consume("(")) {
+            fail("expected '('");
+            return {};
+        }
+        std::vector<std::string> args;
+        do {
+            bool nested_boolean = false;
+            args.push_back(comparison(&nested_boolean));
+            if (nested_boolean) {
+                fail("comparison as a function argument");
+            }
+            skip_space();
+        } while (error_.empty() && consume(","));
+        if (!consume(")")) {
+            fail("missing ')'");
+            return {};
+        }
+
+        const auto& [cpp, variadic] = it->second;
+        if (!variadic) {
+            if (args.size() != 1) {
+                fail(absl::StrCat("math.", function, " takes one argument"));
+                return {};
+            }
+            return absl::StrCat(cpp, "(", args[0], ")");
+        }
+        std::string value = args[0];
+        for (size_t i = 1; i < args.size(); ++i) {
+            value = absl::StrCat(cpp, "(", value, ", ", args[i], ")");
+        }
+        return value;
+    }
+
+    std::string identifier() {
+        size_t start = pos_;
+        while (pos_ < code_.size() &&
+               (std::isalnum(static_cast<unsigned char>(code_[pos_])) || code_[pos_] == '_')) {
+            ++pos_;
+        }
+        return std::string(code_.substr(start, pos_ - start));
+    }
+
+    bool consume_word(std::string_view word) {
+        if (code_.substr(pos_, word.size()) != word) {
+            return false;
+        }
+        size_t end = pos_ + word.size();
+        if (end < code_.size() && (std::isalnum(static_cast<unsigned char>(code_[end])) || code_[end] == '_')) {
+            return false;
+        }
+        pos_ = end;
+        return true;
+    }
+
+    bool peek(std::string_view token) const {
+        return code_.substr(pos_, token.size()) == token;
+    }
+
+    bool consume(std::string_view token) {
+        if (!peek(token)) {
+            return false;
+        }
+        pos_ += token.size();
+        return true;
+    }
+
+    void skip_space() {
+        while (pos_ < code_.size() && std::isspace(static_cast<unsigned char>(code_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    void fail(std::string message) {
+        if (error_.empty()) {
+            error_ = std::move(message);
+        }
+        pos_ = code_.size();
+    }
+
+    std::string_view code_;
+    const std::vector<std::string>& depends_on_;
+    bool has_source_;
+    size_t pos_ = 0;
+    std::string error_;
+    std::set<size_t> used_deps_;
+    bool uses_source_ = false;
+};
+
+/// Per-node C++ statements computing `value`, built before partitioning
+struct NodePlan {
+    const DagNodeSpec* spec = nullptr;
+    std::string type;
+    std::string body;  // expression for `value`, or a statement chain setting `matched`
+    bool value_map = false;
+    std::vector<StructFieldExpression> fields;  // struct nodes only
+    std::string reason;  // non-empty if the node must be interpreted
+
+    bool is_struct() const { return type == "struct"; }
+    // Integer bodies are computed as double and range checked before the
+    // narrowing cast, which is undefined for NaN or out-of-range values
+    bool is_integer() const { return integer_range(type).has_value(); }
+};
+
+NodePlan plan_node(const DagNodeSpec& spec) {
+    NodePlan plan;
+    plan.spec = &spec;
+    plan.type = spec.datatype == "struct" ? "struct" : cpp_type(spec.datatype);
+    const bool has_source = !spec.source_name.empty();
+    const bool boolean = plan.type == "bool";
+
+    if (plan.type.empty()) {
+        plan.reason = absl::StrCat("datatype '", spec.datatype, "' is not numeric or boolean");
+        return plan;
+    }
+    if (!spec.update_trigger.empty() && spec.update_trigger != "on_dependency") {
+        plan.reason = absl::StrCat("update trigger '", spec.update_trigger, "'");
+        return plan;
+    }
+    if (has_source && spec.source_type != "dbc" && spec.source_type != "can" &&
+        spec.source_type != kOperatorSourceType) {
+        plan.reason = absl::StrCat("source type '", spec.source_type, "'");
+        return plan;
+    }
+    if (!has_source && spec.depends_on.empty()) {
+        plan.reason = "no source and no dependencies";
+        return plan;
+    }
+
+    if (plan.is_struct()) {
+        if (spec.transform != DagNodeSpec::Transform::CODE) {
+            plan.reason = "struct without a table constructor transform";
+            return plan;
+        }
+        auto fields = translate_struct(spec.code, spec.depends_on, has_source);
+        if (!fields.ok()) {
+            plan.reason = std::string(fields.status().message());
+            return plan;
+        }
+        plan.fields = std::move(*fields);
+        return plan;
+    }
+
+    switch (spec.transform) {
+        case DagNodeSpec::Transform::DIRECT:
+            if (!has_source) {
+                plan.reason = "direct mapping without source";
+                return plan;
+            }
+            if (boolean) {
+                plan.body = "(x != 0.0)";
+            } else {
+                plan.body = plan.is_integer() ? "x" : absl::StrCat("static_cast<", plan.type, ">(x)");
+            }
+            return plan;
+
+        case DagNodeSpec::Transform::CODE: {
+            bool is_boolean = false;
+            auto expression = translate_expression(spec.code, spec.depends_on, has_source, &is_boolean);
+            if (!expression.ok()) {
+                plan.reason = std::string(expression.status().message());
+                return plan;
+            }
+            if (boolean != is_boolean) {
+                plan.reason = boolean ? "numeric expression for a boolean signal"
+                                      : "boolean expression for a numeric signal";
+                return plan;
+            }
+            if (boolean || plan.is_integer()) {
+                plan.body = *expression;
+            } else {
+                plan.body = absl::StrCat("static_cast<", plan.type, ">(", *expression, ")");
+            }
+            return plan;
+        }
+
+        case DagNodeSpec::Transform::VALUE_MAP: {
+            if (!has_source) {
+                plan.reason = "value mapping without source";
+                return plan;
+            }
+            std::ostringstream chain;
+            const char* keyword = "if";
+            for (const auto& [from, to] : spec.value_map) {
+                auto from_value = parse_double(from);
+                if (!from_value) {
+                    plan.reason = absl::StrCat("non-numeric mapping key '", from, "'");
+                    return plan;
+                }
+                std::string to_literal;
+                if (boolean) {
+                    if (to != "true" && to != "false") {
+                        plan.reason = absl::StrCat("non-boolean mapping value '", to, "'");
+                        return plan;
+                    }
+                    to_literal = to;
+                } else {
+                    auto to_value = parse_double(to);
+                    if (!to_value) {
+                        plan.reason = absl::StrCat("non-numeric mapping value '", to, "'");
+                        return plan;
+                    }
+                    if (auto range = integer_range(plan.type);
+                        range && !(*to_value >= range->first && *to_value < range->second)) {
+                        plan.reason = absl::StrCat("mapping value '", to, "' out of range for ", spec.datatype);
+                        return plan;
+                    }
+                    to_literal = absl::StrCat("static_cast<", plan.type, ">(", double_literal(*to_value), ")");
+                }
+                chain << "        " << (keyword[0] == 'i' ? "" : "} ") << keyword << " (x == "
+                      << double_literal(*from_value) << ") {\n"
+                      << "            value = " << to_literal << ";\n";
+                keyword = "else if";
+            }
+            if (spec.value_map.empty()) {
+                plan.reason = "empty value mapping";
+                return plan;
+            }
+            chain << "        } else {\n"
+                  << "            matched = false;\n"
+                  << "        }\n";
+            plan.body = chain.str();
+            plan.value_map = true;
+            return plan;
+        }
+    }
+    return plan;
+}
+
+}  // namespace
+
+absl::StatusOr<std::string> translate_expression(std::string_view code,
+                                                 const std::vector<std::string>& depends_on,
+                                                 bool has_source,
+                                                 bool* is_boolean) {
+    bool boolean = false;
+    ExpressionTranslator translator(code, depends_on, has_source);
+    auto result = translator.translate(&boolean);
+    if (is_boolean != nullptr) {
+        *is_boolean = boolean;
+    }
+    return result;
+}
+
+absl::StatusOr<std::vector<StructFieldExpression>> translate_struct(std::string_view code,
+                                                                    const std::vector<std::string>& depends_on,
+                                                                    bool has_source) {
+    ExpressionTranslator translator(code, depends_on, has_source);
+    return translator.translate_table();
+}
+
+absl::StatusOr<DagCodegenResult> generate_dag(const std::vector<DagNodeSpec>& nodes,
+                                              const std::string& source_description) {
+    std::map<std::string, NodePlan> plans;
+    for (const auto& spec : nodes) {
+        if (plans.count(spec.name)) {
+            return absl::InvalidArgumentError(absl::StrCat("Duplicate mapping for '", spec.name, "'"));
+        }
+        plans[spec.name] = plan_node(spec);
+    }
+
+    // Shrink the compiled set until it is closed: every dependency compiled
+    // in (or an input signal), no interpreted dependent, no cycle.
+    std::vector<std::string> order;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto& [name, plan] : plans) {
+            if (!plan.reason.empty()) {
+                continue;
+            }
+            for (const auto& dep : plan.spec->depends_on) {
+                auto it = plans.find(dep);
+                if (it != plans.end() && !it->second.reason.empty()) {
+                    plan.reason = absl::StrCat("depends on interpreted '", dep, "'");
+                    changed = true;
+                    break;
+                }
+                if (it != plans.end() && it->second.is_struct()) {
+                    plan.reason = absl::StrCat("reads struct '", dep, "' as a value");
+                    changed = true;
+                    break;
+                }
+            }
+        }
+        for (const auto& [name, plan] : plans) {
+            if (plan.reason.empty()) {
+                continue;
+            }
+            for (const auto& dep : plan.spec->depends_on) {
+                auto it = plans.find(dep);
+                if (it != plans.end() && it->second.reason.empty()) {
+                    it->second.reason = absl::StrCat("needed by interpreted '", name, "'");
+                    changed = true;
+                }
+            }
+        }
+        if (changed) {
+            continue;
+        }
+
+        // Kahn's algorithm over the compiled nodes, alphabetical among ready
+        // nodes for stable output
+        std::map<std::string, size_t> pending;
+        std::map<std::string, std::vector<std::string>> dependents;
+        for (const auto& [name, plan] : plans) {
+            if (!plan.reason.empty()) {
+                continue;
+            }
+            pending[name] = 0;
+            for (const auto& dep : plan.spec->depends_on) {
+                if (plans.count(dep)) {
+                    ++pending[name];
+                    dependents[dep].push_back(name);
+                }
+            }
+        }
+        std::set<std::string> ready;
+        for (const auto& [name, count] : pending) {
+            if (count == 0) {
+                ready.insert(name);
+            }
+        }
+        order.clear();
+        while (!ready.empty()) {
+            std::string name = *ready.begin();
+            ready.erase(ready.begin());
+            order.push_back(name);
+            for (const auto& dependent : dependents[name]) {
+                if (--pending[dependent] == 0) {
+                    ready.insert(dependent);
+                }
+            }
+        }
+        if (order.size() != pending.size()) {
+            for (const auto& [name, count] : pending) {
+                if (count > 0) {
+                    plans[name].reason = "dependency cycle";
+                }
+            }
+            changed = true;
+        }
+    }
+
+    DagCodegenResult result;
+    result.generated = order;
+    for (const auto& [name, plan] : plans) {
+        if (!plan.reason.empty()) {
+            result.interpreted.emplace_back(name, plan.reason);
+        }
+    }
+
+    std::map<std::string, size_t> node_index;
+    for (size_t i = 0; i < order.size(); ++i) {
+        node_index[order[i]] = i;
+    }
+    std::vector<std::string> inputs;
+    std::map<std::string, size_t> input_index;
+    auto add_input = [&](const std::string& name) {
+        if (!input_index.count(name)) {
+            input_index[name] = inputs.size();
+            inputs.push_back(name);
+        }
+    };
+    for (const auto& name : order) {
+        const DagNodeSpec& spec = *plans[name].spec;
+        if (!spec.source_name.empty()) {
+            add_input(spec.source_name);
+        }
+        for (const auto& dep : spec.depends_on) {
+            if (!plans.count(dep)) {
+                add_input(dep);
+            }
+        }
+    }
+
+    // Each node's slot within the typed array of its storage class
+    std::map<std::string, size_t> slot_counts = {
+        {"bools", 0}, {"ints", 0}, {"uints", 0}, {"floats", 0}, {"doubles", 0},
+    };
+    std::vector<std::string> slots;  // by node index, e.g. "s.floats[2]"
+    std::vector<std::string> slot_refs;
+    std::vector<std::string> field_slots;  // by struct field, all structs in node order
+    std::vector<std::string> field_infos;
+    std::vector<std::string> struct_infos;
+    std::vector<std::pair<size_t, size_t>> struct_layout(order.size());  // struct index, first field
+    auto allocate = [&](const std::string& type, std::string& slot, std::string& ref) {
+        Storage storage = storage_for(type);
+        size_t index = slot_counts[storage.array]++;
+        slot = absl::StrCat("s.", storage.array, "[", index, "]");
+        ref = absl::StrCat("{SlotType::", storage.tag, ", ", index, "}");
+    };
+    for (const auto& name : order) {
+        const NodePlan& plan = plans[name];
+        std::string slot;
+        std::string ref;
+        if (plan.is_struct()) {
+            // Fields are slots of their own, laid out in declaration order
+            struct_layout[slots.size()] = {struct_infos.size(), field_slots.size()};
+            struct_infos.push_back(absl::StrCat("{\"", plan.spec->struct_type, "\", ", field_slots.size(), ", ",
+                                                plan.fields.size(), "}"));
+            for (const auto& field : plan.fields) {
+                std::string field_slot;
+                std::string field_ref;
+                allocate(field.is_boolean ? "bool" : "double", field_slot, field_ref);
+                field_slots.push_back(field_slot);
+                field_infos.push_back(absl::StrCat("{\"", field.name, "\", ", field_ref, "}"));
+            }
+            ref = absl::StrCat("{SlotType::STRUCT, ", struct_infos.size() - 1, "}");
+        } else {
+            allocate(plan.type, slot, ref);
+        }
+        slots.push_back(slot);
+        slot_refs.push_back(ref);
+    }
+
+    // SlotRef, StructInfo and StructRef hold 16-bit indices and counts
+    constexpr size_t kMaxCount = std::numeric_limits<uint16_t>::max();
+    for (const auto& [array, count] : slot_counts) {
+        if (count > kMaxCount) {
+            return absl::InvalidArgumentError(
+                absl::StrCat(count, " slots in the ", array, " array, at most ", kMaxCount, " are supported"));
+        }
+    }
+    if (struct_infos.size() > kMaxCount || field_infos.size() > kMaxCount) {
+        return absl::InvalidArgumentError(absl::StrCat(struct_infos.size(), " compiled-in structs with ",
+                                                       field_infos.size(), " fields, at most ", kMaxCount,
+                                                       " of each are supported"));
+    }
+
+    std::ostringstream out;
+    out << "// Generated by can2vss-codegen from " << source_description << ". Do not edit.\n"
+        << "\n"
+        << "#pragma once\n"
+        << "\n"
+        << "#include \"typed_value.h\"\n"
+        << "\n"
+        << "#include <array>\n"
+        << "#include <bitset>\n"
+        << "#include <chrono>\n"
+        << "#include <cmath>\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n"
+        << "#include <limits>\n"
+        << "#include <string_view>\n"
+        << "\n"
+        << "namespace can2vss::generated_dag {\n"
+        << "\n"
+        << "inline constexpr size_t kInputCount = " << inputs.size() << ";\n"
+        << "inline constexpr size_t kNodeCount = " << order.size() << ";\n"
+        << "\n"
+        << "inline constexpr size_t kBoolSlots = " << slot_counts["bools"] << ";\n"
+        << "inline constexpr size_t kIntSlots = " << slot_counts["ints"] << ";\n"
+        << "inline constexpr size_t kUintSlots = " << slot_counts["uints"] << ";\n"
+        << "inline constexpr size_t kFloatSlots = " << slot_counts["floats"] << ";\n"
+        << "inline constexpr size_t kDoubleSlots = " << slot_counts["doubles"] << ";\n"
+        << "\n"
+        << "inline constexpr std::array<std::string_view, kInputCount> kInputNames = {\n";
+    for (const auto& name : inputs) {
+        out << "    \"" << name << "\",\n";
+    }
+    out << "};\n"
+        << "\n"
+        << "inline constexpr std::array<std::string_view, kNodeCount> kNodeNames = {\n";
+    for (const auto& name : order) {
+        out << "    \"" << name << "\",\n";
+    }
+    out << "};\n"
+        << "\n"
+        << "/// Where each node's value lives in State's typed slot arrays\n"
+        << "inline constexpr std::array<SlotRef, kNodeCount> kNodeSlots = {{\n";
+    for (size_t i = 0; i < order.size(); ++i) {
+        out << "    " << slot_refs[i] << ",  // " << order[i] << "\n";
+    }
+    out << "}};\n"
+        << "\n"
+        << "inline constexpr size_t kStructCount = " << struct_infos.size() << ";\n"
+        << "inline constexpr size_t kStructFieldCount = " << field_infos.size() << ";\n"
+        << "\n"
+        << "/// Struct schemas: VSS type and the range of their fields in kStructFields\n"
+        << "inline constexpr std::array<StructInfo, kStructCount> kStructs = {{\n";
+    for (const auto& info : struct_infos) {
+        out << "    " << info << ",\n";
+    }
+    out << "}};\n"
+        << "\n"
+        << "inline constexpr std::array<StructFieldInfo, kStructFieldCount> kStructFields = {{\n";
+    for (const auto& info : field_infos) {
+        out << "    " << info << ",\n";
+    }
+    out << "}};\n"
+        << "\n"
+        << "/// True if x converts to the integer type T; the cast is undefined otherwise\n"
+        << "template <typename T>\n"
+        << "inline bool fits(double x) {\n"
+        << "    return std::isfinite(x) && x >= static_cast<double>(std::numeric_limits<T>::min()) &&\n"
+        << "           x < static_cast<double>(std::numeric_limits<T>::max()) + 1.0;\n"
+        << "}\n"
+        << "\n"
+        << "/// Lua's floored modulo\n"
+        << "inline double lua_mod(double a, double b) {\n"
+        << "    return a - std::floor(a / b) * b;\n"
+        << "}\n"
+        << "\n"
+        << "struct State {\n"
+        << "    std::array<double, kInputCount> input{};\n"
+        << "    std::array<bool, kInputCount> input_valid{};\n"
+        << "    std::array<bool, kInputCount> input_dirty{};\n"
+        << "    std::array<bool, kNodeCount> node_valid{};\n"
+        << "    std::array<bool, kNodeCount> node_dirty{};\n"
+        << "    std::array<bool, kNodeCount> held{};  // withheld by interval_ms, published when it ends\n"
+        << "    std::array<std::chrono::steady_clock::time_point, kNodeCount> emitted{};\n"
+        << "\n"
+        << "    // Node values, one array per storage class; integers are widened\n"
+        << "    std::bitset<kBoolSlots> bools;\n"
+        << "    std::array<int64_t, kIntSlots> ints{};\n"
+        << "    std::array<uint64_t, kUintSlots> uints{};\n"
+        << "    std::array<float, kFloatSlots> floats{};\n"
+        << "    std::array<double, kDoubleSlots> doubles{};\n"
+        << "};\n"
+        << "\n"
+        << "/// Value of a slot, tagged with its declared type\n"
+        << "inline TypedValue read_slot(const State& s, SlotRef slot) {\n"
+        << "    TypedValue value;\n"
+        << "    value.type = slot.type;\n"
+        << "    switch (slot.type) {\n"
+        << "        case SlotType::BOOL:\n"
+        << "            value.b = s.bools[slot.index];\n"
+        << "            break;\n"
+        << "        case SlotType::INT8:\n"
+        << "        case SlotType::INT16:\n"
+        << "        case SlotType::INT32:\n"
+        << "        case SlotType::INT64:\n"
+        << "            value.i = s.ints[slot.index];\n"
+        << "            break;\n"
+        << "        case SlotType::UINT8:\n"
+        << "        case SlotType::UINT16:\n"
+        << "        case SlotType::UINT32:\n"
+        << "        case SlotType::UINT64:\n"
+        << "            value.u = s.uints[slot.index];\n"
+        << "            break;\n"
+        << "        case SlotType::FLOAT:\n"
+        << "            value.f = s.floats[slot.index];\n"
+        << "            break;\n"
+        << "        case SlotType::DOUBLE:\n"
+        << "            value.d = s.doubles[slot.index];\n"
+        << "            break;\n"
+        << "        case SlotType::STRUCT:\n"
+        << "            value.u = slot.index;\n"
+        << "            break;\n"
+        << "        case SlotType::NONE:\n"
+        << "            break;\n"
+        << "    }\n"
+        << "    return value;\n"
+        << "}\n"
+        << "\n"
+        << "/// Current value of a node; for structs, the struct index into kStructs\n"
+        << "inline TypedValue read(const State& s, size_t node) {\n"
+        << "    return read_slot(s, kNodeSlots[node]);\n"
+        << "}\n"
+        << "\n"
+        << "inline void set_input(State& s, size_t input, double value) {\n"
+        << "    s.input[input] = value;\n"
+        << "    s.input_valid[input] = true;\n"
+        << "    s.input_dirty[input] = true;\n"
+        << "}\n"
+        << "\n"
+        << "/// For an invalid or out-of-range update: nodes reading the input become invalid\n"
+        << "inline void invalidate_input(State& s, size_t input) {\n"
+        << "    s.input_valid[input] = false;\n"
+        << "    s.input_dirty[input] = true;\n"
+        << "}\n"
+        << "\n"
+        << "template <typename Sink>\n"
+        << "inline void evaluate(State& s, [[maybe_unused]] std::chrono::steady_clock::time_point now,\n"
+        << "                     [[maybe_unused]] Sink&& sink) {\n";
+
+    auto join = [](const std::vector<std::string>& terms, const char* op) {
+        std::string joined;
+        for (const auto& term : terms) {
+            joined += joined.empty() ? term : absl::StrCat(" ", op, " ", term);
+        }
+        return joined;
+    };
+    // A new value is published right away, or with interval_ms held until
+    // the interval since the last publish ends, as libvssdag does
+    auto emit = [&](size_t i, const DagNodeSpec& spec, const std::string& indent, const std::string& value) {
+        if (spec.interval_ms > 0) {
+            out << indent << "s.held[" << i << "] = true;\n";
+        } else {
+            out << indent << "sink(size_t{" << i << "}, " << value << ");\n";
+        }
+    };
+    auto emit_held = [&](size_t i, const DagNodeSpec& spec, const std::string& value) {
+        if (spec.interval_ms <= 0) {
+            return;
+        }
+        out << "    if (s.held[" << i << "] && now - s.emitted[" << i << "] >= std::chrono::milliseconds("
+            << spec.interval_ms << ")) {\n"
+            << "        s.held[" << i << "] = false;\n"
+            << "        s.emitted[" << i << "] = now;\n"
+            << "        sink(size_t{" << i << "}, " << value << ");\n"
+            << "    }\n";
+    };
+    // Closes a node's update block: an input that went invalid invalidates
+    // the node, and through its dirty flag every node reading it; a held
+    // value is dropped
+    auto invalidation = [&](size_t i, const DagNodeSpec& spec, const std::string& indent) {
+        out << indent << "s.node_valid[" << i << "] = false;\n"
+            << indent << "s.node_dirty[" << i << "] = true;\n";
+        if (spec.interval_ms > 0) {
+            out << indent << "s.held[" << i << "] = false;\n";
+        }
+    };
+    auto invalidate = [&](size_t i, const DagNodeSpec& spec, const std::vector<std::string>& dirty) {
+        out << "    } else if ((" << join(dirty, "||") << ") && s.node_valid[" << i << "]) {\n";
+        invalidation(i, spec, "        ");
+        out << "    }\n";
+    };
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        const NodePlan& plan = plans[order[i]];
+        const DagNodeSpec& spec = *plan.spec;
+
+        std::vector<std::string> dirty;
+        std::vector<std::string> valid;
+        std::vector<std::string> loads;
+        std::string source_dirty;
+        if (!spec.source_name.empty()) {
+            size_t in = input_index[spec.source_name];
+            source_dirty = absl::StrCat("s.input_dirty[", in, "]");
+            dirty.push_back(source_dirty);
+            valid.push_back(absl::StrCat("s.input_valid[", in, "]"));
+            loads.push_back(absl::StrCat("        [[maybe_unused]] const double x = s.input[", in, "];\n"));
+        }
+        for (size_t d = 0; d < spec.depends_on.size(); ++d) {
+            const std::string& dep = spec.depends_on[d];
+            if (auto it = node_index.find(dep); it != node_index.end()) {
+                dirty.push_back(absl::StrCat("s.node_dirty[", it->second, "]"));
+                valid.push_back(absl::StrCat("s.node_valid[", it->second, "]"));
+                loads.push_back(absl::StrCat("        [[maybe_unused]] const double d", d,
+                                             " = static_cast<double>(", slots[it->second], ");\n"));
+            } else {
+                size_t in = input_index[dep];
+                dirty.push_back(absl::StrCat("s.input_dirty[", in, "]"));
+                valid.push_back(absl::StrCat("s.input_valid[", in, "]"));
+                loads.push_back(absl::StrCat("        [[maybe_unused]] const double d", d,
+                                             " = s.input[", in, "];\n"));
+            }
+        }
+
+        out << (i > 0 ? "\n" : "") << "    // " << order[i] << "\n"
+            << "    if ((" << join(dirty, "||") << ") && " << join(valid, "&&") << ") {\n";
+        for (const auto& load : loads) {
+            out << load;
+        }
+
+        if (plan.is_struct()) {
+            // Only fields whose inputs changed are recomputed; the struct is
+            // published as a whole
+            const auto [struct_index, first_field] = struct_layout[i];
+            for (size_t f = 0; f < plan.fields.size(); ++f) {
+                const auto& field = plan.fields[f];
+                std::vector<std::string> field_dirty = {absl::StrCat("!s.node_valid[", i, "]")};
+                if (field.uses_source) {
+                    field_dirty.push_back(source_dirty);
+                }
+                for (size_t d : field.dependencies) {
+                    field_dirty.push_back(dirty[d + (source_dirty.empty() ? 0 : 1)]);
+                }
+                out << "        if (" << join(field_dirty, "||") << ") {\n"
+                    << "            " << field_slots[first_field + f] << " = "
+                    << (field.is_boolean ? field.expression : absl::StrCat("static_cast<double>(", field.expression, ")"))
+                    << ";  // " << field.name << "\n"
+                    << "        }\n";
+            }
+            out << "        s.node_valid[" << i << "] = true;\n"
+                << "        s.node_dirty[" << i << "] = true;\n";
+            emit(i, spec, "        ", absl::StrCat("StructRef{", struct_index, "}"));
+            invalidate(i, spec, dirty);
+            emit_held(i, spec, absl::StrCat("StructRef{", struct_index, "}"));
+            continue;
+        }
+
+        std::string indent = "        ";
+        if (plan.value_map) {
+            out << "        " << plan.type << " value{};\n"
+                << "        bool matched = true;\n"
+                << plan.body
+                << "        if (matched) {\n";
+            indent = "            ";
+        } else if (plan.is_integer()) {
+            out << "        const double raw = " << plan.body << ";\n"
+                << "        if (fits<" << plan.type << ">(raw)) {\n"
+                << "            const " << plan.type << " value = static_cast<" << plan.type << ">(raw);\n";
+            indent = "            ";
+        } else {
+            out << "        const " << plan.type << " value = " << plan.body << ";\n";
+        }
+        out << indent << slots[i] << " = value;\n"
+            << indent << "s.node_valid[" << i << "] = true;\n"
+            << indent << "s.node_dirty[" << i << "] = true;\n";
+        emit(i, spec, indent, "value");
+        if (plan.value_map) {
+            out << "        }\n";
+        } else if (plan.is_integer()) {
+            // A value the type can not hold invalidates the node like an invalid input
+            out << "        } else if (s.node_valid[" << i << "]) {\n";
+            invalidation(i, spec, "            ");
+            out << "        }\n";
+        }
+        invalidate(i, spec, dirty);
+        // Slots only take values that passed fits<T>() or a range-checked
+        // mapping literal, so narrowing the widened slot back is exact
+        emit_held(i, spec, absl::StrCat("static_cast<", plan.type, ">(", slots[i], ")"));
+    }
+
+    out << "\n"
+        << "    s.input_dirty.fill(false);\n"
+        << "    s.node_dirty.fill(false);\n"
+        << "}\n"
+        << "\n"
+        << "}  // namespace can2vss::generated_dag\n";
+
+    result.header = out.str();
+    return result;
+}
+
+}  // namespace can2vss
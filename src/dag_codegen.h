@@ -0,0 +1,123 @@
+/**
+ * @file dag_codegen.h
+ * @brief Generates typed C++ evaluation code for the mapping DAG
+ */
+
+#pragma once
+
+#include <absl/status/statusor.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief One mapping entry as seen by the DAG generator
+ *
+ * A plain copy of the mapping YAML fields, so the generator does not depend
+ * on libvssdag.
+ */
+struct DagNodeSpec {
+    enum class Transform { DIRECT, CODE, VALUE_MAP };
+
+    std::string name;                      ///< VSS path
+    std::string source_type;               ///< "dbc"/"can"/"operator", empty for derived signals
+    std::string source_name;               ///< Input signal bound to `x`
+    std::string datatype;                  ///< Mapping datatype string, e.g. "float"
+    std::string struct_type;               ///< VSS struct type for "struct" datatypes
+    std::vector<std::string> depends_on;
+    Transform transform = Transform::DIRECT;
+    std::string code;                      ///< CODE: Lua expression
+    std::vector<std::pair<std::string, std::string>> value_map;  ///< VALUE_MAP: from, to
+    int interval_ms = 0;
+    std::string update_trigger;            ///< Empty means on dependency
+};
+
+/**
+ * @brief Result of DAG code generation
+ */
+struct DagCodegenResult {
+    std::string header;
+    std::vector<std::string> generated;  ///< Compiled-in nodes, topological order
+    std::vector<std::pair<std::string, std::string>> interpreted;  ///< Node, reason left to libvssdag
+};
+
+/**
+ * @brief One field of a struct transform, translated to C++
+ */
+struct StructFieldExpression {
+    std::string name;
+    std::string expression;            ///< As returned by translate_expression()
+    bool is_boolean = false;
+    bool uses_source = false;          ///< Reads `x`
+    std::vector<size_t> dependencies;  ///< Indices into depends_on read by the field
+};
+
+/**
+ * @brief Translates a Lua expression to a C++ double expression
+ *
+ * Accepts numbers, `x` (the source value, only if has_source), `deps["Name"]`
+ * for names in depends_on, + - * / % ^, unary minus, parentheses and
+ * math.abs/min/max/floor/ceil/sqrt. A single top-level comparison
+ * (< <= > >= == ~=) yields a boolean expression. Dependencies are emitted as
+ * `d<index>` into depends_on.
+ *
+ * @param code Lua source, optionally prefixed by `return`
+ * @param is_boolean Set to whether the expression is a comparison
+ * @return C++ expression, or an error describing the unsupported construct
+ */
+absl::StatusOr<std::string> translate_expression(std::string_view code,
+                                                 const std::vector<std::string>& depends_on,
+                                                 bool has_source,
+                                                 bool* is_boolean);
+
+/**
+ * @brief Translates a struct transform, a Lua table constructor
+ *
+ * `{ speed = deps["Vehicle.Speed"], moving = x > 0 }`: each field is an
+ * expression accepted by translate_expression(); comparisons make boolean
+ * fields, everything else double fields.
+ */
+absl::StatusOr<std::vector<StructFieldExpression>> translate_struct(std::string_view code,
+                                                                    const std::vector<std::string>& depends_on,
+                                                                    bool has_source);
+
+/**
+ * @brief Emits a header evaluating the natively expressible part of the DAG
+ *
+ * A node is compiled in if its datatype is numeric, boolean or a struct
+ * built by a table constructor, it is updated on dependency, its transform
+ * translates, no compiled-in node reads it as a number if it is a struct, all its dependencies are
+ * compiled in or input signals, and no interpreted node depends on it.
+ * Everything else is reported in DagCodegenResult::interpreted and stays with
+ * libvssdag.
+ *
+ * The header defines, in namespace can2vss::generated_dag:
+ * - kInputNames / kNodeNames: input signals and compiled-in VSS paths
+ * - State: valid and dirty flags for every input and node, and node values
+ *   in typed slot arrays (a bool bitset, widened int and uint arrays, float
+ *   and double arrays); kNodeSlots locates each node's slot and read()
+ *   returns it as a TypedValue
+ * - kStructs / kStructFields: schema of each struct node, whose fields are
+ *   slots of their own, updated individually when their inputs change
+ * - set_input() / invalidate_input(): a new input value, or an invalid or
+ *   out-of-range update; an invalid input makes every node reading it,
+ *   directly or through other nodes, invalid until it is valid again
+ * - evaluate(state, now, sink): evaluates nodes affected by dirty inputs in
+ *   topological order, calling sink(node_index, value) with the node's C++
+ *   type for every value due for publishing. With interval_ms, a value
+ *   computed within the interval is held and the latest one is published by
+ *   the first evaluate() after the interval ends, also without new input
+ *
+ * @param nodes Mapping entries, in any order
+ * @param source_description Provenance recorded in the header comment
+ * @return Generated header and partition, or an error for duplicate names or
+ *         more than 65535 slots of one storage class, structs or struct fields
+ */
+absl::StatusOr<DagCodegenResult> generate_dag(const std::vector<DagNodeSpec>& nodes,
+                                              const std::string& source_description);
+
+}  // namespace can2vss
@@ -0,0 +1,411 @@
+/**
+ * @file dbc_parser.cpp
+ * @brief Minimal DBC reader for message and signal layouts
+ */
+
+#include "dbc_parser.h"
+
+#include "can_bits.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <unordered_set>
+
+namespace can2vss {
+
+namespace {
+
+// BO_ <id> <name>: <dlc> <transmitter>
+bool parse_message_line(const std::string& line, DbcMessage& message) {
+    std::istringstream in(line.substr(4));
+    uint64_t raw_id = 0;
+    std::string name;
+    if (!(in >> raw_id >> name >> message.dlc)) {
+        return false;
+    }
+    if (!name.empty() && name.back() == ':') {
+        name.pop_back();
+    }
+    message.extended = (raw_id & DbcMessage::kExtendedFlag) != 0;
+    message.id = static_cast<uint32_t>(raw_id & ~uint64_t{DbcMessage::kExtendedFlag});
+    message.name = std::move(name);
+    return true;
+}
+
+// SG_ <name> [M|mN] : <start>|<len>@<order><sign> (<factor>,<offset>) [<min>|<max>] "<unit>" <receivers>
+bool parse_signal_line(const std::string& line, DbcSignal& signal) {
+    auto colon = line.find(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+
+    std::istringstream head(line.substr(line.find("SG_") + 3, colon - line.find("SG_") - 3));
+    std::string mux;
+    if (!(head >> signal.name)) {
+        return false;
+    }
+    if (head >> mux) {
+        if (mux == "M") {
+            signal.multiplex = DbcSignal::Multiplex::MULTIPLEXOR;
+        } else if (mux.size() > 1 && mux[0] == 'm') {
+            signal.multiplex = DbcSignal::Multiplex::MULTIPLEXED;
+            signal.mux_value = static_cast<unsigned>(std::stoul(mux.substr(1)));
+        }
+    }
+
+    const char* body = line.c_str() + colon + 1;
+    unsigned order = 0;
+    char sign = '+';
+    char unit[128] = {};
+    int n = std::sscanf(body, " %u|%u@%u%c (%lf,%lf) [%lf|%lf] \"%127[^\"]\"",
+                        &signal.start_bit, &signal.length, &order, &sign,
+                        &signal.factor, &signal.offset, &signal.minimum, &signal.maximum, unit);
+    if (n < 8) {
+        return false;
+    }
+    signal.little_endian = order == 1;
+    signal.is_signed = sign == '-';
+    signal.unit = n == 9 ? unit : "";
+    return signal.length >= 1 && signal.length <= 64;
+}
+
+bool starts_with(std::string_view text, std::string_view prefix) {
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+// Returns the line starting at pos without its line ending and moves pos past it
+std::string_view next_line(std::string_view text, size_t& pos) {
+    size_t end = text.find('\n', pos);
+    if (end == std::string_view::npos) {
+        end = text.size();
+    }
+    std::string_view line = text.substr(pos, end - pos);
+    pos = end < text.size() ? end + 1 : end;
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+std::optional<uint64_t> leading_id(std::string_view text) {
+    auto first = text.find_first_not_of(" \t");
+    if (first == std::string_view::npos) {
+        return std::nullopt;
+    }
+    uint64_t id = 0;
+    auto [ptr, ec] = std::from_chars(text.data() + first, text.data() + text.size(), id);
+    if (ec != std::errc()) {
+        return std::nullopt;
+    }
+    return id;
+}
+
+// Message ID a top-level statement refers to: comments, attributes and value
+// descriptions of a message or one of its signals
+std::optional<uint64_t> referenced_message(std::string_view line) {
+    for (std::string_view keyword : {"VAL_ ", "SG_MUL_VAL_ ", "SIG_VALTYPE_ ", "BO_TX_BU_ ", "SIG_GROUP_ "}) {
+        if (starts_with(line, keyword)) {
+            return leading_id(line.substr(keyword.size()));
+        }
+    }
+    if (starts_with(line, "CM_ ")) {
+        line.remove_prefix(4);
+    } else if (starts_with(line, "BA_ ")) {
+        // BA_ "<attribute>" BO_|SG_ <id> ...
+        auto open = line.find('"');
+        auto close = open == std::string_view::npos ? open : line.find('"', open + 1);
+        if (close == std::string_view::npos) {
+            return std::nullopt;
+        }
+        line.remove_prefix(close + 1);
+    } else {
+        return std::nullopt;
+    }
+    line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+    if (starts_with(line, "BO_ ") || starts_with(line, "SG_ ")) {
+        return leading_id(line.substr(4));
+    }
+    return std::nullopt;
+}
+
+/// Whether a line ends its statement with a ';' outside quoted strings;
+/// in_string carries a string left open, e.g. a multi-line comment, to the next line
+bool ends_statement(std::string_view line, bool& in_string) {
+    bool ended = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        const char c = line[i];
+        if (in_string) {
+            if (c == '\\') {
+                ++i;
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == ';') {
+            ended = true;
+        } else if (c != ' ' && c != '\t') {
+            ended = false;
+        }
+    }
+    return ended && !in_string;
+}
+
+}  // namespace
+
+const DbcSignal* DbcMessage::multiplexor() const {
+    for (const auto& signal : signals) {
+        if (signal.multiplex == DbcSignal::Multiplex::MULTIPLEXOR) {
+            return &signal;
+        }
+    }
+    return nullptr;
+}
+
+const DbcMessage* DbcDatabase::find_message_for_signal(const std::string& signal_name) const {
+    for (const auto& message : messages) {
+        for (const auto& signal : message.signals) {
+            if (signal.name == signal_name) {
+                return &message;
+            }
+        }
+    }
+    return nullptr;
+}
+
+absl::StatusOr<DbcDatabase> parse_dbc(std::istream& in) {
+    DbcDatabase db;
+    DbcMessage* current = nullptr;
+    std::string line;
+    int line_number = 0;
+
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (line.rfind("BO_ ", 0) == 0) {
+            DbcMessage message;
+            if (!parse_message_line(line, message)) {
+                return absl::InvalidArgumentError(absl::StrCat("Malformed BO_ at line ", line_number));
+            }
+            db.messages.push_back(std::move(message));
+            current = &db.messages.back();
+            continue;
+        }
+
+        auto first = line.find_first_not_of(" \t");
+        if (first != std::string::npos && line.compare(first, 4, "SG_ ") == 0) {
+            if (current == nullptr) {
+                return absl::InvalidArgumentError(absl::StrCat("SG_ outside BO_ at line ", line_number));
+            }
+            DbcSignal signal;
+            if (!parse_signal_line(line, signal)) {
+                return absl::InvalidArgumentError(absl::StrCat("Malformed SG_ at line ", line_number));
+            }
+            current->signals.push_back(std::move(signal));
+            continue;
+        }
+
+        // Any other non-indented statement ends the current message
+        if (first == 0) {
+            current = nullptr;
+        }
+    }
+    return db;
+}
+
+absl::StatusOr<DbcDatabase> parse_dbc_file(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        return absl::NotFoundError(absl::StrCat("Cannot open DBC file ", path));
+    }
+    return parse_dbc(in);
+}
+
+absl::StatusOr<std::unique_ptr<DbcIndex>> DbcIndex::build(std::string text) {
+    std::unique_ptr<DbcIndex> index(new DbcIndex());
+    index->text_ = std::move(text);
+    const std::string_view text_view = index->text_;
+
+    size_t current = 0;
+    bool in_message = false;
+    size_t pos = 0;
+    int line_number = 0;
+    while (pos < text_view.size()) {
+        const size_t line_start = pos;
+        std::string_view line = next_line(text_view, pos);
+        ++line_number;
+
+        if (starts_with(line, "BO_ ")) {
+            auto id = leading_id(line.substr(4));
+            if (!id) {
+                return absl::InvalidArgumentError(absl::StrCat("Malformed BO_ at line ", line_number));
+            }
+            index->messages_.push_back({*id, line_start, pos});
+            current = index->messages_.size() - 1;
+            in_message = true;
+            continue;
+        }
+
+        auto first = line.find_first_not_of(" \t");
+        if (first != std::string_view::npos && line.compare(first, 4, "SG_ ") == 0) {
+            if (!in_message) {
+                return absl::InvalidArgumentError(absl::StrCat("SG_ outside BO_ at line ", line_number));
+            }
+            // Only the name is read here; the layout is parsed on demand
+            auto name_begin = line.find_first_not_of(" \t", first + 4);
+            auto name_end = line.find_first_of(" \t:", name_begin);
+            if (name_begin == std::string_view::npos || name_end == std::string_view::npos) {
+                return absl::InvalidArgumentError(absl::StrCat("Malformed SG_ at line ", line_number));
+            }
+            index->signal_messages_.emplace(line.substr(name_begin, name_end - name_begin), current);
+            index->messages_[current].end = pos;
+            continue;
+        }
+
+        if (first == 0) {
+            in_message = false;
+        }
+    }
+    return index;
+}
+
+absl::StatusOr<std::unique_ptr<DbcIndex>> DbcIndex::build_from_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return absl::NotFoundError(absl::StrCat("Cannot open DBC file ", path));
+    }
+    std::string text;
+    in.seekg(0, std::ios::end);
+    const auto size = in.tellg();
+    in.seekg(0, std::ios::beg);
+    if (size > 0) {
+        text.resize(static_cast<size_t>(size));
+        in.read(text.data(), size);
+    } else {
+        // Not seekable, e.g. a pipe
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        text = contents.str();
+    }
+    return build(std::move(text));
+}
+
+std::vector<size_t> DbcIndex::select(const std::set<std::string>& signal_names) const {
+    std::vector<bool> selected(messages_.size());
+    for (const auto& name : signal_names) {
+        auto [begin, end] = signal_messages_.equal_range(name);
+        for (auto it = begin; it != end; ++it) {
+            selected[it->second] = true;
+        }
+    }
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < messages_.size(); ++i) {
+        if (selected[i]) {
+            indices.push_back(i);
+        }
+    }
+    return indices;
+}
+
+std::optional<uint64_t> DbcIndex::message_id(const std::string& signal_name) const {
+    auto [begin, end] = signal_messages_.equal_range(signal_name);
+    if (begin == end) {
+        return std::nullopt;
+    }
+    size_t first = begin->second;
+    for (auto it = begin; it != end; ++it) {
+        first = std::min(first, it->second);
+    }
+    return messages_[first].raw_id;
+}
+
+size_t DbcIndex::count_messages(const std::set<std::string>& signal_names) const {
+    return select(signal_names).size();
+}
+
+absl::StatusOr<DbcDatabase> DbcIndex::load_messages(const std::set<std::string>& signal_names) const {
+    std::string blocks;
+    for (size_t i : select(signal_names)) {
+        blocks.append(text_, messages_[i].begin, messages_[i].end - messages_[i].begin);
+        blocks += '\n';
+    }
+    std::istringstream in(blocks);
+    return parse_dbc(in);
+}
+
+std::string DbcIndex::subset_text(const std::set<std::string>& signal_names) const {
+    std::vector<bool> keep(messages_.size());
+    for (size_t i : select(signal_names)) {
+        keep[i] = true;
+    }
+    std::unordered_set<uint64_t> dropped_ids;
+    for (size_t i = 0; i < messages_.size(); ++i) {
+        if (!keep[i]) {
+            dropped_ids.insert(messages_[i].raw_id);
+        }
+    }
+
+    const std::string_view text_view = text_;
+    std::string out;
+    size_t pos = 0;
+    size_t next_message = 0;
+    bool skipping_statement = false;
+    bool in_string = false;  // a quoted string continues on the next line
+    while (pos < text_view.size()) {
+        if (next_message < messages_.size() && pos == messages_[next_message].begin) {
+            if (!keep[next_message]) {
+                pos = messages_[next_message++].end;
+                continue;
+            }
+            ++next_message;
+        }
+
+        const size_t line_start = pos;
+        std::string_view line = next_line(text_view, pos);
+        if (!skipping_statement && !in_string) {
+            if (auto id = referenced_message(line); id && dropped_ids.count(*id)) {
+                skipping_statement = true;
+            }
+        }
+        // Statements such as multi-line comments run up to their ';', which
+        // may not be inside the comment text
+        const bool ended = ends_statement(line, in_string);
+        if (skipping_statement) {
+            skipping_statement = !ended;
+            continue;
+        }
+        out.append(text_view.substr(line_start, pos - line_start));
+    }
+    return out;
+}
+
+absl::StatusOr<DbcDatabase> parse_dbc_file_for_signals(const std::string& path,
+                                                       const std::set<std::string>& signal_names) {
+    auto index = DbcIndex::build_from_file(path);
+    if (!index.ok()) {
+        return index.status();
+    }
+    return (*index)->load_messages(signal_names);
+}
+
+int64_t decode_raw(const DbcSignal& signal, const uint8_t* data) {
+    uint64_t raw = can_bits::extract(data, signal.start_bit, signal.length, signal.little_endian);
+    return signal.is_signed ? can_bits::sign_extend(raw, signal.length) : static_cast<int64_t>(raw);
+}
+
+double decode_physical(const DbcSignal& signal, const uint8_t* data) {
+    int64_t raw = decode_raw(signal, data);
+    double value = signal.is_signed ? static_cast<double>(raw) : static_cast<double>(static_cast<uint64_t>(raw));
+    return value * signal.factor + signal.offset;
+}
+
+}  // namespace can2vss
@@ -0,0 +1,138 @@
+/**
+ * @file dbc_parser.h
+ * @brief Minimal DBC reader for message and signal layouts
+ *
+ * Reads the BO_ and SG_ sections, which is all the code generator needs;
+ * value tables, attributes and comments are skipped.
+ */
+
+#pragma once
+
+#include <absl/status/statusor.h>
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace can2vss {
+
+struct DbcSignal {
+    enum class Multiplex {
+        NONE,
+        MULTIPLEXOR,   // "M": selects which multiplexed signals are present
+        MULTIPLEXED,   // "mN": present when the multiplexor equals mux_value
+    };
+
+    std::string name;
+    unsigned start_bit = 0;
+    unsigned length = 0;
+    bool little_endian = true;  // @1 (Intel) vs @0 (Motorola)
+    bool is_signed = false;
+    double factor = 1.0;
+    double offset = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    std::string unit;
+    Multiplex multiplex = Multiplex::NONE;
+    unsigned mux_value = 0;
+};
+
+struct DbcMessage {
+    static constexpr uint32_t kExtendedFlag = 0x80000000u;
+
+    uint32_t id = 0;         // without the extended-frame flag
+    bool extended = false;
+    std::string name;
+    unsigned dlc = 0;
+    std::vector<DbcSignal> signals;
+
+    const DbcSignal* multiplexor() const;
+};
+
+struct DbcDatabase {
+    std::vector<DbcMessage> messages;
+
+    /// Message containing a signal with this name, or nullptr
+    const DbcMessage* find_message_for_signal(const std::string& signal_name) const;
+};
+
+absl::StatusOr<DbcDatabase> parse_dbc(std::istream& in);
+absl::StatusOr<DbcDatabase> parse_dbc_file(const std::string& path);
+
+/**
+ * @brief Message boundaries of a DBC, for parsing only the messages a mapping uses
+ *
+ * Building the index reads the file once and records each BO_ block's ID and
+ * byte range and the names of its signals, without parsing signal layouts.
+ * Only the messages holding a requested signal are then parsed, so startup
+ * time and memory follow the mapping rather than the DBC, which for OEM DBCs
+ * can hold tens of thousands of signals.
+ */
+class DbcIndex {
+public:
+    static absl::StatusOr<std::unique_ptr<DbcIndex>> build(std::string text);
+    static absl::StatusOr<std::unique_ptr<DbcIndex>> build_from_file(const std::string& path);
+
+    DbcIndex(const DbcIndex&) = delete;
+    DbcIndex& operator=(const DbcIndex&) = delete;
+
+    size_t message_count() const { return messages_.size(); }
+    size_t signal_count() const { return signal_messages_.size(); }
+
+    /// ID, as written in the DBC, of the first message holding the signal
+    std::optional<uint64_t> message_id(const std::string& signal_name) const;
+
+    /// Number of messages holding at least one of the signals
+    size_t count_messages(const std::set<std::string>& signal_names) const;
+
+    /**
+     * @brief Parses the messages holding at least one of the signals
+     *
+     * Messages keep all their signals and their order in the file; names not
+     * in the DBC are ignored.
+     */
+    absl::StatusOr<DbcDatabase> load_messages(const std::set<std::string>& signal_names) const;
+
+    /**
+     * @brief The DBC text reduced to the messages holding the signals
+     *
+     * Drops the BO_ blocks of all other messages, and the comments, value
+     * descriptions and attributes that refer to them; everything else is
+     * kept verbatim, so the result is a valid DBC for any DBC reader.
+     */
+    std::string subset_text(const std::set<std::string>& signal_names) const;
+
+private:
+    struct MessageSpan {
+        uint64_t raw_id = 0;  ///< As written, including the extended-frame flag
+        size_t begin = 0;     ///< Offset of the BO_ line
+        size_t end = 0;       ///< Offset past the block's last SG_ line
+    };
+
+    DbcIndex() = default;
+
+    /// Indices of the messages holding the signals, in file order
+    std::vector<size_t> select(const std::set<std::string>& signal_names) const;
+
+    std::string text_;
+    std::vector<MessageSpan> messages_;
+    std::unordered_multimap<std::string_view, size_t> signal_messages_;  // views into text_
+};
+
+/// Parses only the messages of a DBC file that hold one of the signals
+absl::StatusOr<DbcDatabase> parse_dbc_file_for_signals(const std::string& path,
+                                                       const std::set<std::string>& signal_names);
+
+/// Raw value of a signal from an 8 byte (zero-padded) payload
+int64_t decode_raw(const DbcSignal& signal, const uint8_t* data);
+
+/// Physical value (raw * factor + offset)
+double decode_physical(const DbcSignal& signal, const uint8_t* data);
+
+}  // namespace can2vss
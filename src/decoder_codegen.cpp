@@ -0,0 +1,229 @@
+/**
+ * @file decoder_codegen.cpp
+ * @brief Generates specialized C++ decoders for the mapped signals of a DBC
+ */
+
+#include "decoder_codegen.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <charconv>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace can2vss {
+
+namespace {
+
+// Marks extended IDs in kSignalMessageIds, as CAN_EFF_FLAG does in can_id
+constexpr uint32_t kExtendedIdFlag = 0x80000000U;
+
+// Shortest representation that round-trips, always with a decimal point or
+// exponent so the literal is a double
+std::string double_literal(double value) {
+    char buf[64];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    std::string text(buf, end);
+    if (text.find_first_of(".en") == std::string::npos) {
+        text += ".0";
+    }
+    return text;
+}
+
+std::string hex_id(uint32_t id) {
+    std::ostringstream out;
+    out << "0x" << std::hex << std::uppercase << id;
+    return out.str();
+}
+
+std::string extract_call(const DbcSignal& signal) {
+    return absl::StrCat("can_bits::", signal.little_endian ? "extract_intel<" : "extract_motorola<",
+                        signal.start_bit, ", ", signal.length, ">(data)");
+}
+
+std::string physical_expression(const DbcSignal& signal) {
+    std::string raw = extract_call(signal);
+    std::string value = signal.is_signed
+        ? absl::StrCat("static_cast<double>(can_bits::sign_extend<", signal.length, ">(", raw, "))")
+        : absl::StrCat("static_cast<double>(", raw, ")");
+    if (signal.factor != 1.0) {
+        value = absl::StrCat(value, " * ", double_literal(signal.factor));
+    }
+    if (signal.offset > 0.0) {
+        value = absl::StrCat(value, " + ", double_literal(signal.offset));
+    } else if (signal.offset < 0.0) {
+        value = absl::StrCat(value, " - ", double_literal(-signal.offset));
+    }
+    return value;
+}
+
+std::string function_name(const DbcMessage& message) {
+    return absl::StrCat("decode_", message.extended ? "x" : "", hex_id(message.id));
+}
+
+struct MappedMessage {
+    const DbcMessage* message;
+    std::vector<std::pair<const DbcSignal*, size_t>> signals;  // signal, signal ID
+};
+
+}  // namespace
+
+absl::StatusOr<std::string> generate_decoders(const DbcDatabase& db,
+                                              const std::set<std::string>& mapped_signals,
+                                              const std::string& source_description) {
+    // Group mapped signals by message, keeping DBC order for stable output
+    std::vector<std::string> signal_names;
+    std::vector<uint32_t> signal_messages;
+    std::map<const DbcMessage*, MappedMessage> by_message;
+    std::set<std::string> found;
+
+    for (const auto& message : db.messages) {
+        for (const auto& signal : message.signals) {
+            if (!mapped_signals.count(signal.name) || found.count(signal.name)) {
+                continue;
+            }
+            found.insert(signal.name);
+            auto& entry = by_message[&message];
+            entry.message = &message;
+            entry.signals.emplace_back(&signal, signal_names.size());
+            signal_names.push_back(signal.name);
+            signal_messages.push_back(message.id | (message.extended ? kExtendedIdFlag : 0));
+        }
+    }
+
+    for (const auto& name : mapped_signals) {
+        if (!found.count(name)) {
+            return absl::NotFoundError(absl::StrCat("Mapped signal '", name, "' not found in DBC"));
+        }
+    }
+
+    std::vector<const MappedMessage*> messages;
+    for (const auto& message : db.messages) {
+        if (auto it = by_message.find(&message); it != by_message.end()) {
+            messages.push_back(&it->second);
+        }
+    }
+
+    std::ostringstream out;
+    out << "// Generated by can2vss-codegen from " << source_description << ". Do not edit.\n"
+        << "\n"
+        << "#pragma once\n"
+        << "\n"
+        << "#include \"can_bits.h\"\n"
+        << "\n"
+        << "#include <array>\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n"
+        << "#include <string_view>\n"
+        << "\n"
+        << "namespace can2vss::generated {\n"
+        << "\n"
+        << "inline constexpr size_t kSignalCount = " << signal_names.size() << ";\n"
+        << "\n"
+        << "inline constexpr std::array<std::string_view, kSignalCount> kSignalNames = {\n";
+    for (const auto& name : signal_names) {
+        out << "    \"" << name << "\",\n";
+    }
+    out << "};\n\n";
+
+    // Lets the CAN source filter by signal, e.g. for demand-driven decoding
+    out << "// CAN ID of each signal's message; extended IDs have bit 31 set\n"
+        << "inline constexpr std::array<uint32_t, kSignalCount> kSignalMessageIds = {";
+    for (size_t i = 0; i < signal_messages.size(); ++i) {
+        out << (i ? ", " : "") << hex_id(signal_messages[i]);
+    }
+    out << "};\n\n";
+
+    std::vector<uint32_t> standard_ids;
+    std::vector<uint32_t> extended_ids;
+    for (const auto* mapped : messages) {
+        (mapped->message->extended ? extended_ids : standard_ids).push_back(mapped->message->id);
+    }
+    auto emit_ids = [&](const char* name, const std::vector<uint32_t>& ids) {
+        out << "inline constexpr std::array<uint32_t, " << ids.size() << "> " << name << " = {";
+        for (size_t i = 0; i < ids.size(); ++i) {
+            out << (i ? ", " : "") << hex_id(ids[i]);
+        }
+        out << "};\n";
+    };
+    emit_ids("kCanIds", standard_ids);
+    emit_ids("kExtendedIds", extended_ids);
+    out << "\n";
+
+    for (const auto* mapped : messages) {
+        const DbcMessage& message = *mapped->message;
+        out << "// " << message.name << " (" << hex_id(message.id) << ", dlc " << message.dlc << ")\n"
+            << "template <typename Sink>\n"
+            << "inline void " << function_name(message) << "(const uint8_t* data, Sink& sink) {\n";
+
+        bool needs_mux = false;
+        for (const auto& [signal, id] : mapped->signals) {
+            needs_mux |= signal->multiplex == DbcSignal::Multiplex::MULTIPLEXED;
+        }
+        if (needs_mux) {
+            const DbcSignal* mux = message.multiplexor();
+            if (mux == nullptr) {
+                return absl::InvalidArgumentError(
+                    absl::StrCat("Message ", message.name, " has multiplexed signals but no multiplexor"));
+            }
+            out << "    const uint64_t mux = " << extract_call(*mux) << ";\n";
+        }
+
+        for (const auto& [signal, id] : mapped->signals) {
+            out << "    // " << signal->name << ": " << signal->start_bit << "|" << signal->length << "@"
+                << (signal->little_endian ? 1 : 0) << (signal->is_signed ? "-" : "+") << " ("
+                << double_literal(signal->factor) << "," << double_literal(signal->offset) << ")"
+                << (signal->unit.empty() ? "" : " " + signal->unit) << "\n";
+            if (signal->multiplex == DbcSignal::Multiplex::MULTIPLEXED) {
+                out << "    if (mux == " << signal->mux_value << ") {\n"
+                    << "        sink(" << id << ", " << physical_expression(*signal) << ");\n"
+                    << "    }\n";
+            } else {
+                out << "    sink(" << id << ", " << physical_expression(*signal) << ");\n";
+            }
+        }
+        out << "}\n\n";
+    }
+
+    auto emit_dispatch = [&](const char* name, bool extended) {
+        out << "template <typename Sink>\n"
+            << "inline bool " << name << "(uint32_t can_id, const uint8_t* data, uint8_t dlc, Sink&& sink) {\n";
+        bool any = false;
+        for (const auto* mapped : messages) {
+            any |= mapped->message->extended == extended;
+        }
+        if (!any) {
+            out << "    (void)data;\n"
+                << "    (void)dlc;\n"
+                << "    (void)sink;\n";
+        }
+        out << "    switch (can_id) {\n";
+        for (const auto* mapped : messages) {
+            const DbcMessage& message = *mapped->message;
+            if (message.extended != extended) {
+                continue;
+            }
+            out << "        case " << hex_id(message.id) << ":\n"
+                << "            if (dlc < " << message.dlc << ") {\n"
+                << "                return false;\n"
+                << "            }\n"
+                << "            " << function_name(message) << "(data, sink);\n"
+                << "            return true;\n";
+        }
+        out << "        default:\n"
+            << "            return false;\n"
+            << "    }\n"
+            << "}\n\n";
+    };
+
+    out << "/// Decodes a standard-ID frame; data must hold 8 bytes (zero-padded)\n";
+    emit_dispatch("decode_frame", false);
+    out << "/// Decodes an extended-ID frame; data must hold 8 bytes (zero-padded)\n";
+    emit_dispatch("decode_extended_frame", true);
+
+    out << "}  // namespace can2vss::generated\n";
+    return out.str();
+}
+
+}  // namespace can2vss
@@ -0,0 +1,39 @@
+/**
+ * @file decoder_codegen.h
+ * @brief Generates specialized C++ decoders for the mapped signals of a DBC
+ */
+
+#pragma once
+
+#include "dbc_parser.h"
+
+#include <absl/status/statusor.h>
+
+#include <set>
+#include <string>
+
+namespace can2vss {
+
+/**
+ * @brief Emits a header with one decode function per mapped message
+ *
+ * The header defines, in namespace can2vss::generated:
+ * - kSignalNames: mapped DBC signal names, indexed by signal ID
+ * - kCanIds / kExtendedIds: message IDs to install as kernel CAN filters
+ * - decode_frame(can_id, data, dlc, sink): a switch over CAN IDs calling
+ *   sink(signal_id, physical_value) for each mapped signal in the frame
+ *
+ * Signal layouts, scaling and multiplexor values are compile-time
+ * constants, so the compiler can fold each decoder to loads, shifts and
+ * multiplies.
+ *
+ * @param db Parsed DBC
+ * @param mapped_signals DBC signal names referenced by the mapping
+ * @param source_description Provenance recorded in the header comment
+ * @return Header source, or an error if a mapped signal is not in the DBC
+ */
+absl::StatusOr<std::string> generate_decoders(const DbcDatabase& db,
+                                              const std::set<std::string>& mapped_signals,
+                                              const std::string& source_description);
+
+}  // namespace can2vss
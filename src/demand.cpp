@@ -0,0 +1,201 @@
+/**
+ * @file demand.cpp
+ * @brief Demand-driven decoding: which mapped signals anyone consumes
+ */
+
+#include "demand.h"
+
+#include <glog/logging.h>
+#include <sys/stat.h>
+
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace can2vss {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    const auto begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    const auto end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+}  // namespace
+
+std::vector<std::string> parse_demand(std::string_view text) {
+    std::vector<std::string> patterns;
+    while (!text.empty()) {
+        const auto newline = text.find('\n');
+        auto line = trim(text.substr(0, newline));
+        text = newline == std::string_view::npos ? std::string_view{} : text.substr(newline + 1);
+        if (!line.empty() && line.front() != '#') {
+            patterns.emplace_back(line);
+        }
+    }
+    return patterns;
+}
+
+bool is_demanded(std::string_view path, const std::vector<std::string>& patterns) {
+    for (const auto& pattern : patterns) {
+        if (path.size() >= pattern.size() && path.compare(0, pattern.size(), pattern) == 0 &&
+            (path.size() == pattern.size() || path[pattern.size()] == '.')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+DemandPlan plan_demand(const std::vector<DemandSignal>& signals, const std::vector<std::string>& patterns) {
+    std::unordered_map<std::string_view, size_t> index;
+    for (size_t i = 0; i < signals.size(); ++i) {
+        index.emplace(signals[i].name, i);
+    }
+
+    DemandPlan plan;
+    plan.published.assign(signals.size(), false);
+    plan.active.assign(signals.size(), false);
+
+    // Walk upstream from every demanded signal
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < signals.size(); ++i) {
+        if (is_demanded(signals[i].name, patterns)) {
+            plan.published[i] = true;
+            ++plan.published_count;
+            pending.push_back(i);
+        }
+    }
+    while (!pending.empty()) {
+        const size_t i = pending.back();
+        pending.pop_back();
+        if (plan.active[i]) {
+            continue;
+        }
+        plan.active[i] = true;
+        ++plan.active_count;
+        if (!signals[i].can_signal.empty()) {
+            plan.can_signals.insert(signals[i].can_signal);
+        }
+        for (const auto& dep : signals[i].depends_on) {
+            if (auto it = index.find(dep); it != index.end() && !plan.active[it->second]) {
+                pending.push_back(it->second);
+            }
+        }
+    }
+    return plan;
+}
+
+bool DemandFile::reload_if_changed() {
+    struct stat info {};
+    const bool exists = stat(path_.c_str(), &info) == 0;
+    if (loaded_ && exists == exists_ &&
+        (!exists || (info.st_mtim.tv_sec == modified_.tv_sec && info.st_mtim.tv_nsec == modified_.tv_nsec))) {
+        return false;
+    }
+
+    loaded_ = true;
+    exists_ = exists;
+    patterns_.clear();
+    if (!exists) {
+        modified_ = {};
+        return true;
+    }
+    modified_ = info.st_mtim;
+    std::ifstream file(path_);
+    std::stringstream text;
+    text << file.rdbuf();
+    patterns_ = parse_demand(text.str());
+    return true;
+}
+
+DemandWatcher::DemandWatcher(std::string path, std::vector<DemandSignal> signals,
+                             std::chrono::milliseconds interval, Listener listener)
+    : file_(std::move(path)), signals_(std::move(signals)), interval_(interval), listener_(std::move(listener)) {
+    std::unordered_set<std::string_view> can_signals;
+    for (const auto& signal : signals_) {
+        if (!signal.can_signal.empty()) {
+            can_signals.insert(signal.can_signal);
+        }
+    }
+    can_signal_count_ = can_signals.size();
+}
+
+DemandWatcher::~DemandWatcher() {
+    stop();
+    delete pending_.exchange(nullptr, std::memory_order_acq_rel);
+    free_retired();
+}
+
+bool DemandWatcher::check() {
+    free_retired();
+    if (!file_.reload_if_changed()) {
+        return false;
+    }
+
+    auto update = std::make_unique<DemandUpdate>();
+    update->everything = !file_.exists();
+    update->plan = plan_demand(signals_, file_.patterns());
+    const size_t total = signals_.size();
+    if (update->everything) {
+        LOG(INFO) << "Demand file " << file_.path() << " not found, all " << total
+                  << " signals are decoded and published";
+    } else {
+        LOG(INFO) << "Demand: publishing " << update->plan.published_count << " of " << total << " signals, "
+                  << update->plan.active_count << " active, " << update->plan.can_signals.size() << " of "
+                  << can_signal_count_ << " CAN signals decoded";
+    }
+    if (listener_) {
+        listener_(*update);
+    }
+    // A plan the loop has not taken yet is superseded
+    delete pending_.exchange(update.release(), std::memory_order_acq_rel);
+    return true;
+}
+
+void DemandWatcher::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&DemandWatcher::run, this);
+}
+
+void DemandWatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void DemandWatcher::retire(std::unique_ptr<DemandUpdate> update) {
+    // Normally empty: the watcher frees the slot before every new plan, and
+    // the loop retires one plan per plan it takes
+    delete retired_.exchange(update.release(), std::memory_order_acq_rel);
+}
+
+void DemandWatcher::free_retired() {
+    delete retired_.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+void DemandWatcher::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, interval_, [this] { return !running_; })) {
+        lock.unlock();
+        check();
+        lock.lock();
+    }
+}
+
+}  // namespace can2vss
@@ -0,0 +1,165 @@
+/**
+ * @file demand.h
+ * @brief Demand-driven decoding: which mapped signals anyone consumes
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief What the demand planner needs to know about one mapped VSS signal
+ */
+struct DemandSignal {
+    std::string name;        ///< VSS path
+    std::string can_signal;  ///< DBC signal it is decoded from, empty if derived
+    std::vector<std::string> depends_on;
+};
+
+/**
+ * @brief Which part of the mapping has to run for the current demand
+ */
+struct DemandPlan {
+    std::vector<bool> published;  ///< Per input signal: demanded, so published
+    std::vector<bool> active;     ///< Per input signal: demanded or upstream of a demanded signal
+    std::unordered_set<std::string> can_signals;  ///< DBC signals of active signals
+    size_t published_count = 0;
+    size_t active_count = 0;
+};
+
+/**
+ * @brief Parses a demand list: one VSS path or branch per line
+ *
+ * Blank lines and lines starting with '#' are ignored; surrounding
+ * whitespace is trimmed.
+ */
+std::vector<std::string> parse_demand(std::string_view text);
+
+/// @return true if path is one of the patterns or lies in a branch one of them names
+bool is_demanded(std::string_view path, const std::vector<std::string>& patterns);
+
+/**
+ * @brief Marks the demanded signals and everything they depend on
+ *
+ * A signal is published if it is demanded. It is active, i.e. decoded and
+ * evaluated, if it is demanded or a demanded signal depends on it, directly
+ * or through other signals. Upstream signals used only by undemanded
+ * signals are inactive.
+ */
+DemandPlan plan_demand(const std::vector<DemandSignal>& signals, const std::vector<std::string>& patterns);
+
+/**
+ * @brief A demand list file, written by whatever knows the consumers
+ *
+ * A missing file means everything is demanded, so the feeder behaves as
+ * without demand-driven decoding until a consumer list exists.
+ */
+class DemandFile {
+public:
+    explicit DemandFile(std::string path) : path_(std::move(path)) {}
+
+    /**
+     * @brief Re-reads the file if it appeared, disappeared or was modified
+     * @return true if the demand may have changed since the last call
+     */
+    bool reload_if_changed();
+
+    /// False while the file is missing: then everything is demanded
+    bool exists() const { return exists_; }
+
+    const std::vector<std::string>& patterns() const { return patterns_; }
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    bool loaded_ = false;
+    bool exists_ = false;
+    timespec modified_{};
+    std::vector<std::string> patterns_;
+};
+
+/**
+ * @brief A demand plan ready to apply, as handed over by DemandWatcher
+ */
+struct DemandUpdate {
+    bool everything = true;  ///< The demand file is missing: everything is demanded
+    DemandPlan plan;
+};
+
+/**
+ * @brief Watches a DemandFile and plans the demand on its own thread
+ *
+ * The file is checked once per interval; stat(), reading, parsing, planning
+ * and logging all happen on the watcher thread. A new plan is handed to the
+ * loop through an atomic pointer swap: take() never blocks, allocates or
+ * enters the kernel. A plan the loop has replaced goes back through retire()
+ * and is freed on the watcher thread too.
+ */
+class DemandWatcher {
+public:
+    /// Called on the watcher thread with every new plan, before the loop can take it
+    using Listener = std::function<void(const DemandUpdate&)>;
+
+    DemandWatcher(std::string path, std::vector<DemandSignal> signals,
+                  std::chrono::milliseconds interval = std::chrono::seconds(1), Listener listener = {});
+    ~DemandWatcher();
+
+    DemandWatcher(const DemandWatcher&) = delete;
+    DemandWatcher& operator=(const DemandWatcher&) = delete;
+
+    /**
+     * @brief Checks the file once on the calling thread
+     *
+     * Used before start() so the first plan is ready before the loop runs.
+     * @return true if a new plan is waiting for take()
+     */
+    bool check();
+
+    void start();
+    void stop();
+
+    /// The newest plan not taken yet, or null; lock-free and allocation free
+    std::unique_ptr<DemandUpdate> take() {
+        return std::unique_ptr<DemandUpdate>(pending_.exchange(nullptr, std::memory_order_acq_rel));
+    }
+
+    /// Hands back a plan the loop no longer uses, to be freed off the loop thread
+    void retire(std::unique_ptr<DemandUpdate> update);
+
+    const std::vector<DemandSignal>& signals() const { return signals_; }
+    const std::string& path() const { return file_.path(); }
+
+private:
+    void run();
+    void free_retired();
+
+    DemandFile file_;
+    std::vector<DemandSignal> signals_;
+    size_t can_signal_count_ = 0;
+    std::chrono::milliseconds interval_;
+    Listener listener_;
+
+    std::atomic<DemandUpdate*> pending_{nullptr};
+    std::atomic<DemandUpdate*> retired_{nullptr};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_ = false;
+    std::thread thread_;
+};
+
+}  // namespace can2vss
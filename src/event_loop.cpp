@@ -0,0 +1,138 @@
+/**
+ * @file event_loop.cpp
+ * @brief Single-threaded epoll executor for C++20 coroutines
+ */
+
+#include "event_loop.h"
+
+#include <glog/logging.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace can2vss {
+
+namespace {
+
+constexpr int kMaxEvents = 16;
+
+}  // namespace
+
+EventLoop::~EventLoop() {
+    // Coroutines still suspended here never resume; free their frames
+    while (!timers_.empty()) {
+        timers_.top().handle.destroy();
+        timers_.pop();
+    }
+    for (auto& [fd, handle] : readers_) {
+        handle.destroy();
+    }
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+    }
+    if (event_fd_ >= 0) {
+        close(event_fd_);
+    }
+}
+
+bool EventLoop::initialize() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        LOG(ERROR) << "epoll_create1 failed: " << std::strerror(errno);
+        return false;
+    }
+    event_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (event_fd_ < 0) {
+        LOG(ERROR) << "eventfd failed: " << std::strerror(errno);
+        return false;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = event_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &event) != 0) {
+        LOG(ERROR) << "epoll_ctl failed: " << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void EventLoop::stop() {
+    stopped_.store(true);
+    if (event_fd_ >= 0) {
+        uint64_t one = 1;
+        [[maybe_unused]] auto n = write(event_fd_, &one, sizeof(one));
+    }
+}
+
+void EventLoop::add_timer(Clock::time_point deadline, std::coroutine_handle<> handle) {
+    timers_.push({deadline, timer_sequence_++, handle});
+}
+
+void EventLoop::add_reader(int fd, std::coroutine_handle<> handle) {
+    // One-shot, so a ready fd does not wake the loop again until its
+    // coroutine has read it and awaits again
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.fd = fd;
+    const bool added = registered_.insert(fd).second;
+    if (epoll_ctl(epoll_fd_, added ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event) != 0) {
+        LOG(ERROR) << "epoll_ctl on fd " << fd << " failed: " << std::strerror(errno);
+    }
+    readers_[fd] = handle;
+}
+
+int EventLoop::next_timeout_ms() const {
+    if (timers_.empty()) {
+        return -1;
+    }
+    auto wait = timers_.top().deadline - Clock::now();
+    if (wait <= Clock::duration::zero()) {
+        return 0;
+    }
+    // Round up: waking early would only spin until the deadline
+    return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(wait).count());
+}
+
+void EventLoop::run() {
+    epoll_event events[kMaxEvents];
+    while (!stopped_.load(std::memory_order_relaxed)) {
+        const int count = epoll_wait(epoll_fd_, events, kMaxEvents, next_timeout_ms());
+        if (count < 0 && errno != EINTR) {
+            LOG(ERROR) << "epoll_wait failed: " << std::strerror(errno);
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == event_fd_) {
+                uint64_t value = 0;
+                [[maybe_unused]] auto n = read(event_fd_, &value, sizeof(value));
+                continue;
+            }
+            auto it = readers_.find(fd);
+            if (it == readers_.end()) {
+                continue;
+            }
+            auto handle = it->second;
+            readers_.erase(it);
+            handle.resume();
+        }
+
+        // Resume only timers due now; ones added while resuming wait for the next round
+        const auto now = Clock::now();
+        due_.clear();
+        while (!timers_.empty() && timers_.top().deadline <= now) {
+            due_.push_back(timers_.top().handle);
+            timers_.pop();
+        }
+        for (auto handle : due_) {
+            handle.resume();
+        }
+    }
+}
+
+}  // namespace can2vss
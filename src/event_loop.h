@@ -0,0 +1,145 @@
+/**
+ * @file event_loop.h
+ * @brief Single-threaded epoll executor for C++20 coroutines
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief Detached coroutine started by calling it
+ *
+ * A Task runs on the calling thread up to its first co_await and is resumed
+ * by its EventLoop from then on. Nobody awaits its result; the frame frees
+ * itself when the coroutine returns, or is destroyed with the loop if it is
+ * still suspended then.
+ */
+struct Task {
+    struct promise_type {
+        Task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+/**
+ * @brief Resumes coroutines when their timer expires or their fd becomes readable
+ *
+ * All coroutines of one loop run on the thread that calls run(), one at a
+ * time, so they share state without locks. A coroutine must never block: it
+ * co_awaits sleep_until()/sleep_for() or readable() instead, and the loop
+ * sleeps in epoll_wait() until the earliest of those is due.
+ *
+ * @code
+ * EventLoop loop;
+ * loop.initialize();
+ * auto ticker = [&]() -> Task {
+ *     for (;;) {
+ *         co_await loop.sleep_for(std::chrono::milliseconds(50));
+ *         tick();
+ *     }
+ * };
+ * ticker();
+ * loop.run();  // until loop.stop()
+ * @endcode
+ */
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    EventLoop() = default;
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /// Creates the epoll instance and the stop eventfd; @return false if either fails
+    bool initialize();
+
+    /// Runs coroutines until stop() is called
+    void run();
+
+    /// Makes run() return; callable from any thread and async-signal-safe
+    void stop();
+
+    /// File descriptor written by stop(), for use from a signal handler
+    int wake_fd() const { return event_fd_; }
+
+    struct TimerAwaiter {
+        EventLoop& loop;
+        Clock::time_point deadline;
+
+        // Always suspends, even past the deadline, so a coroutine that fell
+        // behind resumes from the loop and cannot starve fds and other timers
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { loop.add_timer(deadline, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    struct ReadableAwaiter {
+        EventLoop& loop;
+        int fd;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { loop.add_reader(fd, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    /// Suspends the awaiting coroutine until deadline; a past deadline resumes it on the next loop round
+    TimerAwaiter sleep_until(Clock::time_point deadline) { return {*this, deadline}; }
+
+    /// Suspends the awaiting coroutine for duration
+    TimerAwaiter sleep_for(Clock::duration duration) { return {*this, Clock::now() + duration}; }
+
+    /**
+     * @brief Suspends the awaiting coroutine until fd has data to read
+     *
+     * Level-triggered: resumes immediately if data is already queued. At most
+     * one coroutine may wait on an fd at a time.
+     */
+    ReadableAwaiter readable(int fd) { return {*this, fd}; }
+
+    /// Coroutines currently suspended on a timer or an fd
+    size_t pending() const { return timers_.size() + readers_.size(); }
+
+private:
+    struct Timer {
+        Clock::time_point deadline;
+        uint64_t sequence;  // keeps timers with equal deadlines in FIFO order
+        std::coroutine_handle<> handle;
+
+        bool operator>(const Timer& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    void add_timer(Clock::time_point deadline, std::coroutine_handle<> handle);
+    void add_reader(int fd, std::coroutine_handle<> handle);
+    int next_timeout_ms() const;
+
+    int epoll_fd_ = -1;
+    int event_fd_ = -1;
+    std::atomic<bool> stopped_{false};
+
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+    uint64_t timer_sequence_ = 0;
+    std::unordered_map<int, std::coroutine_handle<>> readers_;
+    std::unordered_set<int> registered_;  // fds known to epoll
+    std::vector<std::coroutine_handle<>> due_;
+};
+
+}  // namespace can2vss
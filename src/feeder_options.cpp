@@ -0,0 +1,163 @@
+/**
+ * @file feeder_options.cpp
+ * @brief Command line parsing for can2vss-feeder
+ */
+
+#include "feeder_options.h"
+
+#include <charconv>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace can2vss {
+
+namespace {
+
+bool parse_int(std::string_view text, int& out) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc() && ptr == text.data() + text.size();
+}
+
+// Splits "--name=value" into name and value; value is empty if absent
+std::pair<std::string_view, std::string_view> split_option(std::string_view arg) {
+    auto eq = arg.find('=');
+    if (eq == std::string_view::npos) {
+        return {arg, {}};
+    }
+    return {arg.substr(0, eq), arg.substr(eq + 1)};
+}
+
+}  // namespace
+
+std::optional<FeederOptions> parse_options(int argc, char* argv[]) {
+    FeederOptions options;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            positional.emplace_back(arg);
+            continue;
+        }
+
+        auto [name, value] = split_option(arg);
+        if (name == "--low-latency") {
+            options.low_latency.enabled = true;
+        } else if (name == "--rx-cpu") {
+            if (!parse_int(value, options.low_latency.rx_cpu) || options.low_latency.rx_cpu < 0) {
+                std::cerr << "Invalid value for --rx-cpu: '" << value << "'\n";
+                return std::nullopt;
+            }
+        } else if (name == "--rt-priority") {
+            if (!parse_int(value, options.low_latency.rt_priority) ||
+                options.low_latency.rt_priority < 1 || options.low_latency.rt_priority > 99) {
+                std::cerr << "Invalid value for --rt-priority (expected 1-99): '" << value << "'\n";
+                return std::nullopt;
+            }
+        } else if (name == "--no-mlock") {
+            options.low_latency.lock_memory = false;
+        } else if (name == "--rt-safe") {
+            options.rt_safe = true;
+        } else if (name == "--adaptive-poll") {
+            options.adaptive_poll = true;
+        } else if (name == "--async") {
+            options.async = true;
+        } else if (name == "--idle-after") {
+            if (!parse_int(value, options.idle_after_s) || options.idle_after_s < 0) {
+                std::cerr << "Invalid value for --idle-after: '" << value << "'\n";
+                return std::nullopt;
+            }
+        } else if (name == "--metrics-interval") {
+            if (!parse_int(value, options.metrics_interval_s) || options.metrics_interval_s < 0) {
+                std::cerr << "Invalid value for --metrics-interval: '" << value << "'\n";
+                return std::nullopt;
+            }
+        } else if (name == "--shard") {
+            auto slash = value.find('/');
+            if (slash == std::string_view::npos || !parse_int(value.substr(0, slash), options.shard_index) ||
+                !parse_int(value.substr(slash + 1), options.shard_count) || options.shard_count < 1 ||
+                options.shard_index < 0 || options.shard_index >= options.shard_count) {
+                std::cerr << "Invalid value for --shard (expected I/N with 0 <= I < N): '" << value << "'\n";
+                return std::nullopt;
+            }
+        } else if (name == "--shards") {
+            if (!parse_int(value, options.spawn_shards) || options.spawn_shards < 2) {
+                std::cerr << "Invalid value for --shards (expected 2 or more): '" << value << "'\n";
+                return std::nullopt;
+            }
+        } else if (name == "--lazy-dbc") {
+            options.lazy_dbc = true;
+        } else if (name == "--demand-file") {
+            if (value.empty()) {
+                std::cerr << "--demand-file needs a file name\n";
+                return std::nullopt;
+            }
+            options.demand_file = value;
+        } else if (name == "--publish-channels") {
+            if (!parse_int(value, options.publish_channels) || options.publish_channels < 1 ||
+                options.publish_channels > 16) {
+                std::cerr << "Invalid value for --publish-channels (expected 1-16): '" << value << "'\n";
+                return std::nullopt;
+            }
+        } else if (name == "--publish-drop") {
+            options.publish_drop = true;
+        } else if (name == "--memory-budget") {
+            if (!parse_int(value, options.memory_budget_mb) || options.memory_budget_mb < 1) {
+                std::cerr << "Invalid value for --memory-budget (expected MiB): '" << value << "'\n";
+                return std::nullopt;
+            }
+        } else if (name == "--profile") {
+            options.profile = true;
+            if (!value.empty()) {
+                options.profile_trace = value;
+            }
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return std::nullopt;
+        }
+    }
+
+    if (positional.size() != 4) {
+        return std::nullopt;
+    }
+
+    options.dbc_file = positional[0];
+    options.yaml_file = positional[1];
+    options.can_interface = positional[2];
+    options.kuksa_address = positional[3];
+    return options;
+}
+
+void print_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name
+              << " [options] <dbc_file> <mapping_yaml_file> <can_interface> <kuksa_address>\n";
+    std::cout << "Example: " << program_name
+              << " vehicle.dbc mappings.yaml can0 127.0.0.1:55555\n";
+    std::cout << "\nOptions:\n"
+              << "  --low-latency       Busy-poll the CAN source instead of sleeping between polls\n"
+              << "  --rx-cpu=N          Pin the RX thread to CPU N (use with an isolated core)\n"
+              << "  --rt-priority=N     Run the RX thread with SCHED_FIFO priority N (1-99)\n"
+              << "  --no-mlock          Do not lock process memory in low-latency mode\n"
+              << "  --rt-safe           Defer log formatting to a helper thread so the loop\n"
+              << "                      thread does not allocate, lock or format logs\n"
+              << "  --adaptive-poll     Adapt the poll wait to traffic and publish latency\n"
+              << "  --async             Wait for CAN socket readiness and timers on an event loop\n"
+              << "                      instead of polling\n"
+              << "  --idle-after=S      Sleep until CAN traffic resumes after S seconds of bus silence\n"
+              << "  --metrics-interval=S  Log feeder metrics every S seconds (default: on exit only)\n"
+              << "  --profile[=FILE]    Time loop stages, print a breakdown on exit and write a\n"
+              << "                      Chrome trace to FILE (default: can2vss-profile.json)\n"
+              << "  --shards=N          Split the mapping across N feeder processes\n"
+              << "  --shard=I/N         Run only shard I of N (started by --shards, or by hand)\n"
+              << "  --lazy-dbc          Load only the DBC messages that hold mapped signals\n"
+              << "  --demand-file=FILE  Decode and publish only the VSS paths listed in FILE and\n"
+              << "                      what they depend on; FILE is re-read when it changes\n"
+              << "  --publish-channels=N  Spread normal and bulk publishing over N gRPC channels\n"
+              << "  --publish-drop      Drop values when a publish queue is full instead of waiting\n"
+              << "                      for room (always on with --rt-safe)\n"
+              << "  --memory-budget=MB  Shrink queues and buffers to keep the process within MB MiB;\n"
+              << "                      refuse to start if the configuration does not fit\n";
+}
+
+}  // namespace can2vss
@@ -0,0 +1,94 @@
+/**
+ * @file feeder_options.h
+ * @brief Command line options for can2vss-feeder
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace can2vss {
+
+/**
+ * @brief Settings for the busy-poll low-latency RX mode
+ */
+struct LowLatencyOptions {
+    bool enabled = false;
+    int rx_cpu = -1;          // CPU to pin the RX thread to (-1 = no pinning)
+    int rt_priority = 0;      // SCHED_FIFO priority (0 = keep default scheduler)
+    bool lock_memory = true;  // mlockall() current and future pages
+};
+
+/**
+ * @brief Parsed command line of the feeder
+ */
+struct FeederOptions {
+    std::string dbc_file;
+    std::string yaml_file;
+    std::string can_interface;
+    std::string kuksa_address;
+
+    LowLatencyOptions low_latency;
+
+    // Keep log formatting and allocation off the loop thread
+    bool rt_safe = false;
+
+    // Adapt the loop's wait to arrival rate and publish latency
+    bool adaptive_poll = false;
+
+    // Run the sources and periodic DAG evaluation as coroutines that await
+    // socket readiness and timers instead of polling
+    bool async = false;
+
+    // Seconds between metrics log lines (0 = only on shutdown)
+    int metrics_interval_s = 0;
+
+    // Seconds of bus silence before the feeder sleeps until traffic resumes
+    // (0 = never)
+    int idle_after_s = 0;
+
+    // Time each loop stage, report on exit and write a Chrome trace
+    bool profile = false;
+    std::string profile_trace = "can2vss-profile.json";
+
+    // Hand the CAN source a DBC reduced to the messages the mapping uses
+    bool lazy_dbc = false;
+
+    // This process runs shard shard_index of shard_count, each owning part
+    // of the mapping and its CAN messages
+    int shard_index = 0;
+    int shard_count = 1;
+
+    // Start this many shard processes and supervise them (0 = run in-process)
+    int spawn_shards = 0;
+
+    // File listing the VSS paths or branches that have consumers; only
+    // those and what they depend on are decoded, evaluated and published
+    std::string demand_file;
+
+    // Main publish lanes, each with its own KUKSA client and gRPC channel
+    int publish_channels = 1;
+
+    // Drop values when a publish queue is full instead of holding the loop
+    // until the lane has room (implied by --rt-safe)
+    bool publish_drop = false;
+
+    // Process memory limit in MiB that preallocated buffers are sized to fit
+    // (0 = no limit)
+    int memory_budget_mb = 0;
+};
+
+/**
+ * @brief Parses argv into FeederOptions
+ *
+ * Options start with "--" and may appear anywhere; the remaining arguments
+ * are the four positional arguments.
+ *
+ * @return Parsed options, or std::nullopt if the command line is invalid
+ */
+std::optional<FeederOptions> parse_options(int argc, char* argv[]);
+
+void print_usage(const char* program_name);
+
+}  // namespace can2vss
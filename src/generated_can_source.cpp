@@ -0,0 +1,228 @@
+/**
+ * @file generated_can_source.cpp
+ * @brief CAN signal source using decoders generated at build time
+ */
+
+#include "generated_can_source.h"
+
+#include "can2vss_generated_decoders.h"
+
+#include <glog/logging.h>
+
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <set>
+
+namespace can2vss {
+
+namespace {
+
+constexpr size_t kBatchFrames = 64;
+static_assert(GeneratedCANSource::kMaxPollFrames % kBatchFrames == 0);
+
+}  // namespace
+
+GeneratedCANSource::GeneratedCANSource(std::string interface,
+                                       const std::string& dbc_file,
+                                       const std::unordered_map<std::string, vssdag::SignalMapping>& mappings)
+    : interface_(std::move(interface)), dbc_file_(dbc_file) {
+    for (const auto& [signal_name, mapping] : mappings) {
+        if ((mapping.source.type == "dbc" || mapping.source.type == "can") && !mapping.source.name.empty()) {
+            mapped_sources_.push_back(mapping.source.name);
+        }
+    }
+    for (auto name : generated::kSignalNames) {
+        signal_names_.emplace_back(name);
+    }
+
+    // A frame yields at most the signals of its message
+    std::vector<uint32_t> message_ids(generated::kSignalMessageIds.begin(), generated::kSignalMessageIds.end());
+    std::sort(message_ids.begin(), message_ids.end());
+    size_t widest = 0;
+    for (auto it = message_ids.begin(); it != message_ids.end();) {
+        auto end = std::upper_bound(it, message_ids.end(), *it);
+        widest = std::max<size_t>(widest, static_cast<size_t>(end - it));
+        it = end;
+    }
+    max_poll_signals_ = kMaxPollFrames * widest;
+}
+
+GeneratedCANSource::~GeneratedCANSource() {
+    stop();
+}
+
+bool GeneratedCANSource::initialize() {
+    LOG(INFO) << "Using " << generated::kSignalCount << " compiled-in CAN decoders ("
+              << dbc_file_ << " is not read)";
+
+    bool mismatch = false;
+    for (const auto& source : mapped_sources_) {
+        if (std::find(signal_names_.begin(), signal_names_.end(), source) == signal_names_.end()) {
+            LOG(ERROR) << "Mapped CAN signal " << source
+                       << " has no compiled-in decoder; rebuild can2vss-feeder-static for this mapping";
+            mismatch = true;
+        }
+    }
+    if (mismatch) {
+        return false;
+    }
+
+    fd_ = socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, CAN_RAW);
+    if (fd_ < 0) {
+        LOG(ERROR) << "Failed to open CAN socket: " << std::strerror(errno);
+        return false;
+    }
+
+    // Let the kernel drop every frame we have no decoder for
+    std::vector<uint32_t> can_ids(generated::kCanIds.begin(), generated::kCanIds.end());
+    for (uint32_t id : generated::kExtendedIds) {
+        can_ids.push_back(id | CAN_EFF_FLAG);
+    }
+    if (!set_filters(can_ids)) {
+        return false;
+    }
+    if (busy_poll_.count() > 0) {
+        enable_busy_poll();
+    }
+
+    sockaddr_can addr{};
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = static_cast<int>(if_nametoindex(interface_.c_str()));
+    if (addr.can_ifindex == 0) {
+        LOG(ERROR) << "Unknown CAN interface " << interface_;
+        return false;
+    }
+    if (bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        LOG(ERROR) << "Failed to bind CAN socket to " << interface_ << ": " << std::strerror(errno);
+        return false;
+    }
+
+    LOG(INFO) << "CAN source listening on " << interface_ << " for "
+              << generated::kCanIds.size() + generated::kExtendedIds.size() << " message IDs";
+    return true;
+}
+
+void GeneratedCANSource::poll(std::vector<DecodedSignal>& decoded) {
+    decoded.clear();
+    if (fd_ < 0) {
+        return;
+    }
+
+    std::array<can_frame, kBatchFrames> frames;
+    std::array<iovec, kBatchFrames> iov;
+    std::array<mmsghdr, kBatchFrames> msgs{};
+    for (size_t i = 0; i < kBatchFrames; ++i) {
+        iov[i] = {&frames[i], sizeof(can_frame)};
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    auto sink = [&](size_t signal_id, double value) {
+        decoded.push_back({static_cast<uint32_t>(signal_id), value, now});
+    };
+
+    for (size_t read = 0; read < kMaxPollFrames; read += kBatchFrames) {
+        int n = recvmmsg(fd_, msgs.data(), kBatchFrames, MSG_DONTWAIT, nullptr);
+        if (n <= 0) {
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_EVERY_N(ERROR, 100) << "CAN read failed: " << std::strerror(errno);
+            }
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            const can_frame& frame = frames[i];
+            if (frame.can_id & CAN_EFF_FLAG) {
+                generated::decode_extended_frame(frame.can_id & CAN_EFF_MASK, frame.data, frame.can_dlc, sink);
+            } else {
+                generated::decode_frame(frame.can_id & CAN_SFF_MASK, frame.data, frame.can_dlc, sink);
+            }
+        }
+        if (static_cast<size_t>(n) < kBatchFrames) {
+            break;
+        }
+    }
+}
+
+std::vector<vssdag::SignalUpdate> GeneratedCANSource::poll() {
+    std::vector<DecodedSignal> decoded;
+    decoded.reserve(max_poll_signals_);
+    poll(decoded);
+
+    std::vector<vssdag::SignalUpdate> updates(decoded.size());
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        updates[i].signal_name = signal_names_[decoded[i].signal];
+        updates[i].value = decoded[i].value;
+        updates[i].timestamp = decoded[i].timestamp;
+    }
+    return updates;
+}
+
+void GeneratedCANSource::attach(int fd) {
+    stop();
+    fd_ = fd;
+}
+
+bool GeneratedCANSource::set_demanded_signals(const std::unordered_set<std::string>& signals) {
+    std::set<uint32_t> can_ids;
+    for (size_t id = 0; id < generated::kSignalCount; ++id) {
+        if (signals.count(signal_names_[id])) {
+            can_ids.insert(generated::kSignalMessageIds[id]);  // extended IDs carry CAN_EFF_FLAG
+        }
+    }
+    return set_filters(std::vector<uint32_t>(can_ids.begin(), can_ids.end()));
+}
+
+bool GeneratedCANSource::set_filters(const std::vector<uint32_t>& can_ids) {
+    // No filter at all means no frame is received
+    std::vector<can_filter> filters;
+    for (uint32_t id : can_ids) {
+        if (id & CAN_EFF_FLAG) {
+            filters.push_back({id, CAN_EFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG});
+        } else {
+            filters.push_back({id, CAN_SFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG});
+        }
+    }
+    if (setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(),
+                   static_cast<socklen_t>(filters.size() * sizeof(can_filter))) != 0) {
+        LOG(ERROR) << "Failed to set CAN filters: " << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void GeneratedCANSource::enable_busy_poll() {
+    const int budget = static_cast<int>(busy_poll_.count());
+    if (setsockopt(fd_, SOL_SOCKET, SO_BUSY_POLL, &budget, sizeof(budget)) != 0) {
+        LOG(WARNING) << "Failed to enable busy polling on " << interface_ << ": " << std::strerror(errno)
+                     << (errno == EPERM ? " (needs CAP_NET_ADMIN above net.core.busy_read)" : "");
+        return;
+    }
+#ifdef SO_PREFER_BUSY_POLL
+    // Also keeps the device from re-arming interrupts while we poll; older
+    // kernels do not know it
+    const int prefer = 1;
+    if (setsockopt(fd_, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer)) != 0) {
+        VLOG(1) << "SO_PREFER_BUSY_POLL not set on " << interface_ << ": " << std::strerror(errno);
+    }
+#endif
+    LOG(INFO) << "Busy polling " << interface_ << " for up to " << budget << " us per read";
+}
+
+void GeneratedCANSource::stop() {
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+}  // namespace can2vss
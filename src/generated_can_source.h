@@ -0,0 +1,116 @@
+/**
+ * @file generated_can_source.h
+ * @brief CAN signal source using decoders generated at build time
+ */
+
+#pragma once
+
+#include "vssdag/signal_processor.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief A decoded signal value, identified by its compiled-in signal ID
+ */
+struct DecodedSignal {
+    uint32_t signal = 0;
+    double value = 0.0;
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+/**
+ * @brief Drop-in replacement for vssdag::CANSignalSource in can2vss-feeder-static
+ *
+ * Reads raw frames from a SocketCAN socket whose kernel filter only admits
+ * the mapped message IDs, and decodes them with the constexpr-specialized
+ * functions generated by can2vss-codegen. The DBC is compiled in; the DBC
+ * path given on the command line is not read.
+ */
+class GeneratedCANSource {
+public:
+    GeneratedCANSource(std::string interface,
+                       const std::string& dbc_file,
+                       const std::unordered_map<std::string, vssdag::SignalMapping>& mappings);
+    ~GeneratedCANSource();
+
+    GeneratedCANSource(const GeneratedCANSource&) = delete;
+    GeneratedCANSource& operator=(const GeneratedCANSource&) = delete;
+
+    /**
+     * @brief Asks the kernel to busy-poll the socket for up to `budget` per read
+     *
+     * Call before initialize(). Set per socket with SO_BUSY_POLL, so it does
+     * not need the system-wide net.core.busy_read; a kernel that refuses it
+     * (EPERM without CAP_NET_ADMIN above net.core.busy_read) only costs a
+     * warning.
+     */
+    void set_busy_poll(std::chrono::microseconds budget) { busy_poll_ = budget; }
+
+    /// Checks the mapping against the compiled-in signals and opens the socket
+    bool initialize();
+
+    /**
+     * @brief Reads and decodes up to kMaxPollFrames queued frames into `decoded`
+     *
+     * `decoded` is cleared first and never grows beyond max_poll_signals(),
+     * so a buffer reserved for that many signals is reused without allocation.
+     * Frames beyond the limit stay queued for the next poll.
+     */
+    void poll(std::vector<DecodedSignal>& decoded);
+
+    /// As poll(decoded), as named signal updates for the generic loop paths
+    std::vector<vssdag::SignalUpdate> poll();
+
+    /// Most signals a single poll(decoded) produces
+    size_t max_poll_signals() const { return max_poll_signals_; }
+
+    /// Name of a compiled-in signal, by DecodedSignal::signal
+    const std::string& signal_name(uint32_t signal) const { return signal_names_[signal]; }
+
+    /**
+     * @brief Reads frames from an already open socket instead of a CAN interface
+     *
+     * For replaying recorded traffic, e.g. can_frame records written to a
+     * SOCK_SEQPACKET socket pair. Takes ownership of fd; no filter is set.
+     */
+    void attach(int fd);
+
+    void stop();
+
+    /// Frames read per poll at most: more than a 1 Mbit/s bus carries in 20 ms
+    static constexpr size_t kMaxPollFrames = 256;
+
+    /// CAN socket, for waiting on readiness instead of polling
+    int fd() const { return fd_; }
+
+    /**
+     * @brief Receives only the messages holding the given signals
+     *
+     * The kernel drops every other frame, so undemanded messages cost
+     * nothing. Pass all mapped signals to receive everything again.
+     *
+     * @return false if the socket filter could not be changed
+     */
+    bool set_demanded_signals(const std::unordered_set<std::string>& signals);
+
+private:
+    bool set_filters(const std::vector<uint32_t>& can_ids);
+    void enable_busy_poll();
+
+    std::string interface_;
+    std::string dbc_file_;
+    std::vector<std::string> mapped_sources_;
+    std::vector<std::string> signal_names_;  // by generated signal ID
+    size_t max_poll_signals_ = 0;
+    std::chrono::microseconds busy_poll_{0};
+    int fd_ = -1;
+};
+
+}  // namespace can2vss
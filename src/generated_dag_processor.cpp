@@ -0,0 +1,208 @@
+/**
+ * @file generated_dag_processor.cpp
+ * @brief DAG processor evaluating compiled-in nodes natively
+ */
+
+#include "generated_dag_processor.h"
+
+#include "can2vss_generated_dag.h"
+#include "can2vss_generated_decoders.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <optional>
+#include <set>
+#include <type_traits>
+#include <utility>
+
+namespace can2vss {
+
+namespace {
+
+std::optional<double> numeric_value(const vss::types::Value& value) {
+    return std::visit(
+        [](const auto& v) -> std::optional<double> {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_arithmetic_v<T>) {
+                return static_cast<double>(v);
+            } else {
+                return std::nullopt;
+            }
+        },
+        value);
+}
+
+}  // namespace
+
+struct GeneratedDagProcessor::State {
+    generated_dag::State dag;
+};
+
+GeneratedDagProcessor::GeneratedDagProcessor() : state_(std::make_unique<State>()) {
+    typed_signals_.reserve(generated_dag::kNodeCount);
+
+    size_t widest = 0;
+    for (const auto& info : generated_dag::kStructs) {
+        std::vector<StructBuffer::Field> fields;
+        for (size_t f = info.first_field; f < info.first_field + info.field_count; ++f) {
+            const auto& field = generated_dag::kStructFields[f];
+            fields.push_back({std::string(field.name), field.slot.type});
+        }
+        structs_.push_back(std::make_unique<StructBuffer>(std::string(info.type), std::move(fields)));
+        widest = std::max<size_t>(widest, info.field_count);
+    }
+    struct_scratch_.resize(widest);
+}
+
+GeneratedDagProcessor::~GeneratedDagProcessor() = default;
+
+bool GeneratedDagProcessor::initialize(
+    const std::unordered_map<std::string, vssdag::SignalMapping>& mappings) {
+    std::set<std::string> generated;
+    bool mismatch = false;
+    for (auto name : generated_dag::kNodeNames) {
+        std::string path(name);
+        if (!mappings.count(path)) {
+            LOG(ERROR) << "Compiled-in signal " << path
+                       << " is not in the mapping; rebuild can2vss-feeder-static for this mapping";
+            mismatch = true;
+        }
+        generated.insert(path);
+        node_paths_.push_back(std::move(path));
+    }
+
+    std::unordered_map<std::string, vssdag::SignalMapping> remaining;
+    for (const auto& [signal_name, mapping] : mappings) {
+        if (generated.count(signal_name)) {
+            continue;
+        }
+        for (const auto& dep : mapping.depends_on) {
+            if (generated.count(dep)) {
+                LOG(ERROR) << "Signal " << signal_name << " depends on compiled-in " << dep
+                           << "; rebuild can2vss-feeder-static for this mapping";
+                mismatch = true;
+            }
+        }
+        remaining[signal_name] = mapping;
+    }
+    if (mismatch) {
+        return false;
+    }
+
+    for (size_t i = 0; i < generated_dag::kInputNames.size(); ++i) {
+        std::string name(generated_dag::kInputNames[i]);
+        routes_[name].generated_input = static_cast<int>(i);
+        required_inputs_.push_back(std::move(name));
+    }
+
+    if (!remaining.empty()) {
+        interpreted_ = std::make_unique<vssdag::SignalProcessorDAG>();
+        if (!interpreted_->initialize(remaining)) {
+            LOG(ERROR) << "Failed to initialize DAG processor for interpreted signals";
+            return false;
+        }
+        for (auto& name : interpreted_->get_required_input_signals()) {
+            auto& route = routes_[name];
+            if (route.generated_input < 0) {
+                required_inputs_.push_back(name);
+            }
+            route.interpreted = true;
+        }
+    }
+
+    decoded_routes_.assign(generated::kSignalCount, nullptr);
+    for (size_t signal = 0; signal < generated::kSignalCount; ++signal) {
+        if (auto it = routes_.find(std::string(generated::kSignalNames[signal])); it != routes_.end()) {
+            decoded_routes_[signal] = &*it;
+        }
+    }
+
+    LOG(INFO) << "DAG: " << generated.size() << " compiled-in signals, " << remaining.size()
+              << " interpreted";
+    return true;
+}
+
+std::vector<vssdag::VSSSignal> GeneratedDagProcessor::process_signal_updates(
+    const std::vector<vssdag::SignalUpdate>& updates) {
+    interpreted_updates_.clear();
+    auto& dag = state_->dag;
+    for (const auto& update : updates) {
+        auto it = routes_.find(update.signal_name);
+        if (it == routes_.end()) {
+            continue;
+        }
+        const InputRoute& route = it->second;
+        if (route.generated_input >= 0) {
+            auto value = numeric_value(update.value);
+            if (value && update.status == vss::types::SignalQuality::VALID) {
+                generated_dag::set_input(dag, static_cast<size_t>(route.generated_input), *value);
+            } else {
+                generated_dag::invalidate_input(dag, static_cast<size_t>(route.generated_input));
+            }
+        }
+        if (route.interpreted) {
+            interpreted_updates_.push_back(update);
+        }
+    }
+
+    evaluate(updates.empty());
+    return std::exchange(signals_, {});
+}
+
+std::vector<vssdag::VSSSignal>& GeneratedDagProcessor::process_decoded(const std::vector<DecodedSignal>& decoded) {
+    interpreted_updates_.clear();
+    auto& dag = state_->dag;
+    for (const auto& signal : decoded) {
+        const Route* route = decoded_routes_[signal.signal];
+        if (route == nullptr) {
+            continue;
+        }
+        if (route->second.generated_input >= 0) {
+            generated_dag::set_input(dag, static_cast<size_t>(route->second.generated_input), signal.value);
+        }
+        if (route->second.interpreted) {
+            vssdag::SignalUpdate update;
+            update.signal_name = route->first;
+            update.value = signal.value;
+            update.timestamp = signal.timestamp;
+            interpreted_updates_.push_back(std::move(update));
+        }
+    }
+
+    evaluate(decoded.empty());
+    return signals_;
+}
+
+void GeneratedDagProcessor::evaluate(bool tick) {
+    signals_.clear();
+    typed_signals_.clear();
+    auto& dag = state_->dag;
+    generated_dag::evaluate(dag, std::chrono::steady_clock::now(), [&](size_t node, auto value) {
+        if constexpr (std::is_same_v<decltype(value), StructRef>) {
+            const auto& info = generated_dag::kStructs[value.index];
+            for (size_t f = 0; f < info.field_count; ++f) {
+                const auto& field = generated_dag::kStructFields[info.first_field + f];
+                struct_scratch_[f] = generated_dag::read_slot(dag, field.slot);
+            }
+            structs_[value.index]->store(struct_scratch_.data());
+            typed_signals_.push_back({static_cast<uint32_t>(node), TypedValue::structure(value)});
+        } else {
+            typed_signals_.push_back({static_cast<uint32_t>(node), TypedValue::of(value)});
+        }
+    });
+
+    // An empty batch is the periodic tick, which the interpreted part needs
+    // for periodic and interval-driven signals
+    if (interpreted_ && (tick || !interpreted_updates_.empty())) {
+        auto interpreted = interpreted_->process_signal_updates(interpreted_updates_);
+        signals_.insert(signals_.end(), std::make_move_iterator(interpreted.begin()),
+                        std::make_move_iterator(interpreted.end()));
+    }
+}
+
+std::vector<std::string> GeneratedDagProcessor::get_required_input_signals() const {
+    return required_inputs_;
+}
+
+}  // namespace can2vss
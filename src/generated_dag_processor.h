@@ -0,0 +1,103 @@
+/**
+ * @file generated_dag_processor.h
+ * @brief DAG processor evaluating compiled-in nodes natively
+ */
+
+#pragma once
+
+#include "generated_can_source.h"
+#include "struct_buffer.h"
+#include "typed_value.h"
+#include "vssdag/signal_processor.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief Drop-in replacement for vssdag::SignalProcessorDAG in can2vss-feeder-static
+ *
+ * Mappings compiled in by can2vss-codegen are evaluated by generated code in
+ * topological order with values held in typed slot arrays: no per-node map
+ * lookups, no variant transforms, no Lua. Their outputs are reported as
+ * TypedSignals by node index rather than VSSSignals, so the VSS value variant
+ * is only built on the publish lane. Struct signals are assembled field by
+ * field in the typed slots and snapshotted into a preallocated StructBuffer
+ * when they change. The remaining mappings (strings, periodic triggers,
+ * unsupported Lua) run on an embedded libvssdag processor, which only
+ * receives the input signals it needs.
+ */
+class GeneratedDagProcessor {
+public:
+    GeneratedDagProcessor();
+    ~GeneratedDagProcessor();
+
+    GeneratedDagProcessor(const GeneratedDagProcessor&) = delete;
+    GeneratedDagProcessor& operator=(const GeneratedDagProcessor&) = delete;
+
+    /// Checks the mapping against the compiled-in nodes and sets up the
+    /// interpreted remainder
+    bool initialize(const std::unordered_map<std::string, vssdag::SignalMapping>& mappings);
+
+    /**
+     * @brief Evaluates a batch of updates
+     * @return Outputs of the interpreted mappings; outputs of compiled-in
+     *         mappings are available from typed_signals() until the next call
+     */
+    std::vector<vssdag::VSSSignal> process_signal_updates(const std::vector<vssdag::SignalUpdate>& updates);
+
+    /**
+     * @brief Evaluates a batch of signals decoded by GeneratedCANSource
+     *
+     * Inputs are routed by signal ID and all buffers are reused, so with no
+     * interpreted mappings reading the batch nothing is allocated.
+     *
+     * @return Outputs of the interpreted mappings, valid until the next call;
+     *         compiled-in outputs are available from typed_signals()
+     */
+    std::vector<vssdag::VSSSignal>& process_decoded(const std::vector<DecodedSignal>& decoded);
+
+    std::vector<std::string> get_required_input_signals() const;
+
+    /// Compiled-in outputs of the last process_signal_updates() call
+    const std::vector<TypedSignal>& typed_signals() const { return typed_signals_; }
+
+    /// VSS paths of the compiled-in mappings, indexed by TypedSignal::id
+    const std::vector<std::string>& compiled_signals() const { return node_paths_; }
+
+    /// Latest value of a compiled-in struct, by TypedValue index of a STRUCT signal
+    const StructBuffer* struct_buffer(size_t index) const { return structs_[index].get(); }
+
+private:
+    struct State;
+
+    /// Where an input signal goes: a generated input slot and/or libvssdag
+    struct InputRoute {
+        int generated_input = -1;
+        bool interpreted = false;
+    };
+
+    using Route = std::pair<const std::string, InputRoute>;
+
+    /// Evaluates the generated nodes, then the interpreted ones on
+    /// interpreted_updates_ (always on a tick), into signals_
+    void evaluate(bool tick);
+
+    std::unique_ptr<State> state_;
+    std::unordered_map<std::string, InputRoute> routes_;
+    std::vector<const Route*> decoded_routes_;  // by DecodedSignal::signal, null if unused
+    std::vector<std::string> node_paths_;
+    std::vector<TypedSignal> typed_signals_;
+    std::vector<std::unique_ptr<StructBuffer>> structs_;
+    std::vector<TypedValue> struct_scratch_;  // sized for the widest struct
+    std::vector<vssdag::VSSSignal> signals_;
+    std::vector<vssdag::SignalUpdate> interpreted_updates_;
+    std::unique_ptr<vssdag::SignalProcessorDAG> interpreted_;
+    std::vector<std::string> required_inputs_;
+};
+
+}  // namespace can2vss
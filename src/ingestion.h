@@ -0,0 +1,169 @@
+/**
+ * @file ingestion.h
+ * @brief Multi-source ingestion of decoded signal updates into the DAG thread
+ */
+
+#pragma once
+
+#include "metrics.h"
+#include "mpsc_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief Queue through which any number of signal sources feed the DAG thread
+ *
+ * Sources (CAN interfaces, replay, a test injector...) register once at
+ * startup and then push decoded updates from their own threads into one
+ * lock-free MPSC queue; the DAG thread drains it in batches. Updates of one
+ * source keep their order. Each source has its own pushed, dropped and depth
+ * counters, so a source flooding the queue is visible by name.
+ *
+ * @tparam Update Decoded update type, e.g. vssdag::SignalUpdate
+ */
+template <typename Update>
+class IngestionQueue {
+public:
+    struct SourceCounters {
+        std::string name;
+        std::atomic<uint64_t> pushed{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> dequeued{0};
+
+        /// Updates of this source waiting in the queue
+        uint64_t depth() const {
+            return pushed.load(std::memory_order_relaxed) - dequeued.load(std::memory_order_relaxed);
+        }
+    };
+
+    static constexpr size_t kDefaultCapacity = 8192;
+
+    explicit IngestionQueue(size_t capacity = kDefaultCapacity) : queue_(capacity) {}
+
+    IngestionQueue(const IngestionQueue&) = delete;
+    IngestionQueue& operator=(const IngestionQueue&) = delete;
+
+    /// Registers a source; call before any source pushes. @return its ID
+    size_t add_source(std::string name) {
+        sources_.push_back(std::make_unique<SourceCounters>());
+        sources_.back()->name = std::move(name);
+        return sources_.size() - 1;
+    }
+
+    /// Lock-free and allocation free; @return false if the queue is full and the update was dropped
+    bool push(size_t source, Update&& update) {
+        SourceCounters& counters = *sources_[source];
+        if (!queue_.try_push(Entry{source, std::move(update)})) {
+            counters.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        counters.pushed.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Moves up to max_batch queued updates to the end of out
+     *
+     * Only the DAG thread may call this. @return Number of updates moved
+     */
+    size_t drain(std::vector<Update>& out, size_t max_batch) {
+        size_t count = 0;
+        while (count < max_batch && queue_.try_pop(scratch_)) {
+            sources_[scratch_.source]->dequeued.fetch_add(1, std::memory_order_relaxed);
+            out.push_back(std::move(scratch_.update));
+            ++count;
+        }
+        return count;
+    }
+
+    /// Bytes each unit of capacity takes, for memory budgeting
+    static constexpr size_t entry_bytes() { return MpscQueue<Entry>::slot_bytes(); }
+
+    size_t capacity() const { return queue_.capacity(); }
+    size_t source_count() const { return sources_.size(); }
+    const SourceCounters& source(size_t id) const { return *sources_[id]; }
+
+    /// Exposes ingest.<source>.pushed/dropped/depth as metric probes
+    void register_metrics(Metrics& metrics) const {
+        for (const auto& source : sources_) {
+            const SourceCounters* counters = source.get();
+            const std::string prefix = "ingest." + counters->name + ".";
+            metrics.add_probe(prefix + "pushed", [counters] { return static_cast<int64_t>(counters->pushed.load()); });
+            metrics.add_probe(prefix + "dropped",
+                              [counters] { return static_cast<int64_t>(counters->dropped.load()); });
+            metrics.add_probe(prefix + "depth", [counters] { return static_cast<int64_t>(counters->depth()); });
+        }
+    }
+
+private:
+    struct Entry {
+        size_t source = 0;
+        Update update{};
+    };
+
+    MpscQueue<Entry> queue_;
+    std::vector<std::unique_ptr<SourceCounters>> sources_;
+    Entry scratch_;
+};
+
+/**
+ * @brief Polls one signal source on its own thread and feeds an IngestionQueue
+ */
+template <typename Update>
+class SourceThread {
+public:
+    using PollFunction = std::function<std::vector<Update>()>;
+
+    /// Registers the source with the queue; polling starts with start()
+    SourceThread(IngestionQueue<Update>& queue, std::string name, PollFunction poll,
+                 std::chrono::nanoseconds interval)
+        : queue_(queue), source_(queue.add_source(std::move(name))), poll_(std::move(poll)), interval_(interval) {}
+
+    ~SourceThread() { stop(); }
+
+    SourceThread(const SourceThread&) = delete;
+    SourceThread& operator=(const SourceThread&) = delete;
+
+    void start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+private:
+    void run() {
+        while (running_.load(std::memory_order_relaxed)) {
+            const auto started = std::chrono::steady_clock::now();
+            for (auto& update : poll_()) {
+                queue_.push(source_, std::move(update));
+            }
+            std::this_thread::sleep_until(started + interval_);
+        }
+    }
+
+    IngestionQueue<Update>& queue_;
+    const size_t source_;
+    PollFunction poll_;
+    std::chrono::nanoseconds interval_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+}  // namespace can2vss
@@ -0,0 +1,96 @@
+/**
+ * @file latency_histogram.cpp
+ * @brief Fixed-size log-linear latency histogram
+ */
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+
+namespace can2vss {
+
+int LatencyHistogram::bucket_index(uint64_t ns) {
+    if (ns < kSubBuckets) {
+        return static_cast<int>(ns);
+    }
+    // Position of the highest set bit selects the power of two, the next
+    // kSubBucketBits bits select the linear sub-bucket within it.
+    int msb = 63 - std::countl_zero(ns);
+    int shift = msb - kSubBucketBits;
+    int sub = static_cast<int>((ns >> shift) & (kSubBuckets - 1));
+    return (shift + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(int index) {
+    if (index < kSubBuckets) {
+        return static_cast<uint64_t>(index);
+    }
+    int shift = index / kSubBuckets - 1;
+    uint64_t sub = static_cast<uint64_t>(index % kSubBuckets);
+    uint64_t base = (kSubBuckets | sub) << shift;
+    return base + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+    uint64_t ns = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+    buckets_[std::min(bucket_index(ns), kBuckets - 1)]++;
+    count_++;
+    sum_ns_ += ns;
+    min_ns_ = std::min(min_ns_, ns);
+    max_ns_ = std::max(max_ns_, ns);
+}
+
+uint64_t LatencyHistogram::percentile_ns(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    auto target = static_cast<uint64_t>(std::ceil(count_ * std::clamp(percentile, 0.0, 100.0) / 100.0));
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += buckets_[i];
+        if (seen >= target) {
+            return std::min(bucket_upper_bound(i), max_ns_);
+        }
+    }
+    return max_ns_;
+}
+
+void LatencyHistogram::reset() {
+    buckets_.fill(0);
+    count_ = 0;
+    sum_ns_ = 0;
+    min_ns_ = UINT64_MAX;
+    max_ns_ = 0;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < kBuckets; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ns_ += other.sum_ns_;
+    min_ns_ = std::min(min_ns_, other.min_ns_);
+    max_ns_ = std::max(max_ns_, other.max_ns_);
+}
+
+std::string LatencyHistogram::summary() const {
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "%s: n=%llu min=%.1fus mean=%.1fus p50=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus",
+                  name_.c_str(),
+                  static_cast<unsigned long long>(count_),
+                  min_ns() / 1e3,
+                  mean_ns() / 1e3,
+                  percentile_ns(50) / 1e3,
+                  percentile_ns(99) / 1e3,
+                  percentile_ns(99.9) / 1e3,
+                  max_ns_ / 1e3);
+    return buf;
+}
+
+}  // namespace can2vss
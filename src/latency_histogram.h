@@ -0,0 +1,65 @@
+/**
+ * @file latency_histogram.h
+ * @brief Fixed-size log-linear latency histogram
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace can2vss {
+
+/**
+ * @brief Records nanosecond latencies into log2 buckets with linear sub-buckets
+ *
+ * Each power of two is split into 8 sub-buckets, giving ~12% relative error.
+ * Recording never allocates, so it is safe to use on the RX thread. Not
+ * thread-safe: use one histogram per recording thread.
+ */
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(std::string name) : name_(std::move(name)) {}
+
+    void record(std::chrono::nanoseconds latency);
+
+    uint64_t count() const { return count_; }
+    uint64_t max_ns() const { return max_ns_; }
+    uint64_t min_ns() const { return count_ ? min_ns_ : 0; }
+    double mean_ns() const { return count_ ? static_cast<double>(sum_ns_) / count_ : 0.0; }
+
+    /**
+     * @brief Returns the upper bound of the bucket holding the given percentile
+     * @param percentile Value in [0, 100]
+     */
+    uint64_t percentile_ns(double percentile) const;
+
+    void reset();
+
+    /// Adds another histogram's samples, e.g. to combine per-thread histograms
+    void merge(const LatencyHistogram& other);
+
+    /// One-line summary (count, min, mean, p50/p99/p99.9, max) in microseconds
+    std::string summary() const;
+
+    const std::string& name() const { return name_; }
+
+private:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kBuckets = 64 * kSubBuckets;
+
+    static int bucket_index(uint64_t ns);
+    static uint64_t bucket_upper_bound(int index);
+
+    std::string name_;
+    std::array<uint64_t, kBuckets> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ns_ = 0;
+    uint64_t min_ns_ = UINT64_MAX;
+    uint64_t max_ns_ = 0;
+};
+
+}  // namespace can2vss
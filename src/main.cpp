@@ -8,15 +8,23 @@
  */
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <thread>
 #include <atomic>
+#include <cerrno>
 #include <csignal>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <chrono>
-#include <yaml-cpp/yaml.h>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
+#include <optional>
+#include <set>
+#include <type_traits>
 #include <variant>
+#include <unistd.h>
 
 // VSSDAG includes
 #include "vssdag/can/can_source.h"
@@ -28,74 +36,216 @@
 #include <kuksa_cpp/client.hpp>
 #include <kuksa_cpp/resolver.hpp>
 
+#include <absl/strings/str_split.h>
+
 // VSS types
 #include <vss/types/value.hpp>
 #include <vss/types/quality.hpp>
 
+#include "adaptive_poll.h"
+#include "alloc_tracker.h"
+#include "bus_idle.h"
+#include "dbc_parser.h"
+#include "demand.h"
+#include "event_loop.h"
+#include "feeder_options.h"
+#include "ingestion.h"
+#include "latency_histogram.h"
+#include "mapping_loader.h"
+#include "memory_budget.h"
+#include "metrics.h"
+#include "publisher.h"
+#include "realtime.h"
+#include "rt_log.h"
+#include "sharding.h"
+#include "signal_operators.h"
+#include "signal_priority.h"
+#include "startup_timer.h"
+#include "stage_profiler.h"
+
+// can2vss-feeder-static decodes with functions generated from a fixed DBC
+// and mapping at build time instead of interpreting the DBC at runtime
+#ifdef CAN2VSS_GENERATED_DECODERS
+#include "generated_can_source.h"
+using CanSource = can2vss::GeneratedCANSource;
+#else
+using CanSource = vssdag::CANSignalSource;
+#endif
+
+// ...and evaluates the natively expressible part of the mapping DAG with
+// generated code, leaving the rest to libvssdag
+#ifdef CAN2VSS_GENERATED_DAG
+#include "generated_dag_processor.h"
+using DagProcessor = can2vss::GeneratedDagProcessor;
+#else
+using DagProcessor = vssdag::SignalProcessorDAG;
+#endif
+
 std::atomic<bool> g_running(true);
+std::atomic<int> g_received_signal(0);
+std::atomic<int> g_idle_wake_fd(-1);
+std::atomic<can2vss::EventLoop*> g_event_loop(nullptr);
 
+// Only touches lock-free atomics and write(): logging from a signal handler
+// is not async-signal-safe, so the shutdown message is logged by main().
 void signal_handler(int signal) {
     if (signal == SIGINT || signal == SIGTERM) {
-        LOG(INFO) << "Received signal " << signal << ", shutting down...";
+        g_received_signal = signal;
         g_running = false;
+
+        // End a bus-idle wait, which blocks without timeout
+        int fd = g_idle_wake_fd.load();
+        if (fd >= 0) {
+            uint64_t one = 1;
+            [[maybe_unused]] auto n = write(fd, &one, sizeof(one));
+        }
+        // End the async executor, which may wait on sockets without timeout
+        if (auto* loop = g_event_loop.load()) {
+            loop->stop();
+        }
     }
 }
 
-void print_usage(const char* program_name) {
-    std::cout << "Usage: " << program_name
-              << " <dbc_file> <mapping_yaml_file> <can_interface> <kuksa_address>\n";
-    std::cout << "Example: " << program_name
-              << " vehicle.dbc mappings.yaml can0 127.0.0.1:55555\n";
-}
+/**
+ * @brief Where a VSS signal is published: its pre-resolved handle and lane
+ */
+struct PublishTarget {
+    std::shared_ptr<kuksa::DynamicSignalHandle> handle;
+    can2vss::SignalPriority priority = can2vss::SignalPriority::NORMAL;
+    bool demanded = true;  // cleared by --demand-file for signals nobody consumes
+};
 
 /**
- * @brief Publishes a VSS signal to KUKSA using pre-resolved handle
+ * @brief Adds the heap operations the loop thread makes while alive to a total
  *
- * @param client The KUKSA client
- * @param handle Pre-resolved dynamic signal handle
- * @param vss_signal The VSS signal to publish
- * @return true if successful, false otherwise
+ * Wraps one loop iteration in RT-safe mode, where the total is reported on
+ * shutdown; does nothing otherwise.
  */
-bool publish_to_kuksa(
-    kuksa::Client* client,
-    const std::shared_ptr<kuksa::DynamicSignalHandle>& handle,
-    const vssdag::VSSSignal& vss_signal) {
-
-    // Check if signal is valid
-    if (!vss_signal.qualified_value.is_valid()) {
-        VLOG(3) << "Skipping invalid signal " << vss_signal.path;
-        return false;
+class RtViolationScope {
+public:
+    RtViolationScope(bool enabled, uint64_t& violations) : violations_(violations) {
+        if (enabled) {
+            guard_.emplace();
+        }
     }
+    ~RtViolationScope() {
+        if (guard_) {
+            violations_ += guard_->allocations() + guard_->deallocations();
+        }
+    }
+
+    RtViolationScope(const RtViolationScope&) = delete;
+    RtViolationScope& operator=(const RtViolationScope&) = delete;
 
-    // Publish using dynamic handle and qualified value directly
-    auto status = client->set(*handle, vss_signal.qualified_value);
-    if (!status.ok()) {
-        LOG(ERROR) << "Failed to publish " << vss_signal.path << ": " << status;
-        return false;
+private:
+    std::optional<can2vss::AllocationGuard> guard_;
+    uint64_t& violations_;
+};
+
+bool has_can_source(const vssdag::SignalMapping& mapping) {
+    return (mapping.source.type == "dbc" || mapping.source.type == "can") && !mapping.source.name.empty();
+}
+
+/// Numeric value of a decoded signal, for the operator stage
+std::optional<double> numeric_value(const vss::types::Value& value) {
+    return std::visit(
+        [](const auto& v) -> std::optional<double> {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_arithmetic_v<T>) {
+                return static_cast<double>(v);
+            } else {
+                return std::nullopt;
+            }
+        },
+        value);
+}
+
+/// Socket that --async awaits for readiness; -1 if the source can only be polled
+int source_fd(const CanSource& source) {
+#ifdef CAN2VSS_GENERATED_DECODERS
+    return source.fd();
+#else
+    (void)source;
+    return -1;
+#endif
+}
+
+#ifndef CAN2VSS_GENERATED_DECODERS
+/**
+ * @brief Writes the DBC reduced to the messages holding mapped CAN signals
+ *        to a temporary file, for --lazy-dbc
+ *
+ * The file keeps the .dbc extension, which DBC readers dispatch on.
+ *
+ * @return Path of the file, to be removed by the caller, or empty on error
+ */
+std::string write_mapped_dbc(const std::string& dbc_file,
+                     const std::unordered_map<std::string, vssdag::SignalMapping>& mappings) {
+    auto index = can2vss::DbcIndex::build_from_file(dbc_file);
+    if (!index.ok()) {
+        LOG(ERROR) << "Failed to index DBC: " << index.status();
+        return {};
+    }
+    std::set<std::string> mapped;
+    for (const auto& [signal_name, mapping] : mappings) {
+        if (has_can_source(mapping)) {
+            mapped.insert(mapping.source.name);
+        }
     }
+    const std::string subset = (*index)->subset_text(mapped);
+    LOG(INFO) << "Lazy DBC: loading " << (*index)->count_messages(mapped) << " of " << (*index)->message_count()
+              << " messages (" << can2vss::format_bytes(static_cast<int64_t>(subset.size())) << ")";
 
-    VLOG(2) << "Published " << vss_signal.path;
-    return true;
+    std::string path = (std::filesystem::temp_directory_path() / "can2vss-XXXXXX.dbc").string();
+    int fd = mkstemps(path.data(), 4);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to create reduced DBC " << path << ": " << std::strerror(errno);
+        return {};
+    }
+    for (size_t written = 0; written < subset.size();) {
+        auto n = write(fd, subset.data() + written, subset.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(ERROR) << "Failed to write reduced DBC " << path << ": " << std::strerror(errno);
+            close(fd);
+            unlink(path.c_str());
+            return {};
+        }
+        written += static_cast<size_t>(n);
+    }
+    close(fd);
+    return path;
 }
+#endif
 
 int main(int argc, char* argv[]) {
     using namespace vssdag;
     using namespace kuksa;
 
+    can2vss::StartupTimer startup;
+
     // Initialize Google logging
     google::InitGoogleLogging(argv[0]);
     FLAGS_logtostderr = true;
     FLAGS_colorlogtostderr = true;
 
-    if (argc != 5) {
-        print_usage(argv[0]);
+    auto options = can2vss::parse_options(argc, argv);
+    if (!options) {
+        can2vss::print_usage(argv[0]);
         return 1;
     }
 
-    const std::string dbc_file = argv[1];
-    const std::string yaml_file = argv[2];
-    const std::string can_interface = argv[3];
-    const std::string kuksa_address = argv[4];
+    // --shards=N: this process only supervises N shard processes
+    if (options->spawn_shards > 1) {
+        return can2vss::run_shards(argc, argv, options->spawn_shards);
+    }
+
+    const std::string& dbc_file = options->dbc_file;
+    const std::string& yaml_file = options->yaml_file;
+    const std::string& can_interface = options->can_interface;
+    const std::string& kuksa_address = options->kuksa_address;
 
     // Set up signal handler
     std::signal(SIGINT, signal_handler);
@@ -105,118 +255,169 @@ int main(int argc, char* argv[]) {
     LOG(INFO) << "DBC file: " << dbc_file;
     LOG(INFO) << "Mapping file: " << yaml_file;
     LOG(INFO) << "CAN interface: " << can_interface;
+    const std::vector<std::string> can_interfaces = absl::StrSplit(can_interface, ',', absl::SkipEmpty());
+    if (can_interfaces.empty()) {
+        LOG(ERROR) << "No CAN interface given";
+        return 1;
+    }
     LOG(INFO) << "KUKSA address: " << kuksa_address;
+    if (options->low_latency.enabled) {
+        LOG(INFO) << "Low-latency busy-poll mode enabled";
+    }
 
-    // Parse YAML directly for DAG
-    YAML::Node root = YAML::LoadFile(yaml_file);
-    if (!root["mappings"]) {
-        LOG(ERROR) << "No 'mappings' section found in YAML file";
+    startup.mark("init");
+    can2vss::MemoryLedger memory_ledger;
+    auto mapping_yaml = can2vss::read_mapping_yaml(yaml_file);
+    if (!mapping_yaml.ok()) {
+        LOG(ERROR) << mapping_yaml.status();
         return 1;
     }
+    startup.mark("mapping YAML parse");
+    auto mapping_config = can2vss::load_mappings(*mapping_yaml);
+    if (!mapping_config.ok()) {
+        LOG(ERROR) << mapping_config.status();
+        return 1;
+    }
+    startup.mark("mapping construction");
 
-    std::unordered_map<std::string, SignalMapping> dag_mappings;
-
-    const YAML::Node& yaml_mappings = root["mappings"];
-    for (const auto& mapping_node : yaml_mappings) {
-        if (!mapping_node["signal"]) {
-            continue;
-        }
-
-        std::string signal_name = mapping_node["signal"].as<std::string>();
-
-        SignalMapping mapping;
-
-        // Parse source information if present
-        if (mapping_node["source"]) {
-            const auto& source_node = mapping_node["source"];
-            mapping.source.type = source_node["type"].as<std::string>();
-            mapping.source.name = source_node["name"].as<std::string>();
+    // --shard=I/N: keep this shard's CAN messages and the DAG nodes that
+    // depend on them; other shards run the rest of the mapping
+    if (options->shard_count > 1) {
+#ifdef CAN2VSS_GENERATED_DAG
+        LOG(ERROR) << "Sharding needs can2vss-feeder: the compiled-in DAG can not be split";
+        return 1;
+#else
+        auto dbc_index = can2vss::DbcIndex::build_from_file(dbc_file);
+        if (!dbc_index.ok()) {
+            LOG(ERROR) << "Failed to index DBC: " << dbc_index.status();
+            return 1;
         }
-        // Parse datatype - no default, must be specified
-        if (mapping_node["datatype"]) {
-            std::string datatype_str = mapping_node["datatype"].as<std::string>();
-            auto datatype_opt = value_type_from_string(datatype_str);
-            if (datatype_opt.has_value()) {
-                mapping.datatype = *datatype_opt;
-            } else {
-                LOG(WARNING) << "Unknown datatype '" << datatype_str << "' for signal " << signal_name;
-                mapping.datatype = ValueType::UNSPECIFIED;
+        std::vector<can2vss::ShardSignal> shard_signals;
+        for (const auto& [signal_name, mapping] : mapping_config->mappings) {
+            can2vss::ShardSignal signal{signal_name, std::nullopt, mapping.depends_on};
+            if (has_can_source(mapping)) {
+                signal.can_id = (*dbc_index)->message_id(mapping.source.name);
+            } else if (const auto* input = mapping_config->operator_can_input(signal_name)) {
+                signal.can_id = (*dbc_index)->message_id(*input);
+            } else if (auto it = mapping_config->operators.find(signal_name); it != mapping_config->operators.end()) {
+                signal.depends_on = {it->second.input};
             }
-        } else {
-            LOG(WARNING) << "No datatype specified for signal " << signal_name << ", using UNSPECIFIED";
-            mapping.datatype = ValueType::UNSPECIFIED;
+            shard_signals.push_back(std::move(signal));
         }
-        mapping.interval_ms = mapping_node["interval_ms"].as<int>(0);
-
-        // Check if this is a struct type
-        if (mapping.datatype == ValueType::STRUCT) {
-            mapping.is_struct = true;
-            if (mapping_node["struct_type"]) {
-                mapping.struct_type = mapping_node["struct_type"].as<std::string>();
+        const auto plan = can2vss::plan_shards(shard_signals, options->shard_count);
+        for (size_t i = 0; i < shard_signals.size(); ++i) {
+            if (plan.shard_of[i] != options->shard_index) {
+                mapping_config->mappings.erase(shard_signals[i].name);
+                mapping_config->operators.erase(shard_signals[i].name);
             }
         }
-
-        // DAG support
-        if (mapping_node["depends_on"]) {
-            for (const auto& dep : mapping_node["depends_on"]) {
-                mapping.depends_on.push_back(dep.as<std::string>());
-            }
+        LOG(INFO) << "Shard " << options->shard_index << "/" << options->shard_count << ": "
+                  << plan.signals_per_shard[options->shard_index] << " of " << shard_signals.size()
+                  << " signals from " << plan.messages_per_shard[options->shard_index]
+                  << " CAN messages (largest indivisible group: " << plan.largest_group << " signals)";
+        if (mapping_config->mappings.empty()) {
+            LOG(WARNING) << "Shard " << options->shard_index << " has no signals; use fewer shards";
         }
 
-        // Parse transform (simplified for now)
-        if (mapping_node["transform"]) {
-            const YAML::Node& transform = mapping_node["transform"];
-            if (transform["code"]) {
-                mapping.transform = CodeTransform{transform["code"].as<std::string>()};
-            } else if (transform["math"]) {
-                // Keep backward compatibility
-                mapping.transform = CodeTransform{transform["math"].as<std::string>()};
-            } else if (transform["mapping"]) {
-                ValueMapping value_map;
-                for (const auto& item : transform["mapping"]) {
-                    std::string from = item["from"].as<std::string>();
-                    std::string to = item["to"].as<std::string>();
-                    value_map.mappings[from] = to;
-                }
-                mapping.transform = value_map;
-            } else {
-                mapping.transform = DirectMapping{};
-            }
-        } else {
-            mapping.transform = DirectMapping{};
+        if (options->profile) {
+            std::filesystem::path trace(options->profile_trace);
+            trace.replace_filename(trace.stem().string() + "-shard" + std::to_string(options->shard_index) +
+                                   trace.extension().string());
+            options->profile_trace = trace.string();
         }
+        startup.mark("shard selection");
+#endif
+    }
+    memory_ledger.mark("mapping table");
+    const auto& dag_mappings = mapping_config->mappings;
+    const auto& signal_priorities = mapping_config->priorities;
 
-        // Parse update trigger
-        if (mapping_node["update_trigger"]) {
-            std::string trigger = mapping_node["update_trigger"].as<std::string>();
-            if (trigger == "periodic") {
-                mapping.update_trigger = UpdateTrigger::PERIODIC;
-            } else if (trigger == "both") {
-                mapping.update_trigger = UpdateTrigger::BOTH;
-            } else {
-                mapping.update_trigger = UpdateTrigger::ON_DEPENDENCY;
-            }
-        }
+    // Operator nodes (windowed aggregates, filters, events) run natively ahead of the DAG,
+    // which receives their outputs as input signals
+    std::vector<can2vss::OperatorSpec> operator_specs;
+    for (const auto& [signal_name, spec] : mapping_config->operators) {
+        operator_specs.push_back(spec);
+    }
+    std::sort(operator_specs.begin(), operator_specs.end(),
+              [](const auto& a, const auto& b) { return a.name < b.name; });
+    can2vss::OperatorGraph operators;
+    if (auto status = operators.initialize(operator_specs); !status.ok()) {
+        LOG(ERROR) << "Invalid operator configuration: " << status;
+        return 1;
+    }
+    if (operators.size() > 0) {
+        LOG(INFO) << "Operator stage: " << operators.size() << " operators reading " << operators.inputs().size()
+                  << " CAN signals";
+    }
 
-        // Store mapping
-        dag_mappings[signal_name] = mapping;
+    // The CAN source decodes the signals its mappings name; operators may
+    // read CAN signals no DAG mapping uses
+    std::unordered_map<std::string, SignalMapping> operator_source_mappings;
+    if (operators.size() > 0) {
+        operator_source_mappings = dag_mappings;
+        for (const auto& input : operators.inputs()) {
+            SignalMapping mapping;
+            mapping.source = {"dbc", input};
+            mapping.datatype = vss::types::ValueType::DOUBLE;
+            operator_source_mappings.emplace(input, std::move(mapping));
+        }
     }
+    const auto& source_mappings = operators.size() > 0 ? operator_source_mappings : dag_mappings;
 
     // Initialize DAG processor
-    SignalProcessorDAG processor;
+    DagProcessor processor;
     if (!processor.initialize(dag_mappings)) {
         LOG(ERROR) << "Failed to initialize DAG processor";
         return 1;
     }
+    startup.mark("DAG initialize");
+    memory_ledger.mark("DAG state and Lua");
 
-    // Create CAN signal source
-    auto can_source = std::make_unique<vssdag::CANSignalSource>(
-        can_interface, dbc_file, dag_mappings);
+    // --lazy-dbc: the CAN source parses and keeps every message of the DBC it
+    // is given, so give it one reduced to the messages the mapping uses
+    std::string can_dbc_file = dbc_file;
+    std::string reduced_dbc_file;
+    if (options->lazy_dbc) {
+#ifdef CAN2VSS_GENERATED_DECODERS
+        LOG(INFO) << "--lazy-dbc has no effect: the DBC is compiled in";
+#else
+        reduced_dbc_file = write_mapped_dbc(dbc_file, source_mappings);
+        if (reduced_dbc_file.empty()) {
+            return 1;
+        }
+        can_dbc_file = reduced_dbc_file;
+#endif
+    }
 
-    if (!can_source->initialize()) {
-        LOG(ERROR) << "Failed to initialize CAN signal source";
+    // Create one CAN signal source per interface; the first is polled by the
+    // loop thread, the others by their own threads through the ingestion queue
+    // (with --async, all of them by coroutines on the loop thread)
+    std::vector<std::unique_ptr<CanSource>> can_sources;
+    bool can_sources_ready = true;
+    for (const auto& interface : can_interfaces) {
+        can_sources.push_back(std::make_unique<CanSource>(
+            interface, can_dbc_file, source_mappings));
+#ifdef CAN2VSS_GENERATED_DECODERS
+        // The compiled-in source owns its socket, so it busy-polls per socket
+        if (options->low_latency.enabled) {
+            can_sources.back()->set_busy_poll(std::chrono::microseconds(50));
+        }
+#endif
+        if (!can_sources.back()->initialize()) {
+            LOG(ERROR) << "Failed to initialize CAN signal source on " << interface;
+            can_sources_ready = false;
+            break;
+        }
+    }
+    if (!reduced_dbc_file.empty()) {
+        unlink(reduced_dbc_file.c_str());
+    }
+    if (!can_sources_ready) {
         return 1;
     }
+    auto& can_source = can_sources.front();
+    startup.mark("CAN source initialize");
+    memory_ledger.mark("DBC model");
 
     auto required_signals = processor.get_required_input_signals();
     LOG(INFO) << "Monitoring " << required_signals.size() << " input signals:";
@@ -232,6 +433,7 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     auto resolver = std::move(*resolver_result);
+    startup.mark("resolver create");
 
     auto client_result = Client::create(kuksa_address);
     if (!client_result.ok()) {
@@ -240,10 +442,12 @@ int main(int argc, char* argv[]) {
     }
     auto client = std::move(*client_result);
     LOG(INFO) << "Connected to KUKSA successfully";
+    startup.mark("client create");
 
     // Pre-resolve all output VSS signal handles
     LOG(INFO) << "Pre-resolving KUKSA signal handles...";
-    std::unordered_map<std::string, std::shared_ptr<DynamicSignalHandle>> signal_handles;
+    std::unordered_map<std::string, PublishTarget> signal_handles;
+    bool has_high_priority = false;
 
     for (const auto& [signal_name, mapping] : dag_mappings) {
         auto handle_result = resolver->get_dynamic(signal_name);
@@ -252,78 +456,723 @@ int main(int argc, char* argv[]) {
                         << handle_result.status() << " (will retry on first publish)";
             continue;
         }
-        signal_handles[signal_name] = *handle_result;
+        PublishTarget target{*handle_result};
+        if (auto it = signal_priorities.find(signal_name); it != signal_priorities.end()) {
+            target.priority = it->second;
+        }
+        has_high_priority |= target.priority == can2vss::SignalPriority::HIGH;
+        signal_handles[signal_name] = std::move(target);
         VLOG(1) << "Resolved signal: " << signal_name;
     }
     LOG(INFO) << "Pre-resolved " << signal_handles.size() << " signal handles";
+    startup.mark("handle resolution");
+    memory_ledger.mark("KUKSA client and handles");
 
-    // Main processing loop - poll signal sources
-    auto last_periodic_check = std::chrono::steady_clock::now();
-    const auto processing_interval = std::chrono::milliseconds(10);  // Process every 10ms
+    // --memory-budget: shrink the preallocated rings to what the loaded
+    // configuration leaves of the budget, or refuse to start
+    size_t queue_capacity = can2vss::PublishQueueConfig{}.capacity;
+    size_t rt_log_capacity = options->rt_safe ? 4096 : 1;  // unused unless RT-safe
+    size_t trace_capacity = 1 << 18;
+    // Without --async, CAN interfaces beyond the first feed the ingestion queue
+    const bool ingest_queue = can_sources.size() > 1 && !(options->async && !options->low_latency.enabled);
+    size_t ingest_capacity = ingest_queue ? can2vss::IngestionQueue<SignalUpdate>::kDefaultCapacity : 0;
+    const int64_t memory_budget = int64_t{options->memory_budget_mb} * 1024 * 1024;
+    if (memory_budget > 0) {
+        const int64_t used = can2vss::current_memory_usage().rss_bytes;
+        if (used >= memory_budget) {
+            LOG(ERROR) << "Configuration exceeds --memory-budget: " << can2vss::format_bytes(used)
+                       << " in use after loading it, budget is " << can2vss::format_bytes(memory_budget);
+            LOG(ERROR) << memory_ledger.report();
+            return 1;
+        }
+        std::vector<can2vss::BufferDemand> demands = {
+            {"publish queues", sizeof(can2vss::PublishRequest), queue_capacity, 256,
+             can2vss::kSignalPriorityCount * static_cast<size_t>(options->publish_channels)},
+            {"RT log ring", sizeof(can2vss::RtLogRecord), rt_log_capacity, std::min<size_t>(rt_log_capacity, 256)},
+            {"profiler trace", can2vss::StageProfiler::kTraceEventBytes, options->profile ? trace_capacity : 0,
+             options->profile ? size_t{4096} : 0},
+            {"ingestion queue", can2vss::IngestionQueue<SignalUpdate>::entry_bytes(), ingest_capacity,
+             std::min<size_t>(ingest_capacity, 1024)},
+        };
+        auto sizes = can2vss::size_buffers(memory_budget - used, demands);
+        if (!sizes.ok()) {
+            LOG(ERROR) << "Configuration exceeds --memory-budget: " << sizes.status();
+            LOG(ERROR) << memory_ledger.report();
+            return 1;
+        }
+        queue_capacity = (*sizes)[0];
+        rt_log_capacity = (*sizes)[1];
+        trace_capacity = (*sizes)[2];
+        ingest_capacity = (*sizes)[3];
+        LOG(INFO) << "Memory budget " << can2vss::format_bytes(memory_budget) << ", "
+                  << can2vss::format_bytes(used) << " in use after loading the configuration; "
+                  << "publish queues hold " << queue_capacity << " requests";
+        if (ingest_queue) {
+            LOG(INFO) << "Ingestion queue holds " << ingest_capacity << " updates";
+        }
+    }
 
-    while (g_running) {
-        auto loop_start = std::chrono::steady_clock::now();
+    // Publish lanes: high priority signals get their own thread and gRPC
+    // channel; normal and bulk share the main lanes with weighted scheduling.
+    // A full queue holds the loop back until the lane has room, as calling
+    // set() on the loop did; the RT-safe loop must not wait, so it drops
+    const bool publish_drop = options->publish_drop || options->rt_safe;
+    auto lanes_result = can2vss::PublishLanes::create(
+        kuksa_address, client.get(), has_high_priority, queue_capacity, options->publish_channels,
+        publish_drop ? can2vss::QueueFullPolicy::DROP : can2vss::QueueFullPolicy::BLOCK);
+    if (!lanes_result.ok()) {
+        LOG(ERROR) << "Failed to create KUKSA publish lanes: " << lanes_result.status();
+        return 1;
+    }
+    auto publish_lanes = std::move(*lanes_result);
+    if (has_high_priority) {
+        LOG(INFO) << "High priority signals publish on a dedicated lane";
+    }
+    if (options->publish_channels > 1) {
+        LOG(INFO) << "Normal and bulk signals publish over " << options->publish_channels << " channels";
+    }
+    memory_ledger.mark("publish lanes and queues");
 
-        // Poll signal source for updates
-        auto signal_updates = can_source->poll();
+    can2vss::Metrics metrics;
+    publish_lanes->register_metrics(metrics);
+    auto& metric_polls = metrics.metric("loop.polls");
+    auto& metric_updates = metrics.metric("loop.signal_updates");
+    auto& metric_vss_signals = metrics.metric("loop.vss_signals");
+    auto& metric_operator_outputs = metrics.metric("operators.outputs");
+    can2vss::MetricsReporter metrics_reporter(metrics, std::chrono::seconds(options->metrics_interval_s));
 
-        // Process signal updates (if any)
-        if (!signal_updates.empty()) {
-            VLOG(2) << "Processing " << signal_updates.size() << " signal updates";
-            auto vss_signals = processor.process_signal_updates(signal_updates);
-            VLOG(2) << "Produced " << vss_signals.size() << " VSS signals";
+    // --async runs all sources and periodic evaluation as coroutines on one
+    // event loop; it can not be combined with busy-polling
+    const bool async_mode = options->async && !options->low_latency.enabled;
+    can2vss::EventLoop event_loop;
+    if (options->async && !async_mode) {
+        LOG(WARNING) << "--async has no effect in low-latency busy-poll mode";
+    }
+    if (async_mode && !event_loop.initialize()) {
+        LOG(ERROR) << "Failed to create the event loop for --async";
+        return 1;
+    }
+
+    // Without --async, sources beyond the first push their updates into a
+    // lock-free queue that the loop drains after polling its own source
+    std::unique_ptr<can2vss::IngestionQueue<SignalUpdate>> ingestion;
+    std::vector<std::unique_ptr<can2vss::SourceThread<SignalUpdate>>> source_threads;
+    if (can_sources.size() > 1 && !async_mode) {
+        ingestion = std::make_unique<can2vss::IngestionQueue<SignalUpdate>>(ingest_capacity);
+        for (size_t i = 1; i < can_sources.size(); ++i) {
+            auto* source = can_sources[i].get();
+            source_threads.push_back(std::make_unique<can2vss::SourceThread<SignalUpdate>>(
+                *ingestion, can_interfaces[i], [source] { return source->poll(); }, std::chrono::milliseconds(10)));
+        }
+        ingestion->register_metrics(metrics);
+        LOG(INFO) << "Ingesting from " << can_sources.size() << " CAN interfaces";
+    }
 
-            // Publish to KUKSA using pre-resolved handles
+    // The loop thread only hands work to the publish lanes (and, in RT-safe
+    // mode, the logger). Start them before any real-time settings are
+    // applied so they do not inherit the RX core or SCHED_FIFO.
+    const bool rt_safe = options->rt_safe;
+    can2vss::RtLogger rt_log(rt_log_capacity);
+    memory_ledger.mark("RT log ring");
+    uint64_t rt_violations = 0;
+    publish_lanes->start();
+    metrics_reporter.start();
+    for (auto& thread : source_threads) {
+        thread->start();
+    }
+    if (rt_safe) {
+        LOG(INFO) << "RT-safe mode: logging moved off the loop thread";
+        rt_log.start();
+    }
+
+    // In low-latency mode the main thread becomes the RX thread: pin it and
+    // raise its priority only now, so the gRPC threads created above do not
+    // inherit the isolated core or the SCHED_FIFO policy.
+    const bool low_latency = options->low_latency.enabled;
+    if (low_latency) {
+        can2vss::apply_realtime_settings(options->low_latency);
+    }
+    can2vss::LatencyHistogram poll_gap_histogram("poll gap");
+    can2vss::LatencyHistogram decode_histogram("poll to decode");
+
+    // --profile: per-stage timers on the loop thread, null when disabled
+    std::unique_ptr<can2vss::StageProfiler> profiler;
+    if (options->profile) {
+        profiler = std::make_unique<can2vss::StageProfiler>(trace_capacity);
+        memory_ledger.mark("profiler trace");
+        LOG(INFO) << "Profiling loop stages, trace will be written to " << options->profile_trace;
+    }
+
+    // Publish to KUKSA using pre-resolved handles
+    auto publish_signals = [&](std::vector<VSSSignal>& vss_signals) {
+        metric_vss_signals.add(static_cast<int64_t>(vss_signals.size()));
+        const auto enqueued_at = std::chrono::steady_clock::now();
+
+        if (!rt_safe) {
+            can2vss::ProfileScope format_scope(profiler.get(), can2vss::ProfileStage::FORMAT);
             for (const auto& vss : vss_signals) {
                 VSSFormatter::log_vss_signal(vss);
+            }
+        }
 
-                auto it = signal_handles.find(vss.path);
-                if (it != signal_handles.end()) {
-                    publish_to_kuksa(client.get(), it->second, vss);
+        can2vss::ProfileScope publish_scope(profiler.get(), can2vss::ProfileStage::PUBLISH);
+        for (auto& vss : vss_signals) {
+            auto it = signal_handles.find(vss.path);
+            if (it == signal_handles.end()) {
+                if (rt_safe) {
+                    rt_log.vlog(1, "Skipping signal not in KUKSA VSS tree: ", vss.path);
                 } else {
                     VLOG(1) << "Skipping signal " << vss.path << " (not in KUKSA VSS tree)";
                 }
+                continue;
+            }
+
+            const auto& target = it->second;
+            if (!target.demanded) {
+                continue;
+            }
+            can2vss::PublishRequest request{target.handle.get(), &it->first,
+                                            std::move(vss.qualified_value), enqueued_at, {}, nullptr};
+            if (!publish_lanes->enqueue(target.priority, std::move(request))) {
+                if (rt_safe) {
+                    rt_log.log(can2vss::RtLogSeverity::WARNING, "Publish queue full, dropped ", it->first);
+                } else {
+                    LOG_EVERY_N(WARNING, 100) << "Publish queue full, dropped " << it->first;
+                }
             }
         }
+    };
 
-        // Check for periodic processing
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - last_periodic_check).count();
+#ifdef CAN2VSS_GENERATED_DAG
+    // Compiled-in signals are published by node index straight from their
+    // typed values; the VSS value variant is only built on the lane thread
+    std::vector<const std::pair<const std::string, PublishTarget>*> compiled_targets;
+    for (const auto& path : processor.compiled_signals()) {
+        auto it = signal_handles.find(path);
+        compiled_targets.push_back(it == signal_handles.end() ? nullptr : &*it);
+    }
+
+    auto publish_typed = [&](const std::vector<can2vss::TypedSignal>& typed_signals) {
+        metric_vss_signals.add(static_cast<int64_t>(typed_signals.size()));
+        const auto enqueued_at = std::chrono::steady_clock::now();
+        can2vss::ProfileScope publish_scope(profiler.get(), can2vss::ProfileStage::PUBLISH);
+        for (const auto& typed : typed_signals) {
+            const auto* target = compiled_targets[typed.id];
+            if (target == nullptr || !target->second.demanded) {
+                continue;
+            }
+            can2vss::PublishRequest request{target->second.handle.get(), &target->first, {}, enqueued_at,
+                                            typed.value, nullptr, typed.id};
+            if (typed.value.type == can2vss::SlotType::STRUCT) {
+                request.structure = processor.struct_buffer(typed.value.u);
+            }
+            if (!publish_lanes->enqueue(target->second.priority, std::move(request))) {
+                if (rt_safe) {
+                    rt_log.log(can2vss::RtLogSeverity::WARNING, "Publish queue full, dropped ", target->first);
+                } else {
+                    LOG_EVERY_N(WARNING, 100) << "Publish queue full, dropped " << target->first;
+                }
+            }
+        }
+    };
+#endif
 
-        if (elapsed_ms >= 50) {  // Check every 50ms
+    // Adaptive wait between polls; decisions are exported as metrics
+    const bool adaptive_poll = options->adaptive_poll && !low_latency && !async_mode;
+    can2vss::AdaptivePollController poll_controller;
+    auto& metric_poll_wait = metrics.metric("poll.wait_us");
+    auto& metric_arrival_rate = metrics.metric("poll.arrival_rate_hz");
+    auto& metric_expected_batch = metrics.metric("poll.expected_batch");
+    if (adaptive_poll) {
+        LOG(INFO) << "Adaptive poll interval enabled";
+    }
+
+    // Bus-silence detection: suspend polling and periodic evaluation until
+    // CAN traffic resumes
+    std::unique_ptr<can2vss::BusIdleDetector> idle_detector;
+    auto& metric_idle_entries = metrics.metric("idle.entries");
+    auto& metric_idle_ms = metrics.metric("idle.total_ms");
+    if (options->idle_after_s > 0 && async_mode) {
+        LOG(WARNING) << "Idle mode is not supported with --async, disabled";
+    } else if (options->idle_after_s > 0 && can_sources.size() > 1) {
+        LOG(WARNING) << "Idle mode watches a single CAN interface, disabled with " << can_sources.size()
+                     << " interfaces";
+    } else if (options->idle_after_s > 0) {
+        idle_detector = std::make_unique<can2vss::BusIdleDetector>(
+            can_interface, std::chrono::seconds(options->idle_after_s));
+        if (idle_detector->initialize()) {
+            g_idle_wake_fd = idle_detector->wake_fd();
+            LOG(INFO) << "Idle mode enabled after " << options->idle_after_s << "s of bus silence";
+        } else {
+            LOG(WARNING) << "Bus-silence detection unavailable, idle mode disabled";
+            idle_detector.reset();
+        }
+    }
+
+    // --demand-file: decode, evaluate and publish only what the listed
+    // consumers need. A watcher thread re-checks the file once per second
+    // and plans the demand; the loop only swaps in the finished plan.
+    std::unique_ptr<can2vss::DemandWatcher> demand_watcher;
+    std::unique_ptr<can2vss::DemandUpdate> demand;    // plan in effect, owned by the loop
+    std::vector<PublishTarget*> demand_targets;        // per demand signal, null if unresolved
+    const std::unordered_set<std::string>* demand_inputs = nullptr;  // CAN signals still decoded, if filtering
+    auto& metric_demand_published = metrics.metric("demand.published_signals");
+    auto& metric_demand_active = metrics.metric("demand.active_signals");
+    auto& metric_demand_filtered = metrics.metric("demand.filtered_updates");
+    if (!options->demand_file.empty()) {
+        std::vector<can2vss::DemandSignal> demand_signals;
+        std::unordered_set<std::string> all_can_signals;
+        for (const auto& [signal_name, mapping] : dag_mappings) {
+            can2vss::DemandSignal signal{signal_name, {}, mapping.depends_on};
+            if (has_can_source(mapping)) {
+                signal.can_signal = mapping.source.name;
+                all_can_signals.insert(mapping.source.name);
+            } else if (const auto* input = mapping_config->operator_can_input(signal_name)) {
+                signal.can_signal = *input;
+                all_can_signals.insert(*input);
+            } else if (auto it = mapping_config->operators.find(signal_name); it != mapping_config->operators.end()) {
+                signal.depends_on = {it->second.input};
+            }
+            auto target = signal_handles.find(signal_name);
+            demand_targets.push_back(target != signal_handles.end() ? &target->second : nullptr);
+            demand_signals.push_back(std::move(signal));
+        }
+
+        can2vss::DemandWatcher::Listener narrow_filters;
+#ifdef CAN2VSS_GENERATED_DECODERS
+        // Let the kernel drop the frames of undemanded messages; setsockopt()
+        // on the sockets is safe from the watcher thread
+        narrow_filters = [&can_sources, all_can_signals = std::move(all_can_signals)](
+                             const can2vss::DemandUpdate& update) {
+            for (auto& source : can_sources) {
+                source->set_demanded_signals(update.everything ? all_can_signals : update.plan.can_signals);
+            }
+        };
+#endif
+        demand_watcher = std::make_unique<can2vss::DemandWatcher>(
+            options->demand_file, std::move(demand_signals), std::chrono::seconds(1), std::move(narrow_filters));
+        demand_watcher->check();
+    }
+
+    // Swaps in a plan the watcher has finished; no syscall, parsing or
+    // allocation on the loop thread
+    auto apply_demand = [&]() {
+        auto update = demand_watcher->take();
+        if (!update) {
+            return;
+        }
+        for (size_t i = 0; i < demand_targets.size(); ++i) {
+            if (demand_targets[i] != nullptr) {
+                demand_targets[i]->demanded = update->everything || update->plan.published[i];
+            }
+        }
+        demand_inputs = update->everything ? nullptr : &update->plan.can_signals;
+        const auto total = static_cast<int64_t>(demand_targets.size());
+        metric_demand_published.set(update->everything ? total
+                                                       : static_cast<int64_t>(update->plan.published_count));
+        metric_demand_active.set(update->everything ? total : static_cast<int64_t>(update->plan.active_count));
+        if (demand) {
+            demand_watcher->retire(std::move(demand));
+        }
+        demand = std::move(update);
+    };
+    if (demand_watcher) {
+        apply_demand();
+        demand_watcher->start();
+    }
+
+    startup.mark("publish and loop setup");
+    LOG(INFO) << startup.report();
+    LOG(INFO) << memory_ledger.report();
+    memory_ledger.close();
+    bool first_signal_pending = true;
+
+    const auto processing_interval = std::chrono::milliseconds(10);  // Process every 10ms
+    const auto periodic_interval = std::chrono::milliseconds(50);
+    constexpr size_t kIngestBatch = 1024;  // updates taken from other sources per loop iteration
+
+    // Appends the operator outputs to a batch, stamped with the time they describe
+    auto take_operator_outputs = [&](std::vector<SignalUpdate>& signal_updates) {
+        for (const auto& output : operators.outputs()) {
+            const auto& spec = operators.spec(output.op);
+            SignalUpdate update;
+            update.signal_name = spec.name;
+            if (spec.kind == can2vss::OperatorSpec::Kind::EVENT) {
+                update.value = output.sample.value != 0.0;
+            } else {
+                update.value = output.sample.value;
+            }
+            update.timestamp = output.sample.time;
+            signal_updates.push_back(std::move(update));
+        }
+        metric_operator_outputs.add(static_cast<int64_t>(operators.outputs().size()));
+        operators.clear_outputs();
+    };
+
+    // Feeds the operators from a batch of decoded updates and appends their
+    // outputs to the batch
+    auto run_operators = [&](std::vector<SignalUpdate>& signal_updates) {
+        const size_t decoded = signal_updates.size();
+        for (size_t i = 0; i < decoded; ++i) {
+            const auto& update = signal_updates[i];
+            const int input = operators.input_index(update.signal_name);
+            if (input < 0 || update.status != vss::types::SignalQuality::VALID) {
+                continue;
+            }
+            if (auto value = numeric_value(update.value)) {
+                operators.push(static_cast<size_t>(input), *value, update.timestamp);
+            }
+        }
+        take_operator_outputs(signal_updates);
+    };
+
+    // Runs one batch of signal updates through the DAG to the publish lanes
+    auto process_updates = [&](std::vector<SignalUpdate>& signal_updates,
+                               std::chrono::steady_clock::time_point loop_start) {
+        // The source decodes inside poll(), so this covers poll and decode only
+        if (low_latency && !signal_updates.empty()) {
+            decode_histogram.record(std::chrono::steady_clock::now() - loop_start);
+        }
+        if (demand_inputs != nullptr && !signal_updates.empty()) {
+            const auto filtered = std::erase_if(signal_updates, [&](const SignalUpdate& update) {
+                return !demand_inputs->contains(update.signal_name);
+            });
+            metric_demand_filtered.add(static_cast<int64_t>(filtered));
+        }
+        if (signal_updates.empty()) {
+            return;
+        }
+        if (operators.size() > 0) {
+            run_operators(signal_updates);
+        }
+        if (rt_safe) {
+            rt_log.vlog(2, "Processing signal updates: ", {}, static_cast<int64_t>(signal_updates.size()));
+        } else {
+            VLOG(2) << "Processing " << signal_updates.size() << " signal updates";
+        }
+        std::vector<VSSSignal> vss_signals;
+        {
+            can2vss::ProfileScope dag_scope(profiler.get(), can2vss::ProfileStage::DAG);
+            vss_signals = processor.process_signal_updates(signal_updates);
+        }
+        if (rt_safe) {
+            rt_log.vlog(2, "Produced VSS signals: ", {}, static_cast<int64_t>(vss_signals.size()));
+        } else {
+            VLOG(2) << "Produced " << vss_signals.size() << " VSS signals";
+        }
+
+        publish_signals(vss_signals);
+#ifdef CAN2VSS_GENERATED_DAG
+        publish_typed(processor.typed_signals());
+#endif
+    };
+
+#ifdef CAN2VSS_GENERATED_DAG
+    // Without operators, or updates of other interfaces to merge, signals go
+    // from the compiled-in decoders to the DAG by signal ID through a buffer
+    // reused across polls, so the loop thread does not allocate for them
+    const bool decoded_path = operators.size() == 0 && !ingestion;
+    std::vector<can2vss::DecodedSignal> decoded_signals;
+    if (decoded_path) {
+        decoded_signals.reserve(can_source->max_poll_signals());
+    }
+
+    auto process_decoded = [&](const CanSource& source, std::chrono::steady_clock::time_point loop_start) {
+        if (low_latency && !decoded_signals.empty()) {
+            decode_histogram.record(std::chrono::steady_clock::now() - loop_start);
+        }
+        if (demand_inputs != nullptr && !decoded_signals.empty()) {
+            const auto filtered = std::erase_if(decoded_signals, [&](const can2vss::DecodedSignal& signal) {
+                return !demand_inputs->contains(source.signal_name(signal.signal));
+            });
+            metric_demand_filtered.add(static_cast<int64_t>(filtered));
+        }
+        if (decoded_signals.empty()) {
+            return;
+        }
+        if (rt_safe) {
+            rt_log.vlog(2, "Processing decoded signals: ", {}, static_cast<int64_t>(decoded_signals.size()));
+        } else {
+            VLOG(2) << "Processing " << decoded_signals.size() << " decoded signals";
+        }
+        std::vector<VSSSignal>* vss_signals = nullptr;
+        {
+            can2vss::ProfileScope dag_scope(profiler.get(), can2vss::ProfileStage::DAG);
+            vss_signals = &processor.process_decoded(decoded_signals);
+        }
+        publish_signals(*vss_signals);
+        publish_typed(processor.typed_signals());
+    };
+#endif
+
+    // Polls a source (the first one also drains the ingestion queue) and
+    // processes the batch; returns the number of updates polled
+    auto poll_and_process = [&](CanSource& source, std::chrono::steady_clock::time_point loop_start) -> size_t {
+#ifdef CAN2VSS_GENERATED_DAG
+        if (decoded_path) {
+            {
+                can2vss::ProfileScope poll_scope(profiler.get(), can2vss::ProfileStage::POLL);
+                source.poll(decoded_signals);
+            }
+            const size_t polled = decoded_signals.size();
+            process_decoded(source, loop_start);
+            return polled;
+        }
+#endif
+        std::vector<SignalUpdate> signal_updates;
+        {
+            can2vss::ProfileScope poll_scope(profiler.get(), can2vss::ProfileStage::POLL);
+            signal_updates = source.poll();
+            if (ingestion) {
+                ingestion->drain(signal_updates, kIngestBatch);
+            }
+        }
+        const size_t polled = signal_updates.size();
+        process_updates(signal_updates, loop_start);
+        return polled;
+    };
+
+    // Evaluates the DAG without input, for periodic and timed-out signals
+    auto process_periodic = [&]() {
+        if (!rt_safe) {
             VLOG(3) << "Periodic check triggered";
-            // Process with empty signals to trigger periodic updates
-            auto vss_signals = processor.process_signal_updates({});
+        }
+        if (demand_watcher) {
+            apply_demand();
+        }
+        // Process with empty signals to trigger periodic updates, plus the
+        // windows that ended while their input was silent. Sample times come
+        // from the steady clock at poll, so windows are closed against it too
+        std::vector<SignalUpdate> operator_updates;
+        if (operators.size() > 0) {
+            operators.tick(std::chrono::steady_clock::now());
+            take_operator_outputs(operator_updates);
+        }
+        std::vector<VSSSignal> vss_signals;
+        {
+            can2vss::ProfileScope dag_scope(profiler.get(), can2vss::ProfileStage::DAG);
+            vss_signals = processor.process_signal_updates(operator_updates);
+        }
 
-            if (!vss_signals.empty()) {
+        if (!vss_signals.empty()) {
+            if (rt_safe) {
+                rt_log.vlog(2, "Periodic processing produced signals: ", {},
+                            static_cast<int64_t>(vss_signals.size()));
+            } else {
                 VLOG(2) << "Periodic processing produced " << vss_signals.size() << " signals";
             }
+        }
 
-            // Publish to KUKSA using pre-resolved handles
-            for (const auto& vss : vss_signals) {
-                VSSFormatter::log_vss_signal(vss);
+        publish_signals(vss_signals);
+#ifdef CAN2VSS_GENERATED_DAG
+        // Compiled-in values held by interval_ms whose interval has ended
+        publish_typed(processor.typed_signals());
+#endif
+    };
+
+    auto note_first_signal = [&]() {
+        if (first_signal_pending && metric_vss_signals.get() > 0) {
+            first_signal_pending = false;
+            const auto since_start =
+                std::chrono::duration_cast<std::chrono::milliseconds>(startup.elapsed()).count();
+            if (rt_safe) {
+                rt_log.log(can2vss::RtLogSeverity::INFO, "First VSS signal queued, ms after start: ", {},
+                           since_start);
+            } else {
+                LOG(INFO) << "First VSS signal queued " << since_start << " ms after start";
+            }
+        }
+    };
 
-                auto it = signal_handles.find(vss.path);
-                if (it != signal_handles.end()) {
-                    publish_to_kuksa(client.get(), it->second, vss);
+    if (async_mode) {
+        // Every source is a coroutine that sleeps until its socket is
+        // readable (or, for sources without one, its poll interval passes)
+        // and periodic evaluation is a coroutine on a timer. All of them run
+        // on this thread, so they share the DAG without locks and the thread
+        // only wakes when there is work.
+        auto receive = [&](CanSource& source) -> can2vss::Task {
+            const int fd = source_fd(source);
+            auto next_poll = std::chrono::steady_clock::now();
+            while (g_running) {
+                if (fd >= 0) {
+                    co_await event_loop.readable(fd);
                 } else {
-                    VLOG(1) << "Skipping signal " << vss.path << " (not in KUKSA VSS tree)";
+                    next_poll += processing_interval;
+                    co_await event_loop.sleep_until(next_poll);
                 }
+                const auto loop_start = std::chrono::steady_clock::now();
+                RtViolationScope rt_scope(rt_safe, rt_violations);
+                const size_t polled = poll_and_process(source, loop_start);
+                metric_polls.add();
+                metric_updates.add(static_cast<int64_t>(polled));
+                note_first_signal();
+            }
+        };
+        auto tick = [&]() -> can2vss::Task {
+            auto next_tick = std::chrono::steady_clock::now();
+            while (g_running) {
+                next_tick += periodic_interval;
+                co_await event_loop.sleep_until(next_tick);
+                RtViolationScope rt_scope(rt_safe, rt_violations);
+                process_periodic();
+                note_first_signal();
             }
+        };
+
+        size_t readiness_sources = 0;
+        for (auto& source : can_sources) {
+            readiness_sources += source_fd(*source) >= 0 ? 1 : 0;
+            receive(*source);
+        }
+        tick();
+        LOG(INFO) << "Async mode: " << readiness_sources << " of " << can_sources.size()
+                  << " sources wait for socket readiness, the rest poll every "
+                  << processing_interval.count() << " ms";
+
+        g_event_loop = &event_loop;
+        if (g_running) {
+            event_loop.run();
+        }
+        g_event_loop = nullptr;
+    }
 
+    // Main processing loop - poll signal sources
+    auto last_periodic_check = std::chrono::steady_clock::now();
+    auto last_poll = last_periodic_check;
+
+    while (!async_mode && g_running) {
+        auto loop_start = std::chrono::steady_clock::now();
+        RtViolationScope rt_scope(rt_safe, rt_violations);
+        const auto since_last_poll = loop_start - last_poll;
+        last_poll = loop_start;
+        if (low_latency) {
+            poll_gap_histogram.record(since_last_poll);
+        }
+
+        // Poll signal sources for updates and process them (if any)
+        const size_t polled = poll_and_process(*can_source, loop_start);
+        metric_polls.add();
+        metric_updates.add(static_cast<int64_t>(polled));
+
+        // Check for periodic processing
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_periodic_check >= periodic_interval) {
+            process_periodic();
             last_periodic_check = now;
         }
 
-        // Sleep for remainder of interval if we finished early
+        note_first_signal();
+
+        if (idle_detector) {
+            if (polled > 0) {
+                idle_detector->note_activity(loop_start);
+            } else if (g_running && idle_detector->bus_silent(now)) {
+                if (rt_safe) {
+                    rt_log.log(can2vss::RtLogSeverity::INFO, "CAN bus silent, suspending until traffic resumes");
+                } else {
+                    LOG(INFO) << "CAN bus silent for " << options->idle_after_s
+                              << "s, suspending until traffic resumes";
+                }
+                metric_idle_entries.add();
+
+                bool resumed = idle_detector->wait_for_traffic();
+
+                // Restore loop state as if starting fresh: restart the
+                // periodic timer and let the poll controller re-learn the rate
+                auto resume_time = std::chrono::steady_clock::now();
+                metric_idle_ms.add(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    resume_time - now).count());
+                last_periodic_check = resume_time;
+                last_poll = resume_time;
+                poll_controller = can2vss::AdaptivePollController();
+                if (resumed) {
+                    if (rt_safe) {
+                        rt_log.log(can2vss::RtLogSeverity::INFO, "CAN traffic resumed");
+                    } else {
+                        LOG(INFO) << "CAN traffic resumed";
+                    }
+                }
+                continue;
+            }
+        }
+
+        // Busy-poll in low-latency mode, otherwise sleep for remainder of
+        // interval if we finished early
+        if (low_latency) {
+            continue;
+        }
+        std::chrono::steady_clock::duration interval = processing_interval;
+        if (adaptive_poll) {
+            interval = poll_controller.update(polled, since_last_poll,
+                                              publish_lanes->latency());
+            // Never sleep past the next periodic check
+            interval = std::min(interval, last_periodic_check + periodic_interval - loop_start);
+
+            metric_poll_wait.set(std::chrono::duration_cast<std::chrono::microseconds>(interval).count());
+            metric_arrival_rate.set(static_cast<int64_t>(poll_controller.arrival_rate()));
+            metric_expected_batch.set(static_cast<int64_t>(poll_controller.expected_batch()));
+        }
         auto loop_duration = std::chrono::steady_clock::now() - loop_start;
-        if (loop_duration < processing_interval) {
-            std::this_thread::sleep_for(processing_interval - loop_duration);
+        if (loop_duration < interval) {
+            std::this_thread::sleep_for(interval - loop_duration);
         }
     }
 
-    // Stop signal source
-    can_source->stop();
+    g_idle_wake_fd = -1;
+
+    if (g_received_signal != 0) {
+        LOG(INFO) << "Received signal " << g_received_signal.load() << ", shutting down...";
+    }
+
+    // Stop the demand watcher before the sources whose filters it narrows
+    if (demand_watcher) {
+        demand_watcher->stop();
+    }
+
+    // Stop signal sources
+    for (auto& thread : source_threads) {
+        thread->stop();
+    }
+    for (auto& source : can_sources) {
+        source->stop();
+    }
+
+    publish_lanes->stop();
+    metrics_reporter.stop();
+
+    if (rt_safe) {
+        rt_log.stop();
+        if (rt_violations > 0) {
+            LOG(WARNING) << "RT-safe mode: " << rt_violations << " heap operations on the loop thread";
+        } else {
+            LOG(INFO) << "RT-safe mode: no heap operations on the loop thread";
+        }
+    }
+
+    if (low_latency) {
+        LOG(INFO) << poll_gap_histogram.summary();
+        LOG(INFO) << decode_histogram.summary();
+    }
+
+    if (profiler) {
+        LOG(INFO) << profiler->report();
+        if (profiler->write_chrome_trace(options->profile_trace)) {
+            LOG(INFO) << "Wrote Chrome trace of the last loop stages to " << options->profile_trace;
+        } else {
+            LOG(ERROR) << "Failed to write Chrome trace to " << options->profile_trace;
+        }
+    }
+
+    if (memory_budget > 0) {
+        const int64_t peak = can2vss::peak_rss_bytes();
+        if (peak > memory_budget) {
+            LOG(WARNING) << "Peak RSS " << can2vss::format_bytes(peak) << " exceeded the memory budget of "
+                         << can2vss::format_bytes(memory_budget);
+        } else {
+            LOG(INFO) << "Peak RSS " << can2vss::format_bytes(peak) << " of "
+                      << can2vss::format_bytes(memory_budget) << " budget";
+        }
+    }
 
     LOG(INFO) << "CAN to VSS DAG converter with KUKSA feeder stopped";
     return 0;
@@ -0,0 +1,243 @@
+/**
+ * @file mapping_loader.cpp
+ * @brief Reads the mapping YAML into libvssdag signal mappings
+ */
+
+#include "mapping_loader.h"
+
+#include <glog/logging.h>
+
+#include <optional>
+
+namespace can2vss {
+
+using vssdag::CodeTransform;
+using vssdag::DirectMapping;
+using vssdag::SignalMapping;
+using vssdag::UpdateTrigger;
+using vssdag::ValueMapping;
+using vss::types::ValueType;
+
+namespace {
+
+absl::StatusOr<OperatorSpec> parse_operator(const std::string& signal_name, const YAML::Node& mapping_node,
+                                            const std::string& key, OperatorSpec::Kind kind) {
+    OperatorSpec spec;
+    spec.name = signal_name;
+    spec.kind = kind;
+
+    // One input: a CAN signal as source, or another operator as the only dependency
+    const auto& source = mapping_node["source"];
+    const auto& depends_on = mapping_node["depends_on"];
+    if (source && source["name"] && !depends_on) {
+        spec.input = source["name"].as<std::string>();
+    } else if (!source && depends_on && depends_on.size() == 1) {
+        spec.input = depends_on[0].as<std::string>();
+        spec.input_is_operator = true;
+    } else {
+        return absl::InvalidArgumentError("Operator " + signal_name +
+                                          " needs either a source or a single operator in depends_on");
+    }
+
+    const YAML::Node& config = mapping_node["transform"][key];
+    switch (kind) {
+        case OperatorSpec::Kind::WINDOW: {
+            const std::string function = config["function"].as<std::string>("mean");
+            auto parsed = window_function_from_string(function);
+            if (!parsed) {
+                return absl::InvalidArgumentError("Unknown window function '" + function + "' for signal " +
+                                                  signal_name);
+            }
+            spec.window.function = *parsed;
+            spec.window.duration_ms = config["duration_ms"].as<int>(spec.window.duration_ms);
+            spec.window.every_ms = config["every_ms"].as<int>(spec.window.every_ms);
+            spec.window.max_samples = config["max_samples"].as<size_t>(spec.window.max_samples);
+            break;
+        }
+        case OperatorSpec::Kind::DERIVATIVE:
+            spec.derivative.scale = config["scale"].as<double>(spec.derivative.scale);
+            spec.derivative.min_interval_ms = config["min_interval_ms"].as<int>(spec.derivative.min_interval_ms);
+            break;
+        case OperatorSpec::Kind::INTEGRAL:
+            spec.integral.scale = config["scale"].as<double>(spec.integral.scale);
+            spec.integral.max_gap_ms = config["max_gap_ms"].as<int>(spec.integral.max_gap_ms);
+            break;
+        case OperatorSpec::Kind::LOW_PASS:
+            spec.low_pass.time_constant_ms = config["time_constant_ms"].as<int>(spec.low_pass.time_constant_ms);
+            break;
+        case OperatorSpec::Kind::MEDIAN:
+            spec.median.samples = config["samples"].as<size_t>(spec.median.samples);
+            break;
+        case OperatorSpec::Kind::EVENT:
+            // The threshold key names the direction
+            if (config["above"] && !config["below"]) {
+                spec.event.trigger = EventSpec::Trigger::ABOVE;
+                spec.event.threshold = config["above"].as<double>();
+            } else if (config["below"] && !config["above"]) {
+                spec.event.trigger = EventSpec::Trigger::BELOW;
+                spec.event.threshold = config["below"].as<double>();
+            } else {
+                return absl::InvalidArgumentError("Event " + signal_name +
+                                                  " needs either an above or a below threshold");
+            }
+            spec.event.hysteresis = config["hysteresis"].as<double>(spec.event.hysteresis);
+            spec.event.min_duration_ms = config["min_duration_ms"].as<int>(spec.event.min_duration_ms);
+            spec.event.cooldown_ms = config["cooldown_ms"].as<int>(spec.event.cooldown_ms);
+            break;
+    }
+    return spec;
+}
+
+}  // namespace
+
+const std::string* MappingConfig::operator_can_input(const std::string& signal_name) const {
+    auto it = operators.find(signal_name);
+    if (it == operators.end() || it->second.input_is_operator) {
+        return nullptr;
+    }
+    return &it->second.input;
+}
+
+absl::StatusOr<MappingConfig> load_mappings(const YAML::Node& root) {
+    if (!root["mappings"]) {
+        return absl::InvalidArgumentError("No 'mappings' section found in YAML file");
+    }
+
+    MappingConfig config;
+    for (const auto& mapping_node : root["mappings"]) {
+        if (!mapping_node["signal"]) {
+            continue;
+        }
+
+        std::string signal_name = mapping_node["signal"].as<std::string>();
+
+        SignalMapping mapping;
+
+        // Parse source information if present
+        if (mapping_node["source"]) {
+            const auto& source_node = mapping_node["source"];
+            mapping.source.type = source_node["type"].as<std::string>();
+            mapping.source.name = source_node["name"].as<std::string>();
+        }
+        // Parse datatype - no default, must be specified
+        if (mapping_node["datatype"]) {
+            std::string datatype_str = mapping_node["datatype"].as<std::string>();
+            auto datatype_opt = vss::types::value_type_from_string(datatype_str);
+            if (datatype_opt.has_value()) {
+                mapping.datatype = *datatype_opt;
+            } else {
+                LOG(WARNING) << "Unknown datatype '" << datatype_str << "' for signal " << signal_name;
+                mapping.datatype = ValueType::UNSPECIFIED;
+            }
+        } else {
+            LOG(WARNING) << "No datatype specified for signal " << signal_name << ", using UNSPECIFIED";
+            mapping.datatype = ValueType::UNSPECIFIED;
+        }
+        mapping.interval_ms = mapping_node["interval_ms"].as<int>(0);
+
+        // Check if this is a struct type
+        if (mapping.datatype == ValueType::STRUCT) {
+            mapping.is_struct = true;
+            if (mapping_node["struct_type"]) {
+                mapping.struct_type = mapping_node["struct_type"].as<std::string>();
+            }
+        }
+
+        // DAG support
+        if (mapping_node["depends_on"]) {
+            for (const auto& dep : mapping_node["depends_on"]) {
+                mapping.depends_on.push_back(dep.as<std::string>());
+            }
+        }
+
+        // Operator nodes: the operator stage computes the value, the DAG
+        // takes it as an input named after the signal and publishes it
+        std::optional<OperatorSpec::Kind> operator_kind;
+        std::string operator_key;
+        if (mapping_node["transform"] && mapping_node["transform"].IsMap()) {
+            for (const auto& entry : mapping_node["transform"]) {
+                operator_key = entry.first.as<std::string>();
+                if ((operator_kind = operator_kind_from_key(operator_key))) {
+                    break;
+                }
+            }
+        }
+        if (operator_kind) {
+            auto spec = parse_operator(signal_name, mapping_node, operator_key, *operator_kind);
+            if (!spec.ok()) {
+                return spec.status();
+            }
+            config.operators[signal_name] = std::move(*spec);
+            mapping.source.type = std::string(kOperatorSourceType);
+            mapping.source.name = signal_name;
+            mapping.depends_on.clear();
+            mapping.transform = DirectMapping{};
+        } else if (mapping_node["transform"]) {
+            // Parse transform (simplified for now)
+            const YAML::Node& transform = mapping_node["transform"];
+            if (transform["code"]) {
+                mapping.transform = CodeTransform{transform["code"].as<std::string>()};
+            } else if (transform["math"]) {
+                // Keep backward compatibility
+                mapping.transform = CodeTransform{transform["math"].as<std::string>()};
+            } else if (transform["mapping"]) {
+                ValueMapping value_map;
+                for (const auto& item : transform["mapping"]) {
+                    std::string from = item["from"].as<std::string>();
+                    std::string to = item["to"].as<std::string>();
+                    value_map.mappings[from] = to;
+                }
+                mapping.transform = value_map;
+            } else {
+                mapping.transform = DirectMapping{};
+            }
+        } else {
+            mapping.transform = DirectMapping{};
+        }
+
+        // Parse update trigger
+        if (mapping_node["update_trigger"]) {
+            std::string trigger = mapping_node["update_trigger"].as<std::string>();
+            if (trigger == "periodic") {
+                mapping.update_trigger = UpdateTrigger::PERIODIC;
+            } else if (trigger == "both") {
+                mapping.update_trigger = UpdateTrigger::BOTH;
+            } else {
+                mapping.update_trigger = UpdateTrigger::ON_DEPENDENCY;
+            }
+        }
+
+        // Publish priority (feeder-side, not part of the DAG mapping)
+        if (mapping_node["priority"]) {
+            std::string priority_str = mapping_node["priority"].as<std::string>();
+            auto priority = signal_priority_from_string(priority_str);
+            if (priority.has_value()) {
+                config.priorities[signal_name] = *priority;
+            } else {
+                LOG(WARNING) << "Unknown priority '" << priority_str << "' for signal "
+                             << signal_name << ", using normal";
+            }
+        }
+
+        config.mappings[signal_name] = std::move(mapping);
+    }
+    return config;
+}
+
+absl::StatusOr<YAML::Node> read_mapping_yaml(const std::string& path) {
+    try {
+        return YAML::LoadFile(path);
+    } catch (const YAML::Exception& e) {
+        return absl::InvalidArgumentError(std::string("Failed to read mapping file ") + path + ": " + e.what());
+    }
+}
+
+absl::StatusOr<MappingConfig> load_mappings_file(const std::string& path) {
+    auto root = read_mapping_yaml(path);
+    if (!root.ok()) {
+        return root.status();
+    }
+    return load_mappings(*root);
+}
+
+}  // namespace can2vss
@@ -0,0 +1,52 @@
+/**
+ * @file mapping_loader.h
+ * @brief Reads the mapping YAML into libvssdag signal mappings
+ */
+
+#pragma once
+
+#include "signal_operators.h"
+#include "signal_priority.h"
+#include "vssdag/signal_processor.h"
+
+#include <absl/status/statusor.h>
+#include <yaml-cpp/yaml.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace can2vss {
+
+/**
+ * @brief The mapping YAML: DAG mappings plus feeder-side settings
+ */
+struct MappingConfig {
+    std::unordered_map<std::string, vssdag::SignalMapping> mappings;
+    std::unordered_map<std::string, SignalPriority> priorities;  ///< Signals with a `priority:`
+    /// Operator nodes; their mappings are fed by the operator stage (source type "operator")
+    std::unordered_map<std::string, OperatorSpec> operators;
+
+    /// CAN signal an operator node reads, or nullptr if it is not one or reads another operator
+    const std::string* operator_can_input(const std::string& signal_name) const;
+};
+
+/**
+ * @brief Converts a parsed mapping YAML document
+ *
+ * Entries without `signal` are skipped; unknown datatypes and priorities are
+ * logged and fall back to UNSPECIFIED and normal priority. Operator
+ * transforms (`window:`) become an OperatorSpec plus a direct mapping from
+ * the operator's output.
+ *
+ * @return Mappings, or an error if there is no `mappings` section or an
+ *         operator is misconfigured
+ */
+absl::StatusOr<MappingConfig> load_mappings(const YAML::Node& root);
+
+/// Parses a mapping YAML file without converting it
+absl::StatusOr<YAML::Node> read_mapping_yaml(const std::string& path);
+
+/// Reads and converts a mapping YAML file
+absl::StatusOr<MappingConfig> load_mappings_file(const std::string& path);
+
+}  // namespace can2vss
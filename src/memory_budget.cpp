@@ -0,0 +1,139 @@
+/**
+ * @file memory_budget.cpp
+ * @brief Memory footprint accounting by subsystem and buffer sizing under a budget
+ */
+
+#include "memory_budget.h"
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace can2vss {
+
+namespace {
+
+int64_t demand_bytes(const BufferDemand& demand, size_t entries) {
+    return static_cast<int64_t>(demand.entry_bytes * entries * demand.count);
+}
+
+}  // namespace
+
+MemoryUsage current_memory_usage() {
+    MemoryUsage usage;
+    usage.heap_bytes = thread_heap_bytes();
+
+    if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+        long size_pages = 0;
+        long resident_pages = 0;
+        if (std::fscanf(statm, "%ld %ld", &size_pages, &resident_pages) == 2) {
+            usage.rss_bytes = static_cast<int64_t>(resident_pages) * sysconf(_SC_PAGESIZE);
+        }
+        std::fclose(statm);
+    }
+    return usage;
+}
+
+int64_t peak_rss_bytes() {
+    FILE* status = std::fopen("/proc/self/status", "r");
+    if (status == nullptr) {
+        return 0;
+    }
+    int64_t peak = 0;
+    char line[256];
+    while (std::fgets(line, sizeof(line), status) != nullptr) {
+        if (std::strncmp(line, "VmHWM:", 6) == 0) {
+            peak = std::strtoll(line + 6, nullptr, 10) * 1024;
+            break;
+        }
+    }
+    std::fclose(status);
+    return peak;
+}
+
+MemoryLedger::MemoryLedger() : accounting_(std::in_place) {
+    // Growing entries_ inside mark() would charge the ledger's own storage to
+    // the next subsystem; the feeder marks about a dozen phases
+    entries_.reserve(32);
+    last_ = current_memory_usage();
+}
+
+void MemoryLedger::mark(std::string subsystem) {
+    const auto now = current_memory_usage();
+    entries_.push_back({std::move(subsystem), now.rss_bytes - last_.rss_bytes, now.heap_bytes - last_.heap_bytes});
+    last_ = now;
+}
+
+std::string MemoryLedger::report() const {
+    std::string out = "Memory by subsystem (RSS growth / heap):\n";
+    char line[160];
+    for (const auto& entry : entries_) {
+        std::snprintf(line, sizeof(line), "  %-28s %12s %12s\n", entry.subsystem.c_str(),
+                      format_bytes(entry.rss_bytes).c_str(), format_bytes(entry.heap_bytes).c_str());
+        out += line;
+    }
+    std::snprintf(line, sizeof(line), "  %-28s %12s, peak %s", "RSS now", format_bytes(current_memory_usage().rss_bytes).c_str(),
+                  format_bytes(peak_rss_bytes()).c_str());
+    out += line;
+    return out;
+}
+
+absl::StatusOr<std::vector<size_t>> size_buffers(int64_t available_bytes,
+                                                 const std::vector<BufferDemand>& demands) {
+    std::vector<size_t> entries;
+    int64_t total = 0;
+    int64_t minimum = 0;
+    for (const auto& demand : demands) {
+        entries.push_back(demand.preferred_entries);
+        total += demand_bytes(demand, demand.preferred_entries);
+        minimum += demand_bytes(demand, demand.minimum_entries);
+    }
+    if (minimum > available_bytes) {
+        return absl::ResourceExhaustedError(absl::StrCat("buffers need at least ", format_bytes(minimum),
+                                                         " but only ", format_bytes(available_bytes),
+                                                         " of the memory budget is left"));
+    }
+
+    while (total > available_bytes) {
+        size_t largest = demands.size();
+        for (size_t i = 0; i < demands.size(); ++i) {
+            if (entries[i] / 2 < demands[i].minimum_entries) {
+                continue;
+            }
+            if (largest == demands.size() ||
+                demand_bytes(demands[i], entries[i]) > demand_bytes(demands[largest], entries[largest])) {
+                largest = i;
+            }
+        }
+        if (largest == demands.size()) {
+            // Every buffer is within a halving of its minimum: settle on the minimums
+            for (size_t i = 0; i < demands.size(); ++i) {
+                entries[i] = demands[i].minimum_entries;
+            }
+            break;
+        }
+        total -= demand_bytes(demands[largest], entries[largest] - entries[largest] / 2);
+        entries[largest] /= 2;
+    }
+    return entries;
+}
+
+std::string format_bytes(int64_t bytes) {
+    char text[32];
+    const double magnitude = static_cast<double>(bytes < 0 ? -bytes : bytes);
+    if (magnitude >= 1024.0 * 1024.0) {
+        std::snprintf(text, sizeof(text), "%.1f MiB", bytes / (1024.0 * 1024.0));
+    } else if (magnitude >= 1024.0) {
+        std::snprintf(text, sizeof(text), "%.1f KiB", bytes / 1024.0);
+    } else {
+        std::snprintf(text, sizeof(text), "%lld B", static_cast<long long>(bytes));
+    }
+    return text;
+}
+
+}  // namespace can2vss
@@ -0,0 +1,99 @@
+/**
+ * @file memory_budget.h
+ * @brief Memory footprint accounting by subsystem and buffer sizing under a budget
+ */
+
+#pragma once
+
+#include "alloc_tracker.h"
+
+#include "absl/status/statusor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief Process resident set and the calling thread's live C++ heap
+ */
+struct MemoryUsage {
+    int64_t rss_bytes = 0;
+    int64_t heap_bytes = 0;
+};
+
+/// Current RSS from /proc/self/statm and thread_heap_bytes()
+MemoryUsage current_memory_usage();
+
+/// High-water mark of the RSS (VmHWM), 0 if unavailable
+int64_t peak_rss_bytes();
+
+/**
+ * @brief Attributes startup memory growth to the subsystem that caused it
+ *
+ * Each mark() charges the RSS and heap growth since the previous mark (or
+ * construction) to the named subsystem, like StartupTimer does for time.
+ * Heap bytes only see C++ allocations on the calling thread; memory that C
+ * libraries take with malloc() (Lua states) or on their own threads (gRPC)
+ * shows up in the RSS column only. The ledger keeps heap accounting on for
+ * its thread from construction until close(), so call close() once startup
+ * is measured to take the cost off the hot path.
+ */
+class MemoryLedger {
+public:
+    struct Entry {
+        std::string subsystem;
+        int64_t rss_bytes = 0;
+        int64_t heap_bytes = 0;
+    };
+
+    MemoryLedger();
+
+    /// Charges the growth since the previous mark to subsystem
+    void mark(std::string subsystem);
+
+    /// Ends heap accounting; later marks only see RSS growth
+    void close() { accounting_.reset(); }
+
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    /// One line per subsystem, then current and peak RSS
+    std::string report() const;
+
+private:
+    std::optional<HeapAccountingScope> accounting_;
+    MemoryUsage last_;
+    std::vector<Entry> entries_;
+};
+
+/**
+ * @brief A preallocated buffer whose entry count can shrink to fit a budget
+ */
+struct BufferDemand {
+    std::string name;
+    size_t entry_bytes = 0;
+    size_t preferred_entries = 0;
+    size_t minimum_entries = 0;
+    size_t count = 1;  ///< Identical buffers sized together, e.g. one queue per priority
+};
+
+/**
+ * @brief Picks entry counts for buffers so they fit in available_bytes
+ *
+ * Starts from the preferred sizes and halves the largest buffer still above
+ * its minimum until the total fits, so power-of-two ring capacities stay
+ * powers of two.
+ *
+ * @return Entry count per demand, in order; ResourceExhausted if the
+ *         minimums alone exceed available_bytes
+ */
+absl::StatusOr<std::vector<size_t>> size_buffers(int64_t available_bytes,
+                                                 const std::vector<BufferDemand>& demands);
+
+/// Human-readable byte count, e.g. "12.3 MiB"
+std::string format_bytes(int64_t bytes);
+
+}  // namespace can2vss
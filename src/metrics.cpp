@@ -0,0 +1,94 @@
+/**
+ * @file metrics.cpp
+ * @brief Named counters and gauges with a periodic log reporter
+ */
+
+#include "metrics.h"
+
+#include <glog/logging.h>
+
+#include <sstream>
+#include <tuple>
+
+namespace can2vss {
+
+Metric& Metrics::metric(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [existing, metric] : metrics_) {
+        if (existing == name) {
+            return metric;
+        }
+    }
+    metrics_.emplace_back(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple());
+    return metrics_.back().second;
+}
+
+void Metrics::add_probe(const std::string& name, std::function<int64_t()> probe) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    probes_.emplace_back(name, std::move(probe));
+}
+
+std::vector<std::pair<std::string, int64_t>> Metrics::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<std::string, int64_t>> values;
+    values.reserve(metrics_.size() + probes_.size());
+    for (const auto& [name, metric] : metrics_) {
+        values.emplace_back(name, metric.get());
+    }
+    for (const auto& [name, probe] : probes_) {
+        values.emplace_back(name, probe());
+    }
+    return values;
+}
+
+std::string Metrics::format() const {
+    std::ostringstream out;
+    bool first = true;
+    for (const auto& [name, value] : snapshot()) {
+        out << (first ? "" : " ") << name << "=" << value;
+        first = false;
+    }
+    return out.str();
+}
+
+MetricsReporter::MetricsReporter(const Metrics& metrics, std::chrono::seconds interval)
+    : metrics_(metrics), interval_(interval) {}
+
+MetricsReporter::~MetricsReporter() {
+    stop();
+}
+
+void MetricsReporter::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_ || interval_.count() <= 0) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&MetricsReporter::run, this);
+}
+
+void MetricsReporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    LOG(INFO) << "Metrics: " << metrics_.format();
+}
+
+void MetricsReporter::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, interval_, [this] { return !running_; })) {
+        lock.unlock();
+        LOG(INFO) << "Metrics: " << metrics_.format();
+        lock.lock();
+    }
+}
+
+}  // namespace can2vss
@@ -0,0 +1,91 @@
+/**
+ * @file metrics.h
+ * @brief Named counters and gauges with a periodic log reporter
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief A single metric value; used both as counter (add) and gauge (set)
+ *
+ * Updates are relaxed atomic operations and safe from any thread, including
+ * the RT loop thread.
+ */
+class Metric {
+public:
+    void add(int64_t delta = 1) { value_.fetch_add(delta, std::memory_order_relaxed); }
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    int64_t get() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+/**
+ * @brief Registry of feeder metrics
+ *
+ * Metrics are registered during startup; the returned references stay valid
+ * for the registry's lifetime, so hot paths keep a `Metric&` and never look
+ * names up. Probes are read from the reporter thread and let components
+ * expose counters they already maintain.
+ */
+class Metrics {
+public:
+    /// Returns the metric with this name, creating it on first use
+    Metric& metric(const std::string& name);
+
+    /// Registers a value read on demand when a snapshot is taken
+    void add_probe(const std::string& name, std::function<int64_t()> probe);
+
+    /// Current values of all metrics and probes, in registration order
+    std::vector<std::pair<std::string, int64_t>> snapshot() const;
+
+    /// "name=value name=value ..." for one log line
+    std::string format() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::deque<std::pair<std::string, Metric>> metrics_;
+    std::vector<std::pair<std::string, std::function<int64_t()>>> probes_;
+};
+
+/**
+ * @brief Logs a metrics snapshot at a fixed interval from a background thread
+ */
+class MetricsReporter {
+public:
+    MetricsReporter(const Metrics& metrics, std::chrono::seconds interval);
+    ~MetricsReporter();
+
+    MetricsReporter(const MetricsReporter&) = delete;
+    MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+    void start();
+    void stop();
+
+private:
+    void run();
+
+    const Metrics& metrics_;
+    std::chrono::seconds interval_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_ = false;
+    std::thread thread_;
+};
+
+}  // namespace can2vss
@@ -0,0 +1,111 @@
+/**
+ * @file mpsc_queue.h
+ * @brief Bounded lock-free multi-producer/single-consumer queue
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief Bounded MPSC queue with preallocated slots
+ *
+ * Each slot carries a sequence number that tells producers and the consumer
+ * whose turn it is (D. Vyukov's bounded queue). Producers claim a position
+ * with one CAS on the head, so items pushed by one thread are dequeued in
+ * the order that thread pushed them. Push and pop never allocate or block.
+ * Any number of threads may push; exactly one thread may pop.
+ *
+ * @tparam T Slot type; must be default-constructible and move-assignable
+ */
+template <typename T>
+class MpscQueue {
+public:
+    /// @param capacity Minimum capacity, rounded up to a power of two
+    explicit MpscQueue(size_t capacity)
+        : mask_(round_up_pow2(capacity) - 1), slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /// @return false if the queue is full (item is left untouched)
+    bool try_push(T&& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[head & mask_];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - head);
+            if (lag == 0) {
+                if (head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(item);
+                    slot.sequence.store(head + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;  // the consumer has not freed this slot yet
+            } else {
+                head = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @return false if the queue is empty, or the next item is still being written
+    bool try_pop(T& out) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[tail & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1) {
+            return false;
+        }
+        out = std::move(slot.value);
+        slot.sequence.store(tail + mask_ + 1, std::memory_order_release);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Number of queued items; approximate while producers are pushing
+    size_t size_approx() const {
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_acquire) - tail;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    /// Bytes each unit of capacity takes, for memory budgeting
+    static constexpr size_t slot_bytes() { return sizeof(Slot); }
+
+private:
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    static constexpr size_t kCacheLine = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    // Shared by producers
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+
+    // Consumer-owned
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace can2vss
@@ -0,0 +1,480 @@
+/**
+ * @file publisher.cpp
+ * @brief Asynchronous KUKSA publish lanes
+ */
+
+#include "publisher.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace can2vss {
+
+namespace {
+
+// Main lane share per round: NORMAL signals get 4 slots for every BULK one.
+// HIGH only lands here when the fast lane is disabled and is then served first.
+constexpr unsigned kHighWeight = 16;
+constexpr unsigned kNormalWeight = 4;
+constexpr unsigned kBulkWeight = 1;
+
+// EWMA weight of a new publish latency sample
+constexpr double kLatencySmoothing = 0.05;
+
+// Publish stream: values per stream message, unacknowledged messages in
+// flight, how long to wait for an acknowledgement, and how long to publish
+// with set() after the stream failed before trying to open it again
+constexpr size_t kMaxStreamBatch = 256;
+constexpr uint64_t kStreamWindow = 8;
+constexpr auto kStreamAckTimeout = std::chrono::seconds(2);
+constexpr auto kStreamRetryInterval = std::chrono::seconds(30);
+
+}  // namespace
+
+Publisher::Publisher(std::string name, PublishBackend* backend, const std::vector<PublishQueueConfig>& queues)
+    : name_(std::move(name)), backend_(backend) {
+    std::vector<PublishQueueConfig> sorted = queues;
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.priority < b.priority;
+    });
+    for (const auto& config : sorted) {
+        queues_.push_back(std::make_unique<Queue>(config));
+        by_priority_[static_cast<size_t>(config.priority)] = queues_.back().get();
+    }
+}
+
+Publisher::~Publisher() {
+    stop();
+}
+
+void Publisher::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&Publisher::run, this);
+}
+
+void Publisher::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    sequence_.fetch_add(1, std::memory_order_release);
+    sequence_.notify_one();
+    room_.fetch_add(1, std::memory_order_release);
+    room_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    LOG(INFO) << "Publish lane '" << name_ << "' stopped: " << published() << " published, "
+              << failed() << " failed, " << dropped() << " dropped, " << blocked() << " blocked";
+}
+
+bool Publisher::serves(SignalPriority priority) const {
+    return by_priority_[static_cast<size_t>(priority)] != nullptr;
+}
+
+bool Publisher::enqueue(SignalPriority priority, PublishRequest&& request) {
+    Queue* queue = by_priority_[static_cast<size_t>(priority)];
+    if (!queue->ring.try_push(std::move(request)) && !wait_for_room(*queue, request)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    sequence_.fetch_add(1, std::memory_order_release);
+    sequence_.notify_one();
+    return true;
+}
+
+bool Publisher::wait_for_room(Queue& queue, PublishRequest& request) {
+    if (queue.full_policy == QueueFullPolicy::DROP) {
+        return false;
+    }
+    blocked_.fetch_add(1, std::memory_order_relaxed);
+    // A full ring has work for the lane, so it is not parked and takes a
+    // request soon; the wait ends with stop()
+    while (running_.load(std::memory_order_acquire)) {
+        const uint32_t seen = room_.load(std::memory_order_acquire);
+        producer_waiting_.store(true, std::memory_order_relaxed);
+        // Pairs with the fence in note_taken(): either the lane sees the
+        // flag, or this retry sees the slot it freed
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue.ring.try_push(std::move(request))) {
+            producer_waiting_.store(false, std::memory_order_relaxed);
+            return true;
+        }
+        room_.wait(seen, std::memory_order_acquire);
+    }
+    producer_waiting_.store(false, std::memory_order_relaxed);
+    return false;
+}
+
+void Publisher::note_taken() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (producer_waiting_.load(std::memory_order_relaxed)) {
+        producer_waiting_.store(false, std::memory_order_relaxed);
+        room_.fetch_add(1, std::memory_order_release);
+        room_.notify_one();
+    }
+}
+
+vss::types::Value to_vss_value(const TypedValue& value) {
+    switch (value.type) {
+        case SlotType::BOOL:
+            return value.b;
+        case SlotType::INT8:
+            return static_cast<int8_t>(value.i);
+        case SlotType::INT16:
+            return static_cast<int16_t>(value.i);
+        case SlotType::INT32:
+            return static_cast<int32_t>(value.i);
+        case SlotType::INT64:
+            return value.i;
+        case SlotType::UINT8:
+            return static_cast<uint8_t>(value.u);
+        case SlotType::UINT16:
+            return static_cast<uint16_t>(value.u);
+        case SlotType::UINT32:
+            return static_cast<uint32_t>(value.u);
+        case SlotType::UINT64:
+            return value.u;
+        case SlotType::FLOAT:
+            return value.f;
+        case SlotType::DOUBLE:
+            return value.d;
+        case SlotType::STRUCT:
+        case SlotType::NONE:
+            break;
+    }
+    return std::monostate{};
+}
+
+vss::types::Value to_vss_struct(const StructBuffer& structure, std::vector<TypedValue>& fields) {
+    const auto& schema = structure.fields();
+    fields.resize(schema.size());
+    if (!structure.load(fields.data())) {
+        return std::monostate{};
+    }
+    auto value = std::make_shared<vss::types::StructValue>(structure.type_name());
+    for (size_t i = 0; i < schema.size(); ++i) {
+        value->set_field(schema[i].name, to_vss_value(fields[i]));
+    }
+    return value;
+}
+
+const vss::types::QualifiedValue<vss::types::Value>& PublishValueCache::build(const PublishRequest& request) {
+    if (request.node >= values_.size()) {
+        values_.resize(request.node + 1);
+    }
+    auto& qualified_value = values_[request.node];
+
+    if (request.structure != nullptr) {
+        const auto& schema = request.structure->fields();
+        fields_.resize(schema.size());
+        if (request.structure->load(fields_.data())) {
+            using StructPtr = std::shared_ptr<vss::types::StructValue>;
+            StructPtr* held = qualified_value.value ? std::get_if<StructPtr>(&*qualified_value.value) : nullptr;
+            if (held == nullptr || *held == nullptr || held->use_count() > 1) {
+                qualified_value.value = std::make_shared<vss::types::StructValue>(request.structure->type_name());
+                held = std::get_if<StructPtr>(&*qualified_value.value);
+            }
+            for (size_t i = 0; i < schema.size(); ++i) {
+                (*held)->set_field(schema[i].name, to_vss_value(fields_[i]));
+            }
+        } else {
+            qualified_value.value = std::monostate{};
+        }
+    } else {
+        qualified_value.value = to_vss_value(request.typed);
+    }
+
+    qualified_value.quality = vss::types::SignalQuality::VALID;
+    // Stamp with the time the value was produced, not published
+    qualified_value.timestamp = std::chrono::system_clock::now() -
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::steady_clock::now() - request.enqueued_at);
+    return qualified_value;
+}
+
+void Publisher::publish(const PublishRequest& request) {
+    const vss::types::QualifiedValue<vss::types::Value>* qualified_value = &request.qualified_value;
+    if (request.typed.has_value()) {
+        qualified_value = &value_cache_.build(request);
+    }
+
+    if (!qualified_value->is_valid()) {
+        VLOG(3) << "Skipping invalid signal " << *request.path;
+        return;
+    }
+
+    if (streaming_.load(std::memory_order_relaxed)) {
+        batch_.push_back({request.handle, request.path, *qualified_value, request.enqueued_at});
+        if (batch_.size() >= kMaxStreamBatch) {
+            flush_batch();
+        }
+        return;
+    }
+    publish_unary(request, *qualified_value);
+}
+
+void Publisher::publish_unary(const PublishRequest& request,
+                              const vss::types::QualifiedValue<vss::types::Value>& value) {
+    auto status = backend_->set(request, value);
+    if (!status.ok()) {
+        LOG(ERROR) << "Failed to publish " << *request.path << ": " << status;
+        failed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    VLOG(2) << "Published " << *request.path;
+    published_.fetch_add(1, std::memory_order_relaxed);
+    record_latency(request.enqueued_at);
+}
+
+void Publisher::record_latency(std::chrono::steady_clock::time_point enqueued_at) {
+    // Only this lane's thread writes the latency estimate
+    auto sample = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - enqueued_at).count();
+    auto current = latency_ns_.load(std::memory_order_relaxed);
+    latency_ns_.store(current + static_cast<int64_t>(kLatencySmoothing * (sample - current)),
+                      std::memory_order_relaxed);
+}
+
+void Publisher::try_open_stream() {
+    auto status = backend_->open_stream();
+    if (status.ok()) {
+        streaming_.store(true, std::memory_order_relaxed);
+        batches_written_ = 0;
+        LOG(INFO) << "Publish lane '" << name_ << "' publishes over a stream";
+        return;
+    }
+    if (absl::IsUnimplemented(status)) {
+        // The backend has no stream; do not ask again
+        VLOG(1) << "Publish lane '" << name_ << "' publishes with unary set()";
+        next_stream_attempt_ = std::chrono::steady_clock::time_point::max();
+        return;
+    }
+    LOG(WARNING) << "Publish lane '" << name_ << "' can not open a stream, using unary set(): " << status;
+    next_stream_attempt_ = std::chrono::steady_clock::now() + kStreamRetryInterval;
+}
+
+void Publisher::close_stream(const absl::Status& status) {
+    LOG(WARNING) << "Publish lane '" << name_ << "' stream failed, falling back to unary set(): " << status;
+    streaming_.store(false, std::memory_order_relaxed);
+    batches_written_ = 0;
+    next_stream_attempt_ = std::chrono::steady_clock::now() + kStreamRetryInterval;
+}
+
+void Publisher::flush_batch() {
+    if (batch_.empty()) {
+        return;
+    }
+    // Client-side flow control: at most kStreamWindow batches unacknowledged
+    absl::Status status;
+    if (batches_written_ >= kStreamWindow &&
+        !backend_->wait_acknowledged(batches_written_ - kStreamWindow + 1, kStreamAckTimeout)) {
+        status = absl::DeadlineExceededError("publish stream acknowledgements stalled");
+    } else {
+        status = backend_->write_batch(batch_);
+    }
+    if (status.ok()) {
+        ++batches_written_;
+        published_.fetch_add(batch_.size(), std::memory_order_relaxed);
+        for (const auto& entry : batch_) {
+            record_latency(entry.enqueued_at);
+        }
+        batch_.clear();
+        return;
+    }
+
+    // Batches already written but not acknowledged are lost with the
+    // stream; the next update of each signal replaces them. This batch
+    // still goes out with set().
+    close_stream(status);
+    PublishRequest request;
+    for (const auto& entry : batch_) {
+        request.handle = entry.handle;
+        request.path = entry.path;
+        request.enqueued_at = entry.enqueued_at;
+        publish_unary(request, entry.value);
+    }
+    batch_.clear();
+}
+
+size_t Publisher::depth() const {
+    size_t total = 0;
+    for (const auto& queue : queues_) {
+        total += queue->ring.size_approx();
+    }
+    return total;
+}
+
+size_t Publisher::run_round(PublishRequest& request) {
+    size_t published = 0;
+    for (auto& queue : queues_) {
+        for (unsigned i = 0; i < queue->weight && queue->ring.try_pop(request); ++i) {
+            note_taken();
+            publish(request);
+            ++published;
+        }
+    }
+    return published;
+}
+
+void Publisher::run() {
+    PublishRequest request;
+    batch_.reserve(kMaxStreamBatch);
+    try_open_stream();
+    while (true) {
+        uint64_t seen = sequence_.load(std::memory_order_acquire);
+        while (run_round(request) > 0) {
+        }
+        flush_batch();
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+        if (!streaming_.load(std::memory_order_relaxed) &&
+            std::chrono::steady_clock::now() >= next_stream_attempt_) {
+            try_open_stream();
+        }
+        sequence_.wait(seen, std::memory_order_acquire);
+    }
+    // Flush whatever was queued before stop(), and let the broker confirm it
+    while (run_round(request) > 0) {
+    }
+    flush_batch();
+    if (streaming_.load(std::memory_order_relaxed) && batches_written_ > 0 &&
+        !backend_->wait_acknowledged(batches_written_, kStreamAckTimeout)) {
+        LOG(WARNING) << "Publish lane '" << name_ << "' stopped before the broker acknowledged every batch";
+    }
+}
+
+absl::StatusOr<std::unique_ptr<PublishLanes>> PublishLanes::create(
+    const std::string& kuksa_address, kuksa::Client* client, bool fast_lane, size_t queue_capacity,
+    int main_channels, QueueFullPolicy full_policy) {
+    std::unique_ptr<PublishLanes> lanes(new PublishLanes());
+
+    // Every lane but the first main lane opens its own client, and with it
+    // its own gRPC channel
+    auto add_backend = [&](kuksa::Client* lane_client) -> absl::StatusOr<PublishBackend*> {
+        if (lane_client == nullptr) {
+            auto client_result = kuksa::Client::create(kuksa_address);
+            if (!client_result.ok()) {
+                return client_result.status();
+            }
+            lanes->clients_.push_back(std::move(*client_result));
+            lane_client = lanes->clients_.back().get();
+        }
+        lanes->backends_.push_back(std::make_unique<KuksaPublishBackend>(lane_client));
+        return lanes->backends_.back().get();
+    };
+
+    std::vector<PublishBackend*> main_backends;
+    for (int channel = 0; channel < std::max(main_channels, 1); ++channel) {
+        auto backend = add_backend(channel == 0 ? client : nullptr);
+        if (!backend.ok()) {
+            return backend.status();
+        }
+        main_backends.push_back(*backend);
+    }
+    PublishBackend* fast_backend = nullptr;
+    if (fast_lane) {
+        auto backend = add_backend(nullptr);
+        if (!backend.ok()) {
+            return backend.status();
+        }
+        fast_backend = *backend;
+    }
+
+    lanes->add_lanes(main_backends, fast_backend, queue_capacity, full_policy);
+    return lanes;
+}
+
+std::unique_ptr<PublishLanes> PublishLanes::create(const std::vector<PublishBackend*>& main_backends,
+                                                   PublishBackend* fast_backend, size_t queue_capacity,
+                                                   QueueFullPolicy full_policy) {
+    std::unique_ptr<PublishLanes> lanes(new PublishLanes());
+    lanes->add_lanes(main_backends, fast_backend, queue_capacity, full_policy);
+    return lanes;
+}
+
+void PublishLanes::add_lanes(const std::vector<PublishBackend*>& main_backends, PublishBackend* fast_backend,
+                             size_t queue_capacity, QueueFullPolicy full_policy) {
+    std::vector<PublishQueueConfig> main_queues = {
+        {SignalPriority::NORMAL, kNormalWeight, queue_capacity, full_policy},
+        {SignalPriority::BULK, kBulkWeight, queue_capacity, full_policy},
+    };
+
+    if (fast_backend != nullptr) {
+        lanes_.push_back(std::make_unique<Publisher>(
+            "fast", fast_backend,
+            std::vector<PublishQueueConfig>{{SignalPriority::HIGH, kHighWeight, queue_capacity, full_policy}}));
+    } else {
+        main_queues.push_back({SignalPriority::HIGH, kHighWeight, queue_capacity, full_policy});
+    }
+    for (size_t i = 0; i < main_backends.size(); ++i) {
+        const std::string name = i == 0 ? "main" : "main" + std::to_string(i);
+        lanes_.push_back(std::make_unique<Publisher>(name, main_backends[i], main_queues));
+    }
+
+    for (auto priority : kAllSignalPriorities) {
+        for (auto& lane : lanes_) {
+            if (lane->serves(priority)) {
+                route_[static_cast<size_t>(priority)].push_back(lane.get());
+            }
+        }
+    }
+}
+
+void PublishLanes::start() {
+    for (auto& lane : lanes_) {
+        lane->start();
+    }
+}
+
+void PublishLanes::stop() {
+    for (auto& lane : lanes_) {
+        lane->stop();
+    }
+}
+
+std::chrono::nanoseconds PublishLanes::latency() const {
+    std::chrono::nanoseconds worst{0};
+    for (const auto& lane : lanes_) {
+        worst = std::max(worst, lane->latency());
+    }
+    return worst;
+}
+
+uint64_t PublishLanes::dropped() const {
+    uint64_t total = 0;
+    for (const auto& lane : lanes_) {
+        total += lane->dropped();
+    }
+    return total;
+}
+
+uint64_t PublishLanes::blocked() const {
+    uint64_t total = 0;
+    for (const auto& lane : lanes_) {
+        total += lane->blocked();
+    }
+    return total;
+}
+
+void PublishLanes::register_metrics(Metrics& metrics) const {
+    for (const auto& lane : lanes_) {
+        const Publisher* p = lane.get();
+        const std::string prefix = "publish." + p->name() + ".";
+        metrics.add_probe(prefix + "published", [p] { return static_cast<int64_t>(p->published()); });
+        metrics.add_probe(prefix + "failed", [p] { return static_cast<int64_t>(p->failed()); });
+        metrics.add_probe(prefix + "dropped", [p] { return static_cast<int64_t>(p->dropped()); });
+        metrics.add_probe(prefix + "blocked", [p] { return static_cast<int64_t>(p->blocked()); });
+        metrics.add_probe(prefix + "depth", [p] { return static_cast<int64_t>(p->depth()); });
+        metrics.add_probe(prefix + "streaming", [p] { return p->streaming() ? int64_t{1} : int64_t{0}; });
+        metrics.add_probe(prefix + "latency_us", [p] {
+            return std::chrono::duration_cast<std::chrono::microseconds>(p->latency()).count();
+        });
+    }
+}
+
+}  // namespace can2vss
@@ -0,0 +1,358 @@
+/**
+ * @file publisher.h
+ * @brief Asynchronous KUKSA publish lanes
+ */
+
+#pragma once
+
+#include "metrics.h"
+#include "signal_priority.h"
+#include "spsc_ring.h"
+#include "struct_buffer.h"
+#include "typed_value.h"
+
+#include <absl/status/statusor.h>
+#include <kuksa_cpp/client.hpp>
+#include <vss/types/quality.hpp>
+#include <vss/types/value.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief One queued publish: a pre-resolved handle and the value to set
+ *
+ * `handle` and `path` point into the feeder's handle table, which outlives
+ * the publisher, so queuing a request copies no strings. Compiled-in signals
+ * set `typed` instead of `qualified_value`, and `node` to their DAG node id;
+ * the lane converts the value. Compiled-in struct signals also set
+ * `structure`, which the lane loads the fields from.
+ */
+struct PublishRequest {
+    const kuksa::DynamicSignalHandle* handle = nullptr;
+    const std::string* path = nullptr;
+    vss::types::QualifiedValue<vss::types::Value> qualified_value;
+    std::chrono::steady_clock::time_point enqueued_at;
+    TypedValue typed;
+    const StructBuffer* structure = nullptr;
+    uint32_t node = 0;
+};
+
+/// Converts a typed slot value to the VSS value variant at the publish edge
+vss::types::Value to_vss_value(const TypedValue& value);
+
+/// Builds the VSS struct value from a struct signal's latest fields, loading them into `fields`
+vss::types::Value to_vss_struct(const StructBuffer& structure, std::vector<TypedValue>& fields);
+
+/**
+ * @brief Reusable publish values for typed requests, one per signal
+ *
+ * Converting a typed request into a fresh QualifiedValue per publish costs
+ * a new StructValue, with every field name copied, for each struct update.
+ * The cache keeps one pre-built value per DAG node, indexed by the request's
+ * node id, and overwrites only the value, fields and timestamp, so a signal
+ * it has seen before reuses its StructValue. Struct fields are loaded into
+ * one scratch vector shared by all signals. A struct value still referenced
+ * elsewhere, such as by a stream batch in flight, is replaced instead of
+ * modified. Lane thread only.
+ */
+class PublishValueCache {
+public:
+    /// Value to publish for a typed request; valid until the next build() for the same node
+    const vss::types::QualifiedValue<vss::types::Value>& build(const PublishRequest& request);
+
+    /// Nodes the cache has room for: one past the highest node id seen
+    size_t size() const { return values_.size(); }
+
+private:
+    std::vector<vss::types::QualifiedValue<vss::types::Value>> values_;
+    std::vector<TypedValue> fields_;  // load() target for struct signals
+};
+
+/**
+ * @brief One value of a batch written to a publish stream
+ */
+struct PublishEntry {
+    const kuksa::DynamicSignalHandle* handle = nullptr;
+    const std::string* path = nullptr;
+    vss::types::QualifiedValue<vss::types::Value> value;
+    std::chrono::steady_clock::time_point enqueued_at;
+};
+
+/**
+ * @brief Where a lane's set() calls go
+ *
+ * The feeder publishes through a KUKSA client; benchmarks substitute a fake
+ * broker. Called on the lane thread only.
+ *
+ * A backend may also offer a long-lived publish stream. The lane then writes
+ * each batch of queued values as one stream message, keeps up to a window
+ * of unacknowledged batches in flight, and falls back to set() per value
+ * whenever the stream can not be opened or fails.
+ */
+class PublishBackend {
+public:
+    virtual ~PublishBackend() = default;
+
+    virtual absl::Status set(const PublishRequest& request,
+                             const vss::types::QualifiedValue<vss::types::Value>& value) = 0;
+
+    /// Opens the publish stream; Unimplemented if the backend has none
+    virtual absl::Status open_stream() { return absl::UnimplementedError("no publish stream"); }
+
+    /**
+     * @brief Writes one batch as one stream message
+     *
+     * Returns once the message is handed to the transport; the broker
+     * acknowledges batches in write order. An error closes the stream.
+     */
+    virtual absl::Status write_batch(const std::vector<PublishEntry>& batch) {
+        (void)batch;
+        return absl::UnimplementedError("no publish stream");
+    }
+
+    /**
+     * @brief Waits until the broker acknowledged `batches` batches on the current stream
+     * @return false on timeout or if the stream failed
+     */
+    virtual bool wait_acknowledged(uint64_t batches, std::chrono::milliseconds timeout) {
+        (void)batches;
+        (void)timeout;
+        return false;
+    }
+};
+
+/**
+ * @brief Publishes with unary set() calls on a KUKSA client
+ */
+class KuksaPublishBackend : public PublishBackend {
+public:
+    explicit KuksaPublishBackend(kuksa::Client* client) : client_(client) {}
+
+    absl::Status set(const PublishRequest& request,
+                     const vss::types::QualifiedValue<vss::types::Value>& value) override {
+        return client_->set(*request.handle, value);
+    }
+
+private:
+    kuksa::Client* client_;
+};
+
+/**
+ * @brief What enqueue() does when the queue is full
+ */
+enum class QueueFullPolicy {
+    BLOCK,  ///< Wait until the lane has taken a request: backpressure on the loop, nothing lost
+    DROP,   ///< Drop the request and count it; the loop never waits
+};
+
+/**
+ * @brief A queue served by a Publisher and its share of each scheduling round
+ */
+struct PublishQueueConfig {
+    SignalPriority priority;
+    unsigned weight = 1;
+    size_t capacity = 4096;
+    QueueFullPolicy full_policy = QueueFullPolicy::BLOCK;
+};
+
+/**
+ * @brief One publish lane: a thread issuing set() calls on one backend
+ *
+ * Producers enqueue into per-priority lock-free rings; enqueue() never locks
+ * and only moves the value into a preallocated slot. A full ring either
+ * holds the producer back until the lane takes a request or drops. The lane thread serves
+ * its queues in weighted round-robin order, taking up to `weight` requests
+ * from each queue per round, highest priority first. Over a publish stream,
+ * the values taken while the queues are non-empty go out as one batch.
+ */
+class Publisher {
+public:
+    Publisher(std::string name, PublishBackend* backend, const std::vector<PublishQueueConfig>& queues);
+    ~Publisher();
+
+    Publisher(const Publisher&) = delete;
+    Publisher& operator=(const Publisher&) = delete;
+
+    void start();
+
+    /// Stops the lane thread after publishing everything already queued
+    void stop();
+
+    /**
+     * @brief Queues a request without locking or allocating
+     *
+     * On a full queue, waits for the lane to make room (BLOCK) or drops
+     * the request (DROP). A lane that is not running never makes room, so
+     * then the request is dropped either way.
+     *
+     * @return false if the request was dropped
+     */
+    bool enqueue(SignalPriority priority, PublishRequest&& request);
+
+    bool serves(SignalPriority priority) const;
+
+    const std::string& name() const { return name_; }
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t failed() const { return failed_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    /// Requests that had to wait for room in a full queue
+    uint64_t blocked() const { return blocked_.load(std::memory_order_relaxed); }
+
+    /// Smoothed enqueue-to-published latency of this lane
+    std::chrono::nanoseconds latency() const {
+        return std::chrono::nanoseconds(latency_ns_.load(std::memory_order_relaxed));
+    }
+
+    /// Requests currently queued across all priorities
+    size_t depth() const;
+
+    /// Whether the lane currently publishes over its backend's stream
+    bool streaming() const { return streaming_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        explicit Queue(const PublishQueueConfig& config)
+            : priority(config.priority),
+              weight(config.weight),
+              full_policy(config.full_policy),
+              ring(config.capacity) {}
+
+        SignalPriority priority;
+        unsigned weight;
+        QueueFullPolicy full_policy;
+        SpscRing<PublishRequest> ring;
+    };
+
+    bool wait_for_room(Queue& queue, PublishRequest& request);
+    void note_taken();
+    void run();
+    size_t run_round(PublishRequest& request);
+    void publish(const PublishRequest& request);
+    void publish_unary(const PublishRequest& request,
+                       const vss::types::QualifiedValue<vss::types::Value>& value);
+    void record_latency(std::chrono::steady_clock::time_point enqueued_at);
+    void try_open_stream();
+    void flush_batch();
+    void close_stream(const absl::Status& status);
+
+    std::string name_;
+    PublishBackend* backend_;
+    PublishValueCache value_cache_;
+    std::vector<std::unique_ptr<Queue>> queues_;          // highest priority first
+    std::array<Queue*, kSignalPriorityCount> by_priority_{};
+
+    // Bumped on every enqueue; the lane thread waits on it when idle
+    std::atomic<uint64_t> sequence_{0};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    // A producer blocked on a full queue waits on room_; the lane bumps it
+    // after taking a request while producer_waiting_ is set
+    std::atomic<uint32_t> room_{0};
+    std::atomic<bool> producer_waiting_{false};
+
+    // Publish stream state, lane thread only (except streaming_)
+    std::atomic<bool> streaming_{false};
+    std::vector<PublishEntry> batch_;
+    uint64_t batches_written_ = 0;
+    std::chrono::steady_clock::time_point next_stream_attempt_;
+
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> blocked_{0};
+    std::atomic<int64_t> latency_ns_{0};
+};
+
+/**
+ * @brief Routes publish requests to lanes by signal priority
+ *
+ * HIGH priority signals get a dedicated lane with its own KUKSA client, and
+ * therefore its own gRPC channel, so they never queue behind bulk telemetry
+ * on either the feeder or the HTTP/2 connection. NORMAL and BULK share the
+ * main lanes with weighted scheduling.
+ *
+ * There may be several main lanes, each with its own client and channel, so
+ * that several set() calls are in flight at once. A signal always goes to
+ * the same main lane (chosen by its handle table entry), which keeps its
+ * updates in order.
+ */
+class PublishLanes {
+public:
+    /**
+     * @param kuksa_address Broker address used to open the channels of the
+     *        fast lane and of main lanes beyond the first
+     * @param client Client used by the first main lane
+     * @param fast_lane Create a dedicated lane for HIGH priority signals;
+     *        otherwise HIGH is served first by the main lanes
+     * @param queue_capacity Requests each priority's queue holds
+     * @param main_channels Number of main lanes, each with its own channel
+     * @param full_policy What enqueue() does when a queue is full
+     */
+    static absl::StatusOr<std::unique_ptr<PublishLanes>> create(
+        const std::string& kuksa_address, kuksa::Client* client, bool fast_lane,
+        size_t queue_capacity = PublishQueueConfig{}.capacity, int main_channels = 1,
+        QueueFullPolicy full_policy = QueueFullPolicy::BLOCK);
+
+    /**
+     * @brief Lanes over caller-owned backends, e.g. fake brokers in benchmarks
+     *
+     * @param main_backends One main lane per backend
+     * @param fast_backend Backend of the HIGH priority lane, or nullptr to
+     *        serve HIGH on the main lanes
+     */
+    static std::unique_ptr<PublishLanes> create(const std::vector<PublishBackend*>& main_backends,
+                                                PublishBackend* fast_backend,
+                                                size_t queue_capacity = PublishQueueConfig{}.capacity,
+                                                QueueFullPolicy full_policy = QueueFullPolicy::BLOCK);
+
+    void start();
+    void stop();
+
+    /// Worst smoothed publish latency across lanes
+    std::chrono::nanoseconds latency() const;
+
+    /// Sum of dropped requests across lanes
+    uint64_t dropped() const;
+
+    /// Sum of requests that waited for room in a full queue across lanes
+    uint64_t blocked() const;
+
+    /// Exposes per-lane published/failed/dropped/blocked/depth/latency as metric probes
+    void register_metrics(Metrics& metrics) const;
+
+    /// Lock-free and allocation free, see Publisher::enqueue(); @return false if the request was dropped
+    bool enqueue(SignalPriority priority, PublishRequest&& request) {
+        const auto& lanes = route_[static_cast<size_t>(priority)];
+        Publisher* lane = lanes.size() == 1 ? lanes.front() : lanes[lane_of(request.path, lanes.size())];
+        return lane->enqueue(priority, std::move(request));
+    }
+
+private:
+    PublishLanes() = default;
+
+    /// Spreads handle table entries over count lanes (Fibonacci hashing)
+    static size_t lane_of(const void* key, size_t count) {
+        const auto hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>((hash >> 32) % count);
+    }
+
+    void add_lanes(const std::vector<PublishBackend*>& main_backends, PublishBackend* fast_backend,
+                   size_t queue_capacity, QueueFullPolicy full_policy);
+
+    std::vector<std::unique_ptr<kuksa::Client>> clients_;
+    std::vector<std::unique_ptr<PublishBackend>> backends_;
+    std::vector<std::unique_ptr<Publisher>> lanes_;
+    std::array<std::vector<Publisher*>, kSignalPriorityCount> route_{};
+};
+
+}  // namespace can2vss
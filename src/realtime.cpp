@@ -0,0 +1,70 @@
+/**
+ * @file realtime.cpp
+ * @brief Thread placement and scheduling helpers for the low-latency RX mode
+ */
+
+#include "realtime.h"
+
+#include <glog/logging.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <cerrno>
+#include <cstring>
+
+namespace can2vss {
+
+namespace {
+
+bool pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        LOG(WARNING) << "Failed to pin RX thread to CPU " << cpu << ": " << std::strerror(rc);
+        return false;
+    }
+    LOG(INFO) << "RX thread pinned to CPU " << cpu;
+    return true;
+}
+
+bool set_fifo_priority(int priority) {
+    sched_param param{};
+    param.sched_priority = priority;
+    int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc != 0) {
+        LOG(WARNING) << "Failed to set SCHED_FIFO priority " << priority << ": "
+                     << std::strerror(rc) << " (requires CAP_SYS_NICE)";
+        return false;
+    }
+    LOG(INFO) << "RX thread running with SCHED_FIFO priority " << priority;
+    return true;
+}
+
+bool lock_memory() {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        LOG(WARNING) << "mlockall failed: " << std::strerror(errno) << " (requires CAP_IPC_LOCK)";
+        return false;
+    }
+    LOG(INFO) << "Process memory locked";
+    return true;
+}
+
+}  // namespace
+
+bool apply_realtime_settings(const LowLatencyOptions& options) {
+    bool ok = true;
+    if (options.rx_cpu >= 0) {
+        ok &= pin_to_cpu(options.rx_cpu);
+    }
+    if (options.rt_priority > 0) {
+        ok &= set_fifo_priority(options.rt_priority);
+    }
+    if (options.lock_memory) {
+        ok &= lock_memory();
+    }
+    return ok;
+}
+
+}  // namespace can2vss
@@ -0,0 +1,24 @@
+/**
+ * @file realtime.h
+ * @brief Thread placement and scheduling helpers for the low-latency RX mode
+ */
+
+#pragma once
+
+#include "feeder_options.h"
+
+namespace can2vss {
+
+/**
+ * @brief Applies CPU pinning, SCHED_FIFO and memory locking to the calling thread
+ *
+ * Each setting is applied independently; failures (typically missing
+ * CAP_SYS_NICE / CAP_IPC_LOCK) are logged and reported but do not undo the
+ * settings that did succeed.
+ *
+ * @param options Low-latency settings from the command line
+ * @return true if every requested setting was applied
+ */
+bool apply_realtime_settings(const LowLatencyOptions& options);
+
+}  // namespace can2vss
@@ -0,0 +1,159 @@
+/**
+ * @file rt_log.cpp
+ * @brief Deferred logging for the real-time thread
+ */
+
+#include "rt_log.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ostream>
+
+namespace can2vss {
+
+namespace {
+
+constexpr auto kDrainInterval = std::chrono::milliseconds(5);
+constexpr int kParkAfterEmptyDrains = 200;  // ~1 s without records
+
+void write_record(std::ostream& os, const RtLogRecord& record) {
+    os << record.message << record.subject;
+    if (record.has_value) {
+        os << " (" << record.value << ")";
+    }
+}
+
+void emit(const RtLogRecord& record) {
+    switch (record.severity) {
+        case RtLogSeverity::VERBOSE:
+            if (VLOG_IS_ON(record.verbosity)) {
+                write_record(LOG(INFO), record);
+            }
+            break;
+        case RtLogSeverity::INFO:
+            write_record(LOG(INFO), record);
+            break;
+        case RtLogSeverity::WARNING:
+            write_record(LOG(WARNING), record);
+            break;
+        case RtLogSeverity::ERROR:
+            write_record(LOG(ERROR), record);
+            break;
+    }
+}
+
+}  // namespace
+
+RtLogger::RtLogger(size_t capacity)
+    : ring_(capacity),
+      // Read once here: evaluating VLOG_IS_ON on the RT thread may take a lock
+      max_verbosity_(FLAGS_v) {}
+
+RtLogger::~RtLogger() {
+    stop();
+}
+
+void RtLogger::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&RtLogger::drain_loop, this);
+}
+
+void RtLogger::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    sequence_.fetch_add(1);
+    sequence_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    drain();
+    if (dropped() > 0) {
+        LOG(WARNING) << "RT logger dropped " << dropped() << " records (ring full)";
+    }
+}
+
+void RtLogger::log(RtLogSeverity severity, const char* message, std::string_view subject) {
+    push(severity, 0, message, subject, 0, false);
+}
+
+void RtLogger::log(RtLogSeverity severity, const char* message, std::string_view subject, int64_t value) {
+    push(severity, 0, message, subject, value, true);
+}
+
+void RtLogger::vlog(int verbosity, const char* message, std::string_view subject) {
+    if (verbosity <= max_verbosity_) {
+        push(RtLogSeverity::VERBOSE, verbosity, message, subject, 0, false);
+    }
+}
+
+void RtLogger::vlog(int verbosity, const char* message, std::string_view subject, int64_t value) {
+    if (verbosity <= max_verbosity_) {
+        push(RtLogSeverity::VERBOSE, verbosity, message, subject, value, true);
+    }
+}
+
+void RtLogger::push(RtLogSeverity severity, int verbosity, const char* message,
+                    std::string_view subject, int64_t value, bool has_value) {
+    RtLogRecord record;
+    record.severity = severity;
+    record.verbosity = verbosity;
+    record.message = message;
+    size_t len = std::min(subject.size(), RtLogRecord::kSubjectSize - 1);
+    std::memcpy(record.subject, subject.data(), len);
+    record.subject[len] = '\0';
+    record.value = value;
+    record.has_value = has_value;
+
+    if (!ring_.try_push(std::move(record))) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    sequence_.fetch_add(1);
+    if (parked_.load()) {
+        sequence_.notify_one();
+    }
+}
+
+size_t RtLogger::drain() {
+    size_t n = 0;
+    RtLogRecord record;
+    while (ring_.try_pop(record)) {
+        emit(record);
+        ++n;
+    }
+    return n;
+}
+
+void RtLogger::drain_loop() {
+    int empty_drains = 0;
+    while (running_.load()) {
+        if (drain() > 0) {
+            empty_drains = 0;
+            continue;
+        }
+        if (++empty_drains < kParkAfterEmptyDrains) {
+            std::this_thread::sleep_for(kDrainInterval);
+            continue;
+        }
+
+        // Park until a producer pushes. parked_ is published before the
+        // final emptiness check, and producers bump sequence_ before reading
+        // parked_, so a record pushed in between is either seen here or
+        // followed by a notify.
+        uint32_t seen = sequence_.load();
+        parked_.store(true);
+        if (ring_.size_approx() == 0 && running_.load()) {
+            sequence_.wait(seen);
+        }
+        parked_.store(false);
+        empty_drains = 0;
+    }
+}
+
+}  // namespace can2vss
@@ -0,0 +1,92 @@
+/**
+ * @file rt_log.h
+ * @brief Deferred logging for the real-time thread
+ */
+
+#pragma once
+
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+
+namespace can2vss {
+
+enum class RtLogSeverity : uint8_t {
+    VERBOSE,
+    INFO,
+    WARNING,
+    ERROR,
+};
+
+/**
+ * @brief Fixed-size log record; the message is never formatted by the producer
+ *
+ * `message` must point to a string with static storage duration (normally a
+ * literal). The subject (usually a VSS path) is copied and truncated to fit.
+ */
+struct RtLogRecord {
+    static constexpr size_t kSubjectSize = 96;
+
+    RtLogSeverity severity = RtLogSeverity::INFO;
+    int verbosity = 0;
+    const char* message = "";
+    char subject[kSubjectSize] = {};
+    int64_t value = 0;
+    bool has_value = false;
+};
+
+/**
+ * @brief Moves log formatting off the real-time thread
+ *
+ * The RT thread pushes RtLogRecord entries into a lock-free ring; a background
+ * thread drains the ring and emits them through glog. Pushing never
+ * allocates, locks or formats. When the ring is full the record is dropped
+ * and counted.
+ *
+ * The drain thread polls every few milliseconds while records keep coming
+ * and parks on a futex after about a second without any, so an idle feeder
+ * has no periodic wakeups from logging. Producers only issue a wake-up
+ * syscall while it is parked.
+ */
+class RtLogger {
+public:
+    explicit RtLogger(size_t capacity = 4096);
+    ~RtLogger();
+
+    RtLogger(const RtLogger&) = delete;
+    RtLogger& operator=(const RtLogger&) = delete;
+
+    /// Starts the drain thread; call before the RT thread raises its priority
+    void start();
+
+    /// Stops the drain thread after flushing all queued records
+    void stop();
+
+    void log(RtLogSeverity severity, const char* message, std::string_view subject = {});
+    void log(RtLogSeverity severity, const char* message, std::string_view subject, int64_t value);
+
+    /// Verbose record, dropped at the producer if above the glog -v level
+    void vlog(int verbosity, const char* message, std::string_view subject = {});
+    void vlog(int verbosity, const char* message, std::string_view subject, int64_t value);
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void push(RtLogSeverity severity, int verbosity, const char* message,
+              std::string_view subject, int64_t value, bool has_value);
+    void drain_loop();
+    size_t drain();
+
+    SpscRing<RtLogRecord> ring_;
+    int max_verbosity_;
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint32_t> sequence_{0};
+    std::atomic<bool> parked_{false};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+}  // namespace can2vss
@@ -0,0 +1,206 @@
+/**
+ * @file sharding.cpp
+ * @brief Partitioning a mapping across feeder processes
+ */
+
+#include "sharding.h"
+
+#include <glog/logging.h>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <set>
+#include <string_view>
+#include <unordered_map>
+
+namespace can2vss {
+
+namespace {
+
+class UnionFind {
+public:
+    explicit UnionFind(size_t size) : parent_(size) { std::iota(parent_.begin(), parent_.end(), 0); }
+
+    size_t find(size_t i) {
+        while (parent_[i] != i) {
+            parent_[i] = parent_[parent_[i]];
+            i = parent_[i];
+        }
+        return i;
+    }
+
+    void unite(size_t a, size_t b) {
+        a = find(a);
+        b = find(b);
+        if (a != b) {
+            // The lower index wins, so roots do not depend on union order
+            parent_[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+private:
+    std::vector<size_t> parent_;
+};
+
+void stop_shards(const std::vector<pid_t>& children, int signal) {
+    for (pid_t child : children) {
+        if (child > 0) {
+            kill(child, signal);
+        }
+    }
+}
+
+}  // namespace
+
+ShardPlan plan_shards(const std::vector<ShardSignal>& signals, int shard_count) {
+    shard_count = std::max(shard_count, 1);
+
+    // Work in name order so the plan does not depend on input order
+    std::vector<size_t> order(signals.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return signals[a].name < signals[b].name; });
+    std::unordered_map<std::string_view, size_t> position;
+    for (size_t pos = 0; pos < order.size(); ++pos) {
+        position.emplace(signals[order[pos]].name, pos);
+    }
+
+    UnionFind groups(signals.size());
+    std::unordered_map<uint64_t, size_t> message_owner;
+    for (size_t pos = 0; pos < order.size(); ++pos) {
+        const auto& signal = signals[order[pos]];
+        if (signal.can_id) {
+            auto [it, inserted] = message_owner.emplace(*signal.can_id, pos);
+            if (!inserted) {
+                groups.unite(pos, it->second);
+            }
+        }
+        for (const auto& dep : signal.depends_on) {
+            if (auto it = position.find(dep); it != position.end()) {
+                groups.unite(pos, it->second);
+            }
+        }
+    }
+
+    // Members per group, keyed by root: the group's first signal by name
+    std::map<size_t, std::vector<size_t>> members;
+    for (size_t pos = 0; pos < order.size(); ++pos) {
+        members[groups.find(pos)].push_back(pos);
+    }
+    std::vector<const std::vector<size_t>*> by_size;
+    for (const auto& [root, group] : members) {
+        by_size.push_back(&group);
+    }
+    std::stable_sort(by_size.begin(), by_size.end(),
+                     [](const auto* a, const auto* b) { return a->size() > b->size(); });
+
+    ShardPlan plan;
+    plan.shard_of.assign(signals.size(), 0);
+    plan.signals_per_shard.assign(static_cast<size_t>(shard_count), 0);
+    std::vector<std::set<uint64_t>> messages(static_cast<size_t>(shard_count));
+    for (const auto* group : by_size) {
+        plan.largest_group = std::max(plan.largest_group, group->size());
+        const auto lightest = static_cast<size_t>(
+            std::min_element(plan.signals_per_shard.begin(), plan.signals_per_shard.end()) -
+            plan.signals_per_shard.begin());
+        plan.signals_per_shard[lightest] += group->size();
+        for (size_t pos : *group) {
+            plan.shard_of[order[pos]] = static_cast<int>(lightest);
+            if (signals[order[pos]].can_id) {
+                messages[lightest].insert(*signals[order[pos]].can_id);
+            }
+        }
+    }
+    for (const auto& shard_messages : messages) {
+        plan.messages_per_shard.push_back(shard_messages.size());
+    }
+    return plan;
+}
+
+int run_shards(int argc, char* argv[], int shard_count) {
+    // Block the signals we wait for before forking, so none is lost
+    sigset_t wait_set;
+    sigemptyset(&wait_set);
+    sigaddset(&wait_set, SIGINT);
+    sigaddset(&wait_set, SIGTERM);
+    sigaddset(&wait_set, SIGCHLD);
+    sigset_t previous;
+    sigprocmask(SIG_BLOCK, &wait_set, &previous);
+
+    std::vector<pid_t> children;
+    for (int shard = 0; shard < shard_count; ++shard) {
+        std::vector<std::string> args = {argv[0]};
+        for (int i = 1; i < argc; ++i) {
+            if (std::string_view(argv[i]).rfind("--shards", 0) != 0) {
+                args.emplace_back(argv[i]);
+            }
+        }
+        args.push_back("--shard=" + std::to_string(shard) + "/" + std::to_string(shard_count));
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            LOG(ERROR) << "Failed to start shard " << shard << ": " << std::strerror(errno);
+            stop_shards(children, SIGTERM);
+            break;
+        }
+        if (pid == 0) {
+            sigprocmask(SIG_SETMASK, &previous, nullptr);
+            std::vector<char*> exec_args;
+            for (auto& arg : args) {
+                exec_args.push_back(arg.data());
+            }
+            exec_args.push_back(nullptr);
+            execv("/proc/self/exe", exec_args.data());
+            _exit(127);
+        }
+        children.push_back(pid);
+        LOG(INFO) << "Started shard " << shard << "/" << shard_count << " as process " << pid;
+    }
+
+    bool failed = static_cast<int>(children.size()) < shard_count;
+    size_t running = children.size();
+    while (running > 0) {
+        int received = 0;
+        if (sigwait(&wait_set, &received) != 0) {
+            continue;
+        }
+        if (received != SIGCHLD) {
+            LOG(INFO) << "Received signal " << received << ", stopping shards";
+            stop_shards(children, received);
+            continue;
+        }
+
+        int status = 0;
+        pid_t pid;
+        while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+            auto it = std::find(children.begin(), children.end(), pid);
+            if (it == children.end()) {
+                continue;
+            }
+            const auto shard = it - children.begin();
+            *it = -1;
+            --running;
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+                LOG(INFO) << "Shard " << shard << " exited";
+                continue;
+            }
+            LOG(ERROR) << "Shard " << shard << " failed (status " << status << "), stopping the others";
+            if (!failed) {
+                failed = true;
+                stop_shards(children, SIGTERM);
+            }
+        }
+    }
+
+    sigprocmask(SIG_SETMASK, &previous, nullptr);
+    return failed ? 1 : 0;
+}
+
+}  // namespace can2vss
@@ -0,0 +1,62 @@
+/**
+ * @file sharding.h
+ * @brief Partitioning a mapping across feeder processes
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief What the shard planner needs to know about one mapped VSS signal
+ */
+struct ShardSignal {
+    std::string name;                 ///< VSS path
+    std::optional<uint64_t> can_id;   ///< Message of its CAN source signal, if it has one
+    std::vector<std::string> depends_on;
+};
+
+/**
+ * @brief Assignment of mapped signals to shards
+ */
+struct ShardPlan {
+    std::vector<int> shard_of;              ///< Per input signal, in input order
+    std::vector<size_t> signals_per_shard;
+    std::vector<size_t> messages_per_shard; ///< CAN messages each shard decodes
+    size_t largest_group = 0;               ///< Signals in the largest indivisible group
+};
+
+/**
+ * @brief Splits a mapping into shard_count partitions without cross-shard edges
+ *
+ * Signals are grouped so that every group is closed under DAG dependencies
+ * and owns whole CAN messages: two signals end up in the same group if one
+ * depends on the other or their sources are in the same message. Groups are
+ * then assigned largest first to the shard with the fewest signals. Each
+ * shard thus owns a set of CAN IDs and every DAG node that depends on them,
+ * and no value ever has to cross between shards. A group can not be split,
+ * so a mapping dominated by one group (say, a node depending on everything)
+ * does not scale; largest_group tells.
+ *
+ * The plan depends only on the set of signals, not their order, so every
+ * shard process computes the same plan independently.
+ */
+ShardPlan plan_shards(const std::vector<ShardSignal>& signals, int shard_count);
+
+/**
+ * @brief Runs shard_count copies of this feeder as child processes
+ *
+ * Re-executes the running binary with the same arguments, minus --shards,
+ * plus --shard=I/N for each shard. SIGINT and SIGTERM are forwarded to all
+ * shards; if one shard fails, the others are stopped.
+ *
+ * @return Process exit code: 0 if every shard exited cleanly
+ */
+int run_shards(int argc, char* argv[], int shard_count);
+
+}  // namespace can2vss
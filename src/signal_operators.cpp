@@ -0,0 +1,479 @@
+/**
+ * @file signal_operators.cpp
+ * @brief Native stateful operators on signal streams, evaluated ahead of the DAG
+ */
+
+#include "signal_operators.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace can2vss {
+
+std::optional<WindowFunction> window_function_from_string(std::string_view name) {
+    if (name == "min") {
+        return WindowFunction::MIN;
+    }
+    if (name == "max") {
+        return WindowFunction::MAX;
+    }
+    if (name == "mean" || name == "avg") {
+        return WindowFunction::MEAN;
+    }
+    if (name == "stddev") {
+        return WindowFunction::STDDEV;
+    }
+    return std::nullopt;
+}
+
+WindowAggregator::WindowAggregator(const WindowSpec& spec)
+    : function_(spec.function),
+      duration_(std::chrono::milliseconds(spec.duration_ms)),
+      every_(std::chrono::milliseconds(spec.every_ms > 0 ? spec.every_ms : spec.duration_ms)),
+      samples_(spec.max_samples),
+      extremes_(spec.function == WindowFunction::MIN || spec.function == WindowFunction::MAX ? spec.max_samples
+                                                                                              : 0) {}
+
+bool WindowAggregator::update(double value, OperatorClock::time_point time, OperatorSample* out) {
+    // Eviction assumes ordered samples; a timestamp going backwards is taken
+    // as the latest one
+    if (!samples_.empty()) {
+        time = std::max(time, samples_.back().time);
+    }
+
+    bool emitted = false;
+    if (!started_) {
+        started_ = true;
+        next_boundary_ = time + every_;
+    } else {
+        // This sample belongs to the next window only
+        emitted = close_window(time, out);
+    }
+
+    evict_older_than(time - duration_);
+    if (samples_.full()) {
+        pop_oldest();
+        ++overflowed_;
+    }
+    push(value, time);
+    return emitted;
+}
+
+bool WindowAggregator::flush(OperatorClock::time_point now, OperatorSample* out) {
+    return started_ && close_window(now, out);
+}
+
+bool WindowAggregator::close_window(OperatorClock::time_point time, OperatorSample* out) {
+    if (time < next_boundary_) {
+        return false;
+    }
+    // All held samples are older than the boundary, so the window ending
+    // there, [boundary - duration, boundary), is complete
+    const auto boundary = next_boundary_ + (time - next_boundary_) / every_ * every_;
+    evict_older_than(boundary - duration_);
+    next_boundary_ = boundary + every_;
+    if (auto aggregate = current()) {
+        *out = {*aggregate, boundary};
+        return true;
+    }
+    return false;
+}
+
+std::optional<double> WindowAggregator::current() const {
+    if (samples_.empty()) {
+        return std::nullopt;
+    }
+    const auto n = static_cast<double>(samples_.size());
+    switch (function_) {
+        case WindowFunction::MIN:
+        case WindowFunction::MAX:
+            return extremes_.front().value;
+        case WindowFunction::MEAN:
+            return shift_ + sum_ / n;
+        case WindowFunction::STDDEV:
+            return std::sqrt(std::max(0.0, (sum_squares_ - sum_ * sum_ / n) / n));
+    }
+    return std::nullopt;
+}
+
+void WindowAggregator::evict_older_than(OperatorClock::time_point limit) {
+    while (!samples_.empty() && samples_.front().time < limit) {
+        pop_oldest();
+    }
+}
+
+void WindowAggregator::pop_oldest() {
+    const Entry& oldest = samples_.front();
+    if (!extremes_.empty() && extremes_.front().sequence == oldest.sequence) {
+        extremes_.pop_front();
+    }
+    const double shifted = oldest.value - shift_;
+    sum_ -= shifted;
+    sum_squares_ -= shifted * shifted;
+    samples_.pop_front();
+
+    if (samples_.empty()) {
+        sum_ = 0.0;
+        sum_squares_ = 0.0;
+        evictions_since_resum_ = 0;
+    } else if (++evictions_since_resum_ >= samples_.capacity()) {
+        resum();
+    }
+}
+
+void WindowAggregator::push(double value, OperatorClock::time_point time) {
+    if (samples_.empty()) {
+        shift_ = value;
+    }
+    const Entry entry{time, value, next_sequence_++};
+    // A candidate is dropped once a newer sample is at least as extreme: it
+    // leaves the window earlier and can never be the result again
+    if (function_ == WindowFunction::MIN) {
+        while (!extremes_.empty() && extremes_.back().value >= value) {
+            extremes_.pop_back();
+        }
+        extremes_.push_back(entry);
+    } else if (function_ == WindowFunction::MAX) {
+        while (!extremes_.empty() && extremes_.back().value <= value) {
+            extremes_.pop_back();
+        }
+        extremes_.push_back(entry);
+    }
+    const double shifted = value - shift_;
+    sum_ += shifted;
+    sum_squares_ += shifted * shifted;
+    samples_.push_back(entry);
+}
+
+void WindowAggregator::resum() {
+    shift_ = samples_.front().value;
+    sum_ = 0.0;
+    sum_squares_ = 0.0;
+    for (size_t i = 0; i < samples_.size(); ++i) {
+        const double shifted = samples_[i].value - shift_;
+        sum_ += shifted;
+        sum_squares_ += shifted * shifted;
+    }
+    evictions_since_resum_ = 0;
+}
+
+namespace {
+
+double seconds(OperatorClock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+}  // namespace
+
+Derivative::Derivative(const DerivativeSpec& spec)
+    : scale_(spec.scale), min_interval_(std::chrono::milliseconds(spec.min_interval_ms)) {}
+
+bool Derivative::update(double value, OperatorClock::time_point time, OperatorSample* out) {
+    if (!primed_) {
+        primed_ = true;
+        last_value_ = value;
+        last_time_ = time;
+        return false;
+    }
+    const auto elapsed = time - last_time_;
+    if (elapsed <= OperatorClock::duration::zero() || elapsed < min_interval_) {
+        return false;
+    }
+    *out = {scale_ * (value - last_value_) / seconds(elapsed), time};
+    last_value_ = value;
+    last_time_ = time;
+    return true;
+}
+
+Integrator::Integrator(const IntegralSpec& spec)
+    : scale_(spec.scale), max_gap_(std::chrono::milliseconds(spec.max_gap_ms)) {}
+
+bool Integrator::update(double value, OperatorClock::time_point time, OperatorSample* out) {
+    if (primed_) {
+        const auto elapsed = time - last_time_;
+        if (elapsed > OperatorClock::duration::zero() &&
+            (max_gap_ == OperatorClock::duration::zero() || elapsed <= max_gap_)) {
+            total_ += scale_ * 0.5 * (value + last_value_) * seconds(elapsed);
+        }
+    }
+    primed_ = true;
+    last_value_ = value;
+    last_time_ = std::max(last_time_, time);
+    *out = {total_, time};
+    return true;
+}
+
+LowPassFilter::LowPassFilter(const LowPassSpec& spec) : time_constant_s_(spec.time_constant_ms / 1000.0) {}
+
+bool LowPassFilter::update(double value, OperatorClock::time_point time, OperatorSample* out) {
+    if (!primed_) {
+        primed_ = true;
+        output_ = value;
+    } else if (time > last_time_) {
+        const double alpha = 1.0 - std::exp(-seconds(time - last_time_) / time_constant_s_);
+        output_ += alpha * (value - output_);
+    }
+    last_time_ = std::max(last_time_, time);
+    *out = {output_, time};
+    return true;
+}
+
+MovingMedian::MovingMedian(const MedianSpec& spec) : window_(spec.samples), sorted_(spec.samples) {}
+
+bool MovingMedian::update(double value, OperatorClock::time_point time, OperatorSample* out) {
+    const auto begin = sorted_.begin();
+    if (window_.full()) {
+        // Remove the oldest value from the sorted copy
+        const auto oldest = std::lower_bound(begin, begin + sorted_size_, window_.front());
+        std::copy(oldest + 1, begin + sorted_size_, oldest);
+        --sorted_size_;
+        window_.pop_front();
+    }
+    const auto position = std::upper_bound(begin, begin + sorted_size_, value);
+    std::copy_backward(position, begin + sorted_size_, begin + sorted_size_ + 1);
+    *position = value;
+    ++sorted_size_;
+    window_.push_back(value);
+
+    const size_t middle = sorted_size_ / 2;
+    const double median = sorted_size_ % 2 == 1 ? sorted_[middle] : 0.5 * (sorted_[middle - 1] + sorted_[middle]);
+    *out = {median, time};
+    return true;
+}
+
+EventDetector::EventDetector(const EventSpec& spec)
+    : trigger_(spec.trigger),
+      threshold_(spec.threshold),
+      hysteresis_(spec.hysteresis),
+      min_duration_(std::chrono::milliseconds(spec.min_duration_ms)),
+      cooldown_(std::chrono::milliseconds(spec.cooldown_ms)) {}
+
+bool EventDetector::started(double value) const {
+    return trigger_ == EventSpec::Trigger::ABOVE ? value > threshold_ : value < threshold_;
+}
+
+bool EventDetector::ended(double value) const {
+    return trigger_ == EventSpec::Trigger::ABOVE ? value <= threshold_ - hysteresis_
+                                                 : value >= threshold_ + hysteresis_;
+}
+
+bool EventDetector::update(double value, OperatorClock::time_point time, OperatorSample* out) {
+    const bool initial = state_ == State::INITIAL;
+    switch (state_) {
+        case State::INITIAL:
+        case State::IDLE:
+            if (!started(value) || time < cooldown_until_) {
+                state_ = State::IDLE;
+                break;
+            }
+            state_ = State::PENDING;
+            pending_since_ = time;
+            [[fallthrough]];
+        case State::PENDING:
+            // Hysteresis only holds an active event; a pending one needs the
+            // condition throughout
+            if (!started(value)) {
+                state_ = State::IDLE;
+            } else if (time - pending_since_ >= min_duration_) {
+                state_ = State::ACTIVE;
+                *out = {1.0, time};
+                return true;
+            }
+            break;
+        case State::ACTIVE:
+            if (ended(value)) {
+                state_ = State::IDLE;
+                cooldown_until_ = time + cooldown_;
+                *out = {0.0, time};
+                return true;
+            }
+            break;
+    }
+    if (initial) {
+        *out = {0.0, time};
+    }
+    return initial;
+}
+
+std::optional<OperatorSpec::Kind> operator_kind_from_key(std::string_view key) {
+    if (key == "window") {
+        return OperatorSpec::Kind::WINDOW;
+    }
+    if (key == "derivative") {
+        return OperatorSpec::Kind::DERIVATIVE;
+    }
+    if (key == "integral") {
+        return OperatorSpec::Kind::INTEGRAL;
+    }
+    if (key == "low_pass") {
+        return OperatorSpec::Kind::LOW_PASS;
+    }
+    if (key == "median") {
+        return OperatorSpec::Kind::MEDIAN;
+    }
+    if (key == "event") {
+        return OperatorSpec::Kind::EVENT;
+    }
+    return std::nullopt;
+}
+
+absl::Status OperatorGraph::initialize(const std::vector<OperatorSpec>& specs) {
+    specs_ = specs;
+    nodes_.clear();
+    consumers_.assign(specs_.size(), {});
+    input_consumers_.clear();
+    inputs_.clear();
+    input_index_.clear();
+    outputs_.clear();
+
+    std::unordered_map<std::string, size_t> index;
+    for (size_t op = 0; op < specs_.size(); ++op) {
+        if (!index.emplace(specs_[op].name, op).second) {
+            return absl::InvalidArgumentError(absl::StrCat("Duplicate operator '", specs_[op].name, "'"));
+        }
+    }
+
+    std::vector<int> parent(specs_.size(), -1);
+    for (size_t op = 0; op < specs_.size(); ++op) {
+        const OperatorSpec& spec = specs_[op];
+        if (spec.input.empty()) {
+            return absl::InvalidArgumentError(absl::StrCat("Operator '", spec.name, "' has no input"));
+        }
+        if (spec.input_is_operator) {
+            auto it = index.find(spec.input);
+            if (it == index.end()) {
+                return absl::InvalidArgumentError(absl::StrCat(
+                    "Operator '", spec.name, "' reads '", spec.input, "', which is not an operator"));
+            }
+            parent[op] = static_cast<int>(it->second);
+            consumers_[it->second].push_back(op);
+        } else {
+            auto [it, added] = input_index_.emplace(spec.input, inputs_.size());
+            if (added) {
+                inputs_.push_back(spec.input);
+                input_consumers_.emplace_back();
+            }
+            input_consumers_[it->second].push_back(op);
+        }
+
+        std::string invalid;
+        switch (spec.kind) {
+            case OperatorSpec::Kind::WINDOW:
+                if (spec.window.duration_ms <= 0 || spec.window.every_ms < 0 || spec.window.max_samples == 0) {
+                    invalid = "window needs duration_ms > 0, every_ms >= 0 and max_samples > 0";
+                }
+                break;
+            case OperatorSpec::Kind::DERIVATIVE:
+                if (spec.derivative.min_interval_ms < 0) {
+                    invalid = "derivative needs min_interval_ms >= 0";
+                }
+                break;
+            case OperatorSpec::Kind::INTEGRAL:
+                if (spec.integral.max_gap_ms < 0) {
+                    invalid = "integral needs max_gap_ms >= 0";
+                }
+                break;
+            case OperatorSpec::Kind::LOW_PASS:
+                if (spec.low_pass.time_constant_ms <= 0) {
+                    invalid = "low_pass needs time_constant_ms > 0";
+                }
+                break;
+            case OperatorSpec::Kind::MEDIAN:
+                if (spec.median.samples == 0 || spec.median.samples > kMaxMedianSamples) {
+                    invalid = absl::StrCat("median needs 1 to ", kMaxMedianSamples, " samples");
+                }
+                break;
+            case OperatorSpec::Kind::EVENT:
+                if (spec.event.hysteresis < 0.0 || spec.event.min_duration_ms < 0 || spec.event.cooldown_ms < 0) {
+                    invalid = "event needs hysteresis, min_duration_ms and cooldown_ms >= 0";
+                }
+                break;
+        }
+        if (!invalid.empty()) {
+            return absl::InvalidArgumentError(absl::StrCat("Operator '", spec.name, "': ", invalid));
+        }
+    }
+
+    // Every operator has one input, so a cycle is a chain of parents that
+    // does not reach an input signal within size() steps
+    for (size_t op = 0; op < specs_.size(); ++op) {
+        int current = parent[op];
+        for (size_t steps = 0; current >= 0; ++steps) {
+            if (steps >= specs_.size()) {
+                return absl::InvalidArgumentError(
+                    absl::StrCat("Operator '", specs_[op].name, "' is part of a dependency cycle"));
+            }
+            current = parent[static_cast<size_t>(current)];
+        }
+    }
+
+    nodes_.reserve(specs_.size());
+    for (const auto& spec : specs_) {
+        switch (spec.kind) {
+            case OperatorSpec::Kind::WINDOW:
+                nodes_.emplace_back(std::in_place_type<WindowAggregator>, spec.window);
+                break;
+            case OperatorSpec::Kind::DERIVATIVE:
+                nodes_.emplace_back(std::in_place_type<Derivative>, spec.derivative);
+                break;
+            case OperatorSpec::Kind::INTEGRAL:
+                nodes_.emplace_back(std::in_place_type<Integrator>, spec.integral);
+                break;
+            case OperatorSpec::Kind::LOW_PASS:
+                nodes_.emplace_back(std::in_place_type<LowPassFilter>, spec.low_pass);
+                break;
+            case OperatorSpec::Kind::MEDIAN:
+                nodes_.emplace_back(std::in_place_type<MovingMedian>, spec.median);
+                break;
+            case OperatorSpec::Kind::EVENT:
+                nodes_.emplace_back(std::in_place_type<EventDetector>, spec.event);
+                break;
+        }
+    }
+    outputs_.reserve(specs_.size());
+    return absl::OkStatus();
+}
+
+int OperatorGraph::input_index(const std::string& name) const {
+    auto it = input_index_.find(name);
+    return it == input_index_.end() ? -1 : static_cast<int>(it->second);
+}
+
+void OperatorGraph::push(size_t input, double value, OperatorClock::time_point time) {
+    // A NaN would stay in running sums and break the median's ordering
+    if (std::isnan(value)) {
+        return;
+    }
+    for (size_t op : input_consumers_[input]) {
+        feed(op, value, time);
+    }
+}
+
+void OperatorGraph::tick(OperatorClock::time_point now) {
+    for (size_t op = 0; op < nodes_.size(); ++op) {
+        OperatorSample sample;
+        auto* window = std::get_if<WindowAggregator>(&nodes_[op]);
+        if (window != nullptr && window->flush(now, &sample)) {
+            emit(op, sample);
+        }
+    }
+}
+
+void OperatorGraph::feed(size_t op, double value, OperatorClock::time_point time) {
+    OperatorSample sample;
+    const bool emitted = std::visit([&](auto& node) { return node.update(value, time, &sample); }, nodes_[op]);
+    if (emitted) {
+        emit(op, sample);
+    }
+}
+
+void OperatorGraph::emit(size_t op, const OperatorSample& sample) {
+    outputs_.push_back({op, sample});
+    for (size_t consumer : consumers_[op]) {
+        feed(consumer, sample.value, sample.time);
+    }
+}
+
+}  // namespace can2vss
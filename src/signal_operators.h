@@ -0,0 +1,392 @@
+/**
+ * @file signal_operators.h
+ * @brief Native stateful operators on signal streams, evaluated ahead of the DAG
+ */
+
+#pragma once
+
+#include <absl/status/status.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief Double-ended queue over a fixed number of preallocated slots
+ *
+ * Single-threaded; push and pop never allocate. Pushing onto a full queue is
+ * the caller's error.
+ */
+template <typename T>
+class FixedDeque {
+public:
+    explicit FixedDeque(size_t capacity = 0) : slots_(capacity) {}
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == slots_.size(); }
+
+    T& front() { return slots_[head_]; }
+    const T& front() const { return slots_[head_]; }
+    T& back() { return slots_[wrap(head_ + size_ - 1)]; }
+    const T& back() const { return slots_[wrap(head_ + size_ - 1)]; }
+    /// i-th element from the front
+    const T& operator[](size_t i) const { return slots_[wrap(head_ + i)]; }
+
+    void push_back(const T& value) {
+        slots_[wrap(head_ + size_)] = value;
+        ++size_;
+    }
+    void pop_front() {
+        head_ = wrap(head_ + 1);
+        --size_;
+    }
+    void pop_back() { --size_; }
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    size_t wrap(size_t index) const { return index >= slots_.size() ? index - slots_.size() : index; }
+
+    std::vector<T> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+using OperatorClock = std::chrono::steady_clock;
+
+/// A value produced by an operator, stamped with the time it describes
+struct OperatorSample {
+    double value = 0.0;
+    OperatorClock::time_point time;
+};
+
+enum class WindowFunction { MIN, MAX, MEAN, STDDEV };
+
+/// Parses "min", "max", "mean"/"avg" or "stddev"
+std::optional<WindowFunction> window_function_from_string(std::string_view name);
+
+/**
+ * @brief Configuration of a windowed aggregate
+ *
+ * The aggregate covers the samples of the last duration_ms and is emitted
+ * every every_ms (by default once per window, i.e. tumbling windows; less
+ * than duration_ms gives sliding windows).
+ */
+struct WindowSpec {
+    WindowFunction function = WindowFunction::MEAN;
+    int duration_ms = 1000;
+    int every_ms = 0;            ///< 0 means duration_ms
+    size_t max_samples = 1024;   ///< Preallocated samples per window
+};
+
+/**
+ * @brief Incremental min/max/mean/stddev over a sliding time window
+ *
+ * Samples are kept in a preallocated ring; min and max use a monotonic deque
+ * of candidates, mean and stddev running sums shifted by a reference value
+ * and re-summed from the ring every max_samples evictions to bound rounding
+ * drift. Every update is amortized O(1) and allocation free.
+ *
+ * Emission is driven by the samples themselves: the window ending at a
+ * boundary (multiples of every_ms after the first sample) covers
+ * [boundary - duration_ms, boundary) and is emitted when the first sample
+ * at or after that boundary arrives, or when flush() is called at or after
+ * it, stamped with the boundary time. A sample exactly on a boundary
+ * belongs to the next window only. After a gap spanning several boundaries
+ * only the latest is emitted, and nothing is emitted for an empty window. A window holding more than max_samples
+ * samples loses its oldest ones early, counted by overflowed().
+ */
+class WindowAggregator {
+public:
+    explicit WindowAggregator(const WindowSpec& spec);
+
+    /// Adds a sample; @return true if a window was completed and written to out
+    bool update(double value, OperatorClock::time_point time, OperatorSample* out);
+
+    /// Closes the latest window that ended at or before now without a further
+    /// sample; @return true if it held samples and was written to out
+    bool flush(OperatorClock::time_point now, OperatorSample* out);
+
+    /// Aggregate of the samples currently in the window; nullopt if there are none
+    std::optional<double> current() const;
+
+    size_t size() const { return samples_.size(); }
+    uint64_t overflowed() const { return overflowed_; }
+
+private:
+    struct Entry {
+        OperatorClock::time_point time;
+        double value = 0.0;
+        uint64_t sequence = 0;
+    };
+
+    bool close_window(OperatorClock::time_point time, OperatorSample* out);
+    void evict_older_than(OperatorClock::time_point limit);
+    void pop_oldest();
+    void push(double value, OperatorClock::time_point time);
+    void resum();
+
+    WindowFunction function_;
+    OperatorClock::duration duration_;
+    OperatorClock::duration every_;
+
+    FixedDeque<Entry> samples_;
+    FixedDeque<Entry> extremes_;  // monotonic candidates, MIN and MAX only
+    uint64_t next_sequence_ = 0;
+
+    double shift_ = 0.0;  // subtracted before summing, to keep sums small
+    double sum_ = 0.0;
+    double sum_squares_ = 0.0;
+    size_t evictions_since_resum_ = 0;
+
+    bool started_ = false;
+    OperatorClock::time_point next_boundary_;
+    uint64_t overflowed_ = 0;
+};
+
+struct DerivativeSpec {
+    double scale = 1.0;       ///< Applied to the rate per second, e.g. 1/3.6 for km/h to m/s²
+    int min_interval_ms = 0;  ///< Samples closer to the last used one are skipped
+};
+
+/**
+ * @brief Rate of change per second between successive samples
+ *
+ * Uses the samples' own timestamps, so jitter in arrival does not show up
+ * as noise. The first sample and samples less than min_interval_ms after
+ * the last used one produce no output.
+ */
+class Derivative {
+public:
+    explicit Derivative(const DerivativeSpec& spec);
+
+    bool update(double value, OperatorClock::time_point time, OperatorSample* out);
+
+private:
+    double scale_;
+    OperatorClock::duration min_interval_;
+    bool primed_ = false;
+    double last_value_ = 0.0;
+    OperatorClock::time_point last_time_;
+};
+
+struct IntegralSpec {
+    double scale = 1.0;  ///< Applied to the integral over seconds, e.g. 1/3600 for km/h to km
+    int max_gap_ms = 0;  ///< Longer gaps between samples are not integrated; 0 for no limit
+};
+
+/**
+ * @brief Running trapezoidal integral over time
+ *
+ * Emits the accumulated value for every sample. A gap longer than
+ * max_gap_ms, e.g. while the signal was lost, restarts from the next sample
+ * without adding the gap.
+ */
+class Integrator {
+public:
+    explicit Integrator(const IntegralSpec& spec);
+
+    bool update(double value, OperatorClock::time_point time, OperatorSample* out);
+
+private:
+    double scale_;
+    OperatorClock::duration max_gap_;
+    bool primed_ = false;
+    double last_value_ = 0.0;
+    OperatorClock::time_point last_time_;
+    double total_ = 0.0;
+};
+
+struct LowPassSpec {
+    int time_constant_ms = 1000;
+};
+
+/**
+ * @brief First-order low-pass filter with a time constant
+ *
+ * y += (1 - exp(-dt / tau)) * (x - y), with dt taken from the samples'
+ * timestamps, so the response does not depend on the sample rate. The first
+ * sample initializes the output. Emits for every sample.
+ */
+class LowPassFilter {
+public:
+    explicit LowPassFilter(const LowPassSpec& spec);
+
+    bool update(double value, OperatorClock::time_point time, OperatorSample* out);
+
+private:
+    double time_constant_s_;
+    bool primed_ = false;
+    double output_ = 0.0;
+    OperatorClock::time_point last_time_;
+};
+
+struct MedianSpec {
+    size_t samples = 5;  ///< Window length in samples, at most kMaxMedianSamples
+};
+
+inline constexpr size_t kMaxMedianSamples = 1024;
+
+/**
+ * @brief Median of the last N samples, to reject spikes
+ *
+ * Keeps the window both in arrival order (a ring) and sorted (an array),
+ * both preallocated; an update replaces the oldest value in the sorted
+ * array with a binary search and one shift, which for the short windows
+ * spike rejection needs is cheaper than keeping two heaps. Emits for every
+ * sample, the median of the samples so far until the window is full.
+ */
+class MovingMedian {
+public:
+    explicit MovingMedian(const MedianSpec& spec);
+
+    bool update(double value, OperatorClock::time_point time, OperatorSample* out);
+
+private:
+    FixedDeque<double> window_;
+    std::vector<double> sorted_;
+    size_t sorted_size_ = 0;
+};
+
+struct EventSpec {
+    enum class Trigger { ABOVE, BELOW };
+
+    Trigger trigger = Trigger::ABOVE;
+    double threshold = 0.0;
+    double hysteresis = 0.0;  ///< The event ends once the value is this far back past the threshold
+    int min_duration_ms = 0;  ///< The condition must hold this long before the event starts
+    int cooldown_ms = 0;      ///< No new event starts this soon after one ended
+};
+
+/**
+ * @brief Boolean event from threshold, hysteresis, duration and cool-down
+ *
+ * An event starts when the value has been beyond the threshold (above or
+ * below it, by trigger) for min_duration_ms without interruption; a sample
+ * that is not beyond it cancels the pending start. An active event ends when
+ * the value is back past threshold -/+ hysteresis; values inside the
+ * hysteresis band keep it going. After an event no new one starts
+ * for cooldown_ms. Outputs 1 or 0: the initial state with the first sample,
+ * then only transitions, stamped with the sample that caused them.
+ */
+class EventDetector {
+public:
+    explicit EventDetector(const EventSpec& spec);
+
+    bool update(double value, OperatorClock::time_point time, OperatorSample* out);
+
+    bool active() const { return state_ == State::ACTIVE; }
+
+private:
+    enum class State { INITIAL, IDLE, PENDING, ACTIVE };
+
+    bool started(double value) const;
+    bool ended(double value) const;
+
+    EventSpec::Trigger trigger_;
+    double threshold_;
+    double hysteresis_;
+    OperatorClock::duration min_duration_;
+    OperatorClock::duration cooldown_;
+    State state_ = State::INITIAL;
+    OperatorClock::time_point pending_since_;
+    OperatorClock::time_point cooldown_until_;
+};
+
+/**
+ * @brief One operator node of the mapping
+ *
+ * An operator reads exactly one input: a CAN signal, or the output of
+ * another operator (input_is_operator). Only the parameters of its kind
+ * are used.
+ */
+struct OperatorSpec {
+    enum class Kind { WINDOW, DERIVATIVE, INTEGRAL, LOW_PASS, MEDIAN, EVENT };
+
+    std::string name;  ///< VSS path of the output
+    std::string input;
+    bool input_is_operator = false;
+    Kind kind = Kind::WINDOW;
+    WindowSpec window;
+    DerivativeSpec derivative;
+    IntegralSpec integral;
+    LowPassSpec low_pass;
+    MedianSpec median;
+    EventSpec event;
+};
+
+/// Source type of the DAG mapping an operator's output is fed to
+inline constexpr std::string_view kOperatorSourceType = "operator";
+
+/// Operator kind named by a mapping `transform:` key: "window", "derivative", "integral", "low_pass",
+/// "median" or "event"
+std::optional<OperatorSpec::Kind> operator_kind_from_key(std::string_view key);
+
+/**
+ * @brief Evaluates the operator nodes of a mapping
+ *
+ * Inputs are fed with push(); every operator output is appended to
+ * outputs() and passed on to the operators reading it, in the same call.
+ * The feeder hands the outputs to the DAG as input signals named after the
+ * operators, so the DAG publishes them and other signals may depend on them.
+ * Single-threaded; pushing does not allocate once outputs() has grown to
+ * its working size.
+ */
+class OperatorGraph {
+public:
+    /// @return error for duplicate names, unknown or cyclic operator inputs, or invalid parameters
+    absl::Status initialize(const std::vector<OperatorSpec>& specs);
+
+    size_t size() const { return specs_.size(); }
+    const OperatorSpec& spec(size_t op) const { return specs_[op]; }
+
+    /// Signals read from outside the graph, indexed by input
+    const std::vector<std::string>& inputs() const { return inputs_; }
+
+    /// @return Index into inputs(), or -1 if no operator reads the signal
+    int input_index(const std::string& name) const;
+
+    /// Feeds one sample of an input to every operator downstream of it; NaN is ignored
+    void push(size_t input, double value, OperatorClock::time_point time);
+
+    struct Output {
+        size_t op = 0;
+        OperatorSample sample;
+    };
+
+    /// Closes windows that ended at or before now without a further sample,
+    /// feeding their aggregates downstream like push(); call periodically
+    void tick(OperatorClock::time_point now);
+
+    /// Outputs produced since the last clear_outputs()
+    const std::vector<Output>& outputs() const { return outputs_; }
+    void clear_outputs() { outputs_.clear(); }
+
+private:
+    using Node = std::variant<WindowAggregator, Derivative, Integrator, LowPassFilter, MovingMedian, EventDetector>;
+
+    void feed(size_t op, double value, OperatorClock::time_point time);
+    void emit(size_t op, const OperatorSample& sample);
+
+    std::vector<OperatorSpec> specs_;
+    std::vector<Node> nodes_;
+    std::vector<std::vector<size_t>> consumers_;        // by operator
+    std::vector<std::vector<size_t>> input_consumers_;  // by input
+    std::vector<std::string> inputs_;
+    std::unordered_map<std::string, size_t> input_index_;
+    std::vector<Output> outputs_;
+};
+
+}  // namespace can2vss
@@ -0,0 +1,56 @@
+/**
+ * @file signal_priority.h
+ * @brief Publish priority classes for VSS signals
+ */
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string_view>
+
+namespace can2vss {
+
+/**
+ * @brief Publish priority of a mapping, set with `priority:` in the mapping YAML
+ *
+ * HIGH signals get a dedicated publish lane (own thread and gRPC channel);
+ * NORMAL and BULK share a lane with weighted scheduling.
+ */
+enum class SignalPriority {
+    HIGH = 0,
+    NORMAL = 1,
+    BULK = 2,
+};
+
+inline constexpr size_t kSignalPriorityCount = 3;
+
+inline constexpr std::array<SignalPriority, kSignalPriorityCount> kAllSignalPriorities = {
+    SignalPriority::HIGH, SignalPriority::NORMAL, SignalPriority::BULK};
+
+inline std::optional<SignalPriority> signal_priority_from_string(std::string_view name) {
+    if (name == "high") {
+        return SignalPriority::HIGH;
+    }
+    if (name == "normal") {
+        return SignalPriority::NORMAL;
+    }
+    if (name == "bulk" || name == "low") {
+        return SignalPriority::BULK;
+    }
+    return std::nullopt;
+}
+
+inline const char* to_string(SignalPriority priority) {
+    switch (priority) {
+        case SignalPriority::HIGH:
+            return "high";
+        case SignalPriority::NORMAL:
+            return "normal";
+        case SignalPriority::BULK:
+            return "bulk";
+    }
+    return "unknown";
+}
+
+}  // namespace can2vss
@@ -0,0 +1,91 @@
+/**
+ * @file spsc_ring.h
+ * @brief Bounded lock-free single-producer/single-consumer ring buffer
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief Bounded SPSC queue with preallocated slots
+ *
+ * All storage is allocated in the constructor; push and pop never allocate
+ * or block, which makes the queue usable from a real-time thread. Exactly one
+ * thread may push and exactly one (other) thread may pop.
+ *
+ * @tparam T Slot type; must be default-constructible and move-assignable
+ */
+template <typename T>
+class SpscRing {
+public:
+    /// @param capacity Minimum capacity, rounded up to a power of two
+    explicit SpscRing(size_t capacity) : slots_(round_up_pow2(capacity)), mask_(slots_.size() - 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /// @return false if the ring is full (item is left untouched)
+    bool try_push(T&& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ > mask_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ > mask_) {
+                return false;
+            }
+        }
+        slots_[head & mask_] = std::move(item);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @return false if the ring is empty
+    bool try_pop(T& out) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail == head_cache_) {
+                return false;
+            }
+        }
+        out = std::move(slots_[tail & mask_]);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Number of queued items; exact only when called from producer or consumer
+    size_t size_approx() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    static constexpr size_t kCacheLine = 64;
+
+    std::vector<T> slots_;
+    const size_t mask_;
+
+    // Producer-owned
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;
+
+    // Consumer-owned
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;
+};
+
+}  // namespace can2vss
@@ -0,0 +1,121 @@
+/**
+ * @file stage_profiler.cpp
+ * @brief Per-stage CPU time and allocation profiling of the main loop
+ */
+
+#include "stage_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+namespace can2vss {
+
+std::string_view profile_stage_name(ProfileStage stage) {
+    switch (stage) {
+        case ProfileStage::POLL:
+            return "poll";
+        case ProfileStage::DAG:
+            return "dag";
+        case ProfileStage::FORMAT:
+            return "format";
+        case ProfileStage::PUBLISH:
+            return "publish";
+    }
+    return "unknown";
+}
+
+StageProfiler::StageProfiler(size_t trace_capacity)
+    : start_ticks_(read_ticks()), start_time_(std::chrono::steady_clock::now()) {
+    static_assert(sizeof(TraceEvent) == kTraceEventBytes);
+    trace_.resize(std::max<size_t>(trace_capacity, 1));
+}
+
+void StageProfiler::record(ProfileStage stage, uint64_t start_ticks, uint64_t end_ticks, uint64_t allocations,
+                           uint64_t deallocations) {
+    const uint64_t ticks = end_ticks > start_ticks ? end_ticks - start_ticks : 0;
+    StageStats& stats = stats_[static_cast<size_t>(stage)];
+    stats.calls++;
+    stats.ticks += ticks;
+    stats.max_ticks = std::max(stats.max_ticks, ticks);
+    stats.allocations += allocations;
+    stats.deallocations += deallocations;
+
+    TraceEvent& event = trace_[events_ % trace_.size()];
+    event.start_ticks = start_ticks;
+    event.duration_ticks = static_cast<uint32_t>(std::min<uint64_t>(ticks, std::numeric_limits<uint32_t>::max()));
+    event.allocations = static_cast<uint16_t>(std::min<uint64_t>(allocations, std::numeric_limits<uint16_t>::max()));
+    event.stage = stage;
+    events_++;
+}
+
+double StageProfiler::ns_per_tick() const {
+    const uint64_t elapsed_ticks = read_ticks() - start_ticks_;
+    const auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_time_).count();
+    if (elapsed_ticks == 0 || elapsed_ns <= 0) {
+        return 1.0;
+    }
+    return static_cast<double>(elapsed_ns) / static_cast<double>(elapsed_ticks);
+}
+
+double StageProfiler::ticks_to_ns(uint64_t ticks) const {
+    return static_cast<double>(ticks) * ns_per_tick();
+}
+
+std::string StageProfiler::report() const {
+    uint64_t total_ticks = 0;
+    for (const auto& stats : stats_) {
+        total_ticks += stats.ticks;
+    }
+
+    const double rate = ns_per_tick();
+    std::string out = "Stage profile:\n";
+    char line[160];
+    std::snprintf(line, sizeof(line), "  %-8s %10s %10s %6s %10s %10s %10s %10s\n", "stage", "calls", "total ms",
+                  "share", "mean us", "max us", "allocs", "frees");
+    out += line;
+    for (size_t i = 0; i < kProfileStageCount; ++i) {
+        const StageStats& stats = stats_[i];
+        const double total_ns = stats.ticks * rate;
+        std::snprintf(line, sizeof(line), "  %-8s %10llu %10.1f %5.1f%% %10.2f %10.2f %10llu %10llu\n",
+                      std::string(profile_stage_name(static_cast<ProfileStage>(i))).c_str(),
+                      static_cast<unsigned long long>(stats.calls), total_ns / 1e6,
+                      total_ticks ? 100.0 * stats.ticks / total_ticks : 0.0,
+                      stats.calls ? total_ns / stats.calls / 1e3 : 0.0, stats.max_ticks * rate / 1e3,
+                      static_cast<unsigned long long>(stats.allocations),
+                      static_cast<unsigned long long>(stats.deallocations));
+        out += line;
+    }
+    return out;
+}
+
+bool StageProfiler::write_chrome_trace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    // Oldest retained event first; timestamps in microseconds from profiler start
+    const uint64_t retained = std::min<uint64_t>(events_, trace_.size());
+    const uint64_t first = events_ - retained;
+    const double rate = ns_per_tick();
+    char line[192];
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    for (uint64_t n = 0; n < retained; ++n) {
+        const TraceEvent& event = trace_[(first + n) % trace_.size()];
+        const uint64_t offset = event.start_ticks > start_ticks_ ? event.start_ticks - start_ticks_ : 0;
+        std::snprintf(line, sizeof(line),
+                      "%s{\"name\":\"%s\",\"cat\":\"loop\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                      "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"allocs\":%u}}",
+                      n == 0 ? "" : ",\n", std::string(profile_stage_name(event.stage)).c_str(),
+                      offset * rate / 1e3, event.duration_ticks * rate / 1e3,
+                      static_cast<unsigned>(event.allocations));
+        out << line;
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+}  // namespace can2vss
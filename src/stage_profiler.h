@@ -0,0 +1,146 @@
+/**
+ * @file stage_profiler.h
+ * @brief Per-stage CPU time and allocation profiling of the main loop
+ */
+
+#pragma once
+
+#include "alloc_tracker.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace can2vss {
+
+/**
+ * @brief Main loop stages timed by --profile
+ */
+enum class ProfileStage : uint8_t {
+    POLL,      ///< CAN source poll, including frame decoding
+    DAG,       ///< DAG evaluation of updates and periodic ticks
+    FORMAT,    ///< Per-signal log formatting
+    PUBLISH,   ///< Handle lookup and hand-off to the publish lanes
+};
+
+inline constexpr size_t kProfileStageCount = 4;
+
+std::string_view profile_stage_name(ProfileStage stage);
+
+/**
+ * @brief Cycle counter read by profiling scopes
+ *
+ * The TSC on x86, the virtual counter on AArch64, steady_clock elsewhere.
+ * Ticks are converted to time with a rate calibrated against steady_clock
+ * over the profiled run.
+ */
+inline uint64_t read_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * @brief Accumulates time and heap operations per loop stage
+ *
+ * Every stage execution is also kept as a trace event in a ring buffer
+ * allocated up front, holding the most recent trace_capacity events, for
+ * export as Chrome trace-event JSON (chrome://tracing, Perfetto). Recording
+ * never allocates. Not thread-safe: profile one thread.
+ */
+class StageProfiler {
+public:
+    struct StageStats {
+        uint64_t calls = 0;
+        uint64_t ticks = 0;
+        uint64_t max_ticks = 0;
+        uint64_t allocations = 0;
+        uint64_t deallocations = 0;
+    };
+
+    /// Bytes of trace buffer per retained event
+    static constexpr size_t kTraceEventBytes = 16;
+
+    explicit StageProfiler(size_t trace_capacity = 1 << 18);
+
+    StageProfiler(const StageProfiler&) = delete;
+    StageProfiler& operator=(const StageProfiler&) = delete;
+
+    void record(ProfileStage stage, uint64_t start_ticks, uint64_t end_ticks, uint64_t allocations,
+                uint64_t deallocations);
+
+    const StageStats& stats(ProfileStage stage) const { return stats_[static_cast<size_t>(stage)]; }
+
+    /// Converts a tick count to nanoseconds using the calibrated rate
+    double ticks_to_ns(uint64_t ticks) const;
+
+    /// Events recorded so far, including those overwritten in the trace buffer
+    uint64_t events() const { return events_; }
+
+    /// Breakdown table: calls, total, share, mean and max time, heap operations
+    std::string report() const;
+
+    /// Writes the retained events as Chrome trace-event JSON
+    bool write_chrome_trace(const std::string& path) const;
+
+private:
+    /// Tick rate calibrated against steady_clock since construction
+    double ns_per_tick() const;
+
+    struct TraceEvent {
+        uint64_t start_ticks;
+        uint32_t duration_ticks;
+        uint16_t allocations;
+        ProfileStage stage;
+    };
+
+    uint64_t start_ticks_;
+    std::chrono::steady_clock::time_point start_time_;
+    std::array<StageStats, kProfileStageCount> stats_{};
+    std::vector<TraceEvent> trace_;
+    uint64_t events_ = 0;
+};
+
+/**
+ * @brief Times one stage execution; does nothing if the profiler is null
+ */
+class ProfileScope {
+public:
+    ProfileScope(StageProfiler* profiler, ProfileStage stage) : profiler_(profiler), stage_(stage) {
+        if (profiler_ != nullptr) {
+            guard_.emplace();
+            start_ticks_ = read_ticks();
+        }
+    }
+
+    ~ProfileScope() {
+        if (profiler_ != nullptr) {
+            profiler_->record(stage_, start_ticks_, read_ticks(), guard_->allocations(), guard_->deallocations());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    StageProfiler* profiler_;
+    ProfileStage stage_;
+    uint64_t start_ticks_ = 0;
+    std::optional<AllocationGuard> guard_;
+};
+
+}  // namespace can2vss
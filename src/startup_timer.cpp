@@ -0,0 +1,34 @@
+/**
+ * @file startup_timer.cpp
+ * @brief Wall-clock timing of the feeder's startup phases
+ */
+
+#include "startup_timer.h"
+
+#include <cstdio>
+
+namespace can2vss {
+
+void StartupTimer::mark(std::string phase) {
+    const auto now = std::chrono::steady_clock::now();
+    phases_.push_back({std::move(phase), now - last_});
+    last_ = now;
+}
+
+std::string StartupTimer::report() const {
+    const auto total = last_ - start_;
+    std::string out = "Startup phases:\n";
+    char line[128];
+    for (const auto& phase : phases_) {
+        std::snprintf(line, sizeof(line), "  %-24s %9.2f ms %5.1f%%\n", phase.name.c_str(),
+                      phase.duration.count() / 1e6,
+                      total.count() > 0 ? 100.0 * phase.duration.count() / total.count() : 0.0);
+        out += line;
+    }
+    std::snprintf(line, sizeof(line), "  %-24s %9.2f ms", "total",
+                  std::chrono::duration<double, std::milli>(total).count());
+    out += line;
+    return out;
+}
+
+}  // namespace can2vss
@@ -0,0 +1,46 @@
+/**
+ * @file startup_timer.h
+ * @brief Wall-clock timing of the feeder's startup phases
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief Splits the time from construction into consecutive named phases
+ *
+ * Create it first thing in main() and mark() each phase as it completes; the
+ * report shows where time-to-first-signal goes during ECU boot.
+ */
+class StartupTimer {
+public:
+    struct Phase {
+        std::string name;
+        std::chrono::nanoseconds duration;
+    };
+
+    StartupTimer() : start_(std::chrono::steady_clock::now()), last_(start_) {}
+
+    /// Ends the phase running since the previous mark (or construction)
+    void mark(std::string phase);
+
+    /// Time since construction
+    std::chrono::nanoseconds elapsed() const { return std::chrono::steady_clock::now() - start_; }
+
+    const std::vector<Phase>& phases() const { return phases_; }
+
+    /// One line per phase with its duration and share, and the total
+    std::string report() const;
+
+private:
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point last_;
+    std::vector<Phase> phases_;
+};
+
+}  // namespace can2vss
@@ -0,0 +1,95 @@
+/**
+ * @file struct_buffer.cpp
+ * @brief Preallocated struct signal value shared between loop and publish lanes
+ */
+
+#include "struct_buffer.h"
+
+#include <cstring>
+#include <thread>
+
+namespace can2vss {
+
+namespace {
+
+uint64_t payload(const TypedValue& value) {
+    uint64_t word = 0;
+    switch (value.type) {
+        case SlotType::BOOL:
+            word = value.b ? 1 : 0;
+            break;
+        case SlotType::FLOAT:
+            std::memcpy(&word, &value.f, sizeof(value.f));
+            break;
+        case SlotType::DOUBLE:
+            std::memcpy(&word, &value.d, sizeof(value.d));
+            break;
+        default:
+            word = value.u;
+            break;
+    }
+    return word;
+}
+
+TypedValue from_payload(SlotType type, uint64_t word) {
+    TypedValue value;
+    value.type = type;
+    switch (type) {
+        case SlotType::BOOL:
+            value.b = word != 0;
+            break;
+        case SlotType::FLOAT:
+            std::memcpy(&value.f, &word, sizeof(value.f));
+            break;
+        case SlotType::DOUBLE:
+            std::memcpy(&value.d, &word, sizeof(value.d));
+            break;
+        default:
+            value.u = word;
+            break;
+    }
+    return value;
+}
+
+}  // namespace
+
+StructBuffer::StructBuffer(std::string type_name, std::vector<Field> fields)
+    : type_name_(std::move(type_name)),
+      fields_(std::move(fields)),
+      words_(std::make_unique<std::atomic<uint64_t>[]>(fields_.size())) {
+    for (size_t i = 0; i < fields_.size(); ++i) {
+        words_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void StructBuffer::store(const TypedValue* values) {
+    const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < fields_.size(); ++i) {
+        words_[i].store(payload(values[i]), std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+bool StructBuffer::load(TypedValue* values) const {
+    while (true) {
+        const uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before == 0) {
+            return false;
+        }
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < fields_.size(); ++i) {
+            values[i] = from_payload(fields_[i].type, words_[i].load(std::memory_order_relaxed));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+}
+
+}  // namespace can2vss
@@ -0,0 +1,59 @@
+/**
+ * @file struct_buffer.h
+ * @brief Preallocated struct signal value shared between loop and publish lanes
+ */
+
+#pragma once
+
+#include "typed_value.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace can2vss {
+
+/**
+ * @brief Latest value of one struct signal, laid out by its schema
+ *
+ * One 64-bit word per field, allocated once. The loop thread store()s the
+ * fields it assembled; publish lanes load() a consistent copy of all fields.
+ * A sequence counter (seqlock) makes the struct change atomically without a
+ * mutex: readers retry if a store overlapped their copy, the writer never
+ * waits. Single writer only.
+ */
+class StructBuffer {
+public:
+    struct Field {
+        std::string name;
+        SlotType type = SlotType::NONE;
+    };
+
+    StructBuffer(std::string type_name, std::vector<Field> fields);
+
+    StructBuffer(const StructBuffer&) = delete;
+    StructBuffer& operator=(const StructBuffer&) = delete;
+
+    const std::string& type_name() const { return type_name_; }
+    const std::vector<Field>& fields() const { return fields_; }
+
+    /// Publishes new field values; values must hold fields().size() entries
+    void store(const TypedValue* values);
+
+    /**
+     * @brief Copies the latest consistent field values
+     * @param values Receives fields().size() entries
+     * @return false if nothing has been stored yet
+     */
+    bool load(TypedValue* values) const;
+
+private:
+    std::string type_name_;
+    std::vector<Field> fields_;
+    std::unique_ptr<std::atomic<uint64_t>[]> words_;
+    std::atomic<uint64_t> sequence_{0};  // odd while a store is in progress
+};
+
+}  // namespace can2vss
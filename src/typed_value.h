@@ -0,0 +1,156 @@
+/**
+ * @file typed_value.h
+ * @brief Trivially copyable signal values tagged with their VSS datatype
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace can2vss {
+
+/**
+ * @brief Storage class of a compiled-in signal
+ *
+ * Values are kept in one typed slot array per storage class: bools in a
+ * bitset, signed and unsigned integers widened to 64 bits, floats and doubles
+ * as themselves. The declared width is kept in the tag so the value converts
+ * back to the exact VSS type at the publish edge.
+ */
+enum class SlotType : uint8_t {
+    NONE,
+    BOOL,
+    INT8,
+    INT16,
+    INT32,
+    INT64,
+    UINT8,
+    UINT16,
+    UINT32,
+    UINT64,
+    FLOAT,
+    DOUBLE,
+    STRUCT,  ///< Index of a struct whose fields are slots of their own
+};
+
+template <typename T>
+constexpr SlotType slot_type_of() {
+    if constexpr (std::is_same_v<T, bool>) {
+        return SlotType::BOOL;
+    } else if constexpr (std::is_same_v<T, int8_t>) {
+        return SlotType::INT8;
+    } else if constexpr (std::is_same_v<T, int16_t>) {
+        return SlotType::INT16;
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+        return SlotType::INT32;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+        return SlotType::INT64;
+    } else if constexpr (std::is_same_v<T, uint8_t>) {
+        return SlotType::UINT8;
+    } else if constexpr (std::is_same_v<T, uint16_t>) {
+        return SlotType::UINT16;
+    } else if constexpr (std::is_same_v<T, uint32_t>) {
+        return SlotType::UINT32;
+    } else if constexpr (std::is_same_v<T, uint64_t>) {
+        return SlotType::UINT64;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return SlotType::FLOAT;
+    } else if constexpr (std::is_same_v<T, double>) {
+        return SlotType::DOUBLE;
+    } else {
+        static_assert(!sizeof(T), "unsupported slot type");
+    }
+}
+
+/**
+ * @brief Position of a signal in the typed slot arrays
+ */
+struct SlotRef {
+    SlotType type = SlotType::NONE;
+    uint16_t index = 0;
+};
+
+/**
+ * @brief A struct field: its name and the slot holding its value
+ */
+struct StructFieldInfo {
+    std::string_view name;
+    SlotRef slot;
+};
+
+/**
+ * @brief Schema of a struct signal: VSS type and its fields' range in the
+ *        generated kStructFields table
+ */
+struct StructInfo {
+    std::string_view type;
+    uint16_t first_field = 0;
+    uint16_t field_count = 0;
+};
+
+/**
+ * @brief Passed to a generated DAG's sink for struct nodes instead of a value
+ */
+struct StructRef {
+    uint16_t index = 0;
+};
+
+/**
+ * @brief A signal value in 16 bytes, copied without allocation or visitation
+ *
+ * Used to carry compiled-in signal values from the loop thread to the publish
+ * lanes; only the lane converts it to a vss::types::Value.
+ */
+struct TypedValue {
+    SlotType type = SlotType::NONE;
+    union {
+        bool b;
+        int64_t i;
+        uint64_t u;
+        float f;
+        double d;
+    };
+
+    TypedValue() : u(0) {}
+
+    template <typename T>
+    static TypedValue of(T value) {
+        TypedValue typed;
+        typed.type = slot_type_of<T>();
+        if constexpr (std::is_same_v<T, bool>) {
+            typed.b = value;
+        } else if constexpr (std::is_same_v<T, float>) {
+            typed.f = value;
+        } else if constexpr (std::is_same_v<T, double>) {
+            typed.d = value;
+        } else if constexpr (std::is_signed_v<T>) {
+            typed.i = value;
+        } else {
+            typed.u = value;
+        }
+        return typed;
+    }
+
+    static TypedValue structure(StructRef ref) {
+        TypedValue typed;
+        typed.type = SlotType::STRUCT;
+        typed.u = ref.index;
+        return typed;
+    }
+
+    bool has_value() const { return type != SlotType::NONE; }
+};
+
+static_assert(std::is_trivially_copyable_v<TypedValue>);
+
+/**
+ * @brief A compiled-in signal's new value, identified by its node index
+ */
+struct TypedSignal {
+    uint32_t id = 0;
+    TypedValue value;
+};
+
+}  // namespace can2vss
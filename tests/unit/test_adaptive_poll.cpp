@@ -0,0 +1,58 @@
+/**
+ * @file test_adaptive_poll.cpp
+ * @brief Unit tests for AdaptivePollController
+ */
+
+#include <gtest/gtest.h>
+
+#include "adaptive_poll.h"
+
+using namespace can2vss;
+using namespace std::chrono_literals;
+
+TEST(AdaptivePollTest, IdleUsesMaxWait) {
+    AdaptivePollController controller;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(controller.update(0, 50ms, 0ns), 50ms);
+    }
+    EXPECT_EQ(controller.arrival_rate(), 0.0);
+}
+
+TEST(AdaptivePollTest, HighRateShortensWait) {
+    AdaptivePollController controller;
+    // 200 updates in 10 ms = 20k updates/s -> 32 updates take 1.6 ms
+    auto wait = controller.update(200, 10ms, 0ns);
+    EXPECT_EQ(wait, 1600us);
+    EXPECT_NEAR(controller.expected_batch(), 32.0, 0.5);
+}
+
+TEST(AdaptivePollTest, WaitBoundedByLatencyBudget) {
+    AdaptivePollController controller;
+    // 500 updates/s alone would allow a 64 ms wait
+    auto wait = controller.update(5, 10ms, 0ns);
+    EXPECT_EQ(wait, 10ms);
+
+    // Publish latency eats into the budget
+    wait = controller.update(5, 10ms, 7ms);
+    EXPECT_EQ(wait, 3ms);
+
+    // Never below min_wait, even when publishing is over budget
+    wait = controller.update(5, 10ms, 20ms);
+    EXPECT_EQ(wait, 500us);
+}
+
+TEST(AdaptivePollTest, BurstAfterIdleReactsImmediately) {
+    AdaptivePollController controller;
+    controller.update(0, 50ms, 0ns);
+    auto wait = controller.update(1000, 50ms, 0ns);  // 20k updates/s
+    EXPECT_EQ(wait, 1600us);
+}
+
+TEST(AdaptivePollTest, RateDecaysGradually) {
+    AdaptivePollController controller;
+    controller.update(200, 10ms, 0ns);
+    double peak = controller.arrival_rate();
+    controller.update(0, 10ms, 0ns);
+    EXPECT_LT(controller.arrival_rate(), peak);
+    EXPECT_GT(controller.arrival_rate(), peak / 2);
+}
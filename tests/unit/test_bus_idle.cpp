@@ -0,0 +1,89 @@
+/**
+ * @file test_bus_idle.cpp
+ * @brief Unit tests for bus-silence detection
+ */
+
+#include <gtest/gtest.h>
+
+#include "bus_idle.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace can2vss;
+using namespace std::chrono_literals;
+
+namespace {
+
+class BusIdleTest : public ::testing::Test {
+protected:
+    void SetUp() override { set_rx_packets(0); }
+    void TearDown() override { std::remove(path_.c_str()); }
+
+    void set_rx_packets(uint64_t value) {
+        std::ofstream out(path_, std::ios::trunc);
+        out << value << "\n";
+    }
+
+    const std::string path_ = ::testing::TempDir() + "can2vss_rx_packets";
+};
+
+}  // namespace
+
+TEST_F(BusIdleTest, SilentOnceIdleThresholdIsReached) {
+    BusIdleDetector detector("vcan0", 3000ms, path_);
+    const auto start = std::chrono::steady_clock::now();
+    detector.note_activity(start);
+
+    EXPECT_FALSE(detector.bus_silent(start + 2s));
+    EXPECT_FALSE(detector.bus_silent(start + 2999ms));
+    EXPECT_TRUE(detector.bus_silent(start + 3000ms));
+    EXPECT_TRUE(detector.bus_silent(start + 10s));
+}
+
+TEST_F(BusIdleTest, CounterChangeEndsSilence) {
+    BusIdleDetector detector("vcan0", 3000ms, path_);
+    const auto start = std::chrono::steady_clock::now();
+    detector.note_activity(start);
+    ASSERT_TRUE(detector.bus_silent(start + 5s));
+
+    // Frames arrived: the next sample sees the counter move and restarts the idle period
+    set_rx_packets(42);
+    EXPECT_FALSE(detector.bus_silent(start + 6s));
+    EXPECT_FALSE(detector.bus_silent(start + 8999ms));
+    EXPECT_TRUE(detector.bus_silent(start + 9s));
+}
+
+TEST_F(BusIdleTest, CounterIsSampledAtMostOncePerSecond) {
+    BusIdleDetector detector("vcan0", 3000ms, path_);
+    const auto start = std::chrono::steady_clock::now();
+    detector.note_activity(start);
+    ASSERT_TRUE(detector.bus_silent(start + 5s));
+
+    // Within a second of the last sample the counter is not read again
+    set_rx_packets(7);
+    EXPECT_TRUE(detector.bus_silent(start + 5500ms));
+    EXPECT_FALSE(detector.bus_silent(start + 6s));
+}
+
+TEST_F(BusIdleTest, NoteActivityEndsSilence) {
+    BusIdleDetector detector("vcan0", 3000ms, path_);
+    const auto start = std::chrono::steady_clock::now();
+    detector.note_activity(start);
+    ASSERT_TRUE(detector.bus_silent(start + 4s));
+
+    detector.note_activity(start + 4s);
+    EXPECT_FALSE(detector.bus_silent(start + 4s));
+    EXPECT_FALSE(detector.bus_silent(start + 6999ms));
+    EXPECT_TRUE(detector.bus_silent(start + 7s));
+}
+
+TEST_F(BusIdleTest, UnreadableCounterKeepsLastActivity) {
+    BusIdleDetector detector("vcan0", 3000ms, path_ + ".missing");
+    const auto start = std::chrono::steady_clock::now();
+    detector.note_activity(start);
+
+    EXPECT_FALSE(detector.bus_silent(start + 2s));
+    EXPECT_TRUE(detector.bus_silent(start + 3s));
+}
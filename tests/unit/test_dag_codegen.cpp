@@ -0,0 +1,195 @@
+/**
+ * @file test_dag_codegen.cpp
+ * @brief Unit tests for the mapping DAG code generator
+ */
+
+#include <gtest/gtest.h>
+
+#include "dag_codegen.h"
+
+#include <algorithm>
+
+using namespace can2vss;
+
+namespace {
+
+std::string translate(const std::string& code, const std::vector<std::string>& deps = {}, bool* boolean = nullptr) {
+    bool is_boolean = false;
+    auto result = translate_expression(code, deps, true, &is_boolean);
+    if (boolean != nullptr) {
+        *boolean = is_boolean;
+    }
+    return result.ok() ? *result : "error: " + std::string(result.status().message());
+}
+
+DagNodeSpec node(const std::string& name, const std::string& source, const std::string& datatype) {
+    DagNodeSpec spec;
+    spec.name = name;
+    spec.source_type = source.empty() ? "" : "dbc";
+    spec.source_name = source;
+    spec.datatype = datatype;
+    return spec;
+}
+
+DagNodeSpec derived(const std::string& name, const std::string& datatype, const std::string& code,
+                    std::vector<std::string> deps) {
+    DagNodeSpec spec = node(name, "", datatype);
+    spec.transform = DagNodeSpec::Transform::CODE;
+    spec.code = code;
+    spec.depends_on = std::move(deps);
+    return spec;
+}
+
+std::string reason_for(const DagCodegenResult& result, const std::string& name) {
+    for (const auto& [node_name, reason] : result.interpreted) {
+        if (node_name == name) {
+            return reason;
+        }
+    }
+    return {};
+}
+
+}  // namespace
+
+TEST(DagCodegenTest, TranslatesLuaArithmetic) {
+    EXPECT_EQ(translate("x"), "x");
+    EXPECT_EQ(translate("return x * 0.5 + 1;"), "((x * 0.5) + 1.0)");
+    EXPECT_EQ(translate("-x^2"), "(-std::pow(x, 2.0))");
+    EXPECT_EQ(translate("x % 360"), "lua_mod(x, 360.0)");
+    EXPECT_EQ(translate("x // 10"), "std::floor(x / 10.0)");
+    EXPECT_EQ(translate("math.max(x, 0, .5)"), "std::fmax(std::fmax(x, 0.0), 0.5)");
+    EXPECT_EQ(translate("deps[\"A.B\"] - deps['C']", {"C", "A.B"}), "(d1 - d0)");
+
+    bool boolean = false;
+    EXPECT_EQ(translate("x ~= 0", {}, &boolean), "(x != 0.0)");
+    EXPECT_TRUE(boolean);
+}
+
+TEST(DagCodegenTest, RejectsUnsupportedLua) {
+    EXPECT_EQ(translate("string.format('%d', x)").rfind("error:", 0), 0u);
+    EXPECT_EQ(translate("x > 0 and 1 or 0").rfind("error:", 0), 0u);
+    EXPECT_EQ(translate("deps[\"Missing\"]").rfind("error:", 0), 0u);
+    EXPECT_EQ(translate("(x > 1) * 2").rfind("error:", 0), 0u);
+    EXPECT_FALSE(translate_expression("x", {}, false, nullptr).ok());
+}
+
+TEST(DagCodegenTest, OrdersNodesTopologically) {
+    std::vector<DagNodeSpec> nodes = {
+        derived("C", "double", "deps[\"B\"] * 2", {"B"}),
+        derived("B", "float", "deps[\"A\"] + 1", {"A"}),
+        node("A", "SIG_a", "float"),
+    };
+    auto result = generate_dag(nodes, "test");
+    ASSERT_TRUE(result.ok()) << result.status();
+    EXPECT_EQ(result->generated, (std::vector<std::string>{"A", "B", "C"}));
+    EXPECT_TRUE(result->interpreted.empty());
+    EXPECT_NE(result->header.find("kInputCount = 1"), std::string::npos);
+    EXPECT_NE(result->header.find("\"SIG_a\""), std::string::npos);
+}
+
+TEST(DagCodegenTest, LeavesUnsupportedNodesAndTheirNeighboursInterpreted) {
+    DagNodeSpec gear = node("Gear", "DI_gear", "string");
+    DagNodeSpec periodic = node("Periodic", "SIG_p", "float");
+    periodic.update_trigger = "periodic";
+
+    std::vector<DagNodeSpec> nodes = {
+        node("Speed", "DI_vehicleSpeed", "float"),
+        gear,
+        derived("IsParked", "boolean", "deps[\"Gear\"] == 1", {"Gear"}),
+        periodic,
+        // Only feeds an interpreted node, so must be interpreted itself
+        node("Raw", "SIG_raw", "float"),
+        derived("Label", "string", "deps[\"Raw\"]", {"Raw"}),
+        derived("Loop1", "float", "deps[\"Loop2\"]", {"Loop2"}),
+        derived("Loop2", "float", "deps[\"Loop1\"]", {"Loop1"}),
+    };
+    auto result = generate_dag(nodes, "test");
+    ASSERT_TRUE(result.ok()) << result.status();
+
+    EXPECT_EQ(result->generated, std::vector<std::string>{"Speed"});
+    EXPECT_NE(reason_for(*result, "Gear").find("datatype"), std::string::npos);
+    EXPECT_NE(reason_for(*result, "IsParked").find("interpreted 'Gear'"), std::string::npos);
+    EXPECT_NE(reason_for(*result, "Periodic").find("periodic"), std::string::npos);
+    EXPECT_NE(reason_for(*result, "Raw").find("needed by interpreted 'Label'"), std::string::npos);
+    EXPECT_EQ(reason_for(*result, "Loop1"), "dependency cycle");
+}
+
+TEST(DagCodegenTest, TranslatesStructTables) {
+    auto fields = translate_struct("{ speed = deps[\"Speed\"], moving = x > 0.5 }", {"Speed"}, true);
+    ASSERT_TRUE(fields.ok()) << fields.status();
+    ASSERT_EQ(fields->size(), 2u);
+    EXPECT_EQ((*fields)[0].name, "speed");
+    EXPECT_EQ((*fields)[0].expression, "d0");
+    EXPECT_FALSE((*fields)[0].uses_source);
+    EXPECT_EQ((*fields)[0].dependencies, std::vector<size_t>{0});
+    EXPECT_EQ((*fields)[1].name, "moving");
+    EXPECT_TRUE((*fields)[1].is_boolean);
+    EXPECT_TRUE((*fields)[1].uses_source);
+    EXPECT_TRUE((*fields)[1].dependencies.empty());
+
+    EXPECT_FALSE(translate_struct("x", {}, true).ok());
+    EXPECT_FALSE(translate_struct("{ a = 1, a = 2 }", {}, true).ok());
+}
+
+TEST(DagCodegenTest, CompilesStructsButNotReadsOfThem) {
+    DagNodeSpec motion = derived("Motion", "struct", "{ speed = deps[\"Speed\"] }", {"Speed"});
+    motion.struct_type = "Types.Motion";
+    std::vector<DagNodeSpec> nodes = {node("Speed", "DI_vehicleSpeed", "float"), motion};
+    auto result = generate_dag(nodes, "test");
+    ASSERT_TRUE(result.ok()) << result.status();
+    EXPECT_EQ(result->generated, (std::vector<std::string>{"Speed", "Motion"}));
+    EXPECT_NE(result->header.find("\"Types.Motion\""), std::string::npos);
+
+    // Reading a struct as a number stays interpreted, and pulls in what it needs
+    nodes.push_back(derived("Twice", "double", "deps[\"Motion\"] * 2", {"Motion"}));
+    result = generate_dag(nodes, "test");
+    ASSERT_TRUE(result.ok()) << result.status();
+    EXPECT_TRUE(result->generated.empty());
+    EXPECT_NE(reason_for(*result, "Twice").find("reads struct 'Motion'"), std::string::npos);
+    EXPECT_NE(reason_for(*result, "Motion").find("needed by interpreted 'Twice'"), std::string::npos);
+}
+
+TEST(DagCodegenTest, RejectsDuplicateSignals) {
+    auto result = generate_dag({node("A", "X", "float"), node("A", "Y", "float")}, "test");
+    EXPECT_FALSE(result.ok());
+}
+
+TEST(DagCodegenTest, RejectsMoreSlotsThanSixteenBitIndicesAddress) {
+    std::vector<DagNodeSpec> nodes;
+    for (size_t i = 0; i < 65536; ++i) {
+        nodes.push_back(node("Signal" + std::to_string(i), "Input" + std::to_string(i), "float"));
+    }
+    auto result = generate_dag(nodes, "test");
+    ASSERT_FALSE(result.ok());
+    EXPECT_NE(result.status().message().find("65536 slots in the floats array"), std::string::npos);
+
+    nodes.pop_back();
+    nodes.back().datatype = "double";
+    EXPECT_TRUE(generate_dag(nodes, "test").ok());
+}
+
+TEST(DagCodegenTest, CompilesNodesFedByOperators) {
+    DagNodeSpec average = node("Vehicle.AverageSpeed", "Vehicle.AverageSpeed", "float");
+    average.source_type = "operator";
+    std::vector<DagNodeSpec> nodes = {
+        average,
+        derived("Vehicle.AverageSpeedMps", "double", "deps[\"Vehicle.AverageSpeed\"] / 3.6", {"Vehicle.AverageSpeed"}),
+    };
+    auto result = generate_dag(nodes, "test");
+    ASSERT_TRUE(result.ok()) << result.status();
+    EXPECT_EQ(result->generated, (std::vector<std::string>{"Vehicle.AverageSpeed", "Vehicle.AverageSpeedMps"}));
+    EXPECT_NE(result->header.find("kInputCount = 1"), std::string::npos);
+}
+
+TEST(DagCodegenTest, ChecksIntegerRangeBeforeNarrowing) {
+    DagNodeSpec gear = node("Gear", "DI_gear", "uint8");
+    gear.transform = DagNodeSpec::Transform::VALUE_MAP;
+    gear.value_map = {{"1", "255"}, {"2", "256"}};
+    std::vector<DagNodeSpec> nodes = {node("Rpm", "DI_motorRPM", "int16"), gear};
+    auto result = generate_dag(nodes, "test");
+    ASSERT_TRUE(result.ok()) << result.status();
+
+    EXPECT_EQ(result->generated, std::vector<std::string>{"Rpm"});
+    EXPECT_NE(reason_for(*result, "Gear").find("'256' out of range for uint8"), std::string::npos);
+    EXPECT_NE(result->header.find("if (fits<int16_t>(raw)) {"), std::string::npos);
+}
@@ -0,0 +1,204 @@
+/**
+ * @file test_dbc_parser.cpp
+ * @brief Unit tests for the DBC reader and the decoder code generator
+ */
+
+#include <gtest/gtest.h>
+
+#include "dbc_parser.h"
+#include "decoder_codegen.h"
+
+#include <sstream>
+
+using namespace can2vss;
+
+namespace {
+
+const std::string kModel3Dbc = std::string(CAN2VSS_TEST_DATA_DIR) + "/Model3CAN.dbc";
+
+const DbcSignal* find_signal(const DbcMessage& message, const std::string& name) {
+    for (const auto& signal : message.signals) {
+        if (signal.name == name) {
+            return &signal;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+TEST(DbcParserTest, ParsesModel3Dbc) {
+    auto db = parse_dbc_file(kModel3Dbc);
+    ASSERT_TRUE(db.ok()) << db.status();
+    EXPECT_EQ(db->messages.size(), 159u);
+
+    const DbcMessage* speed_message = db->find_message_for_signal("DI_vehicleSpeed");
+    ASSERT_NE(speed_message, nullptr);
+    EXPECT_EQ(speed_message->id, 0x257u);
+    EXPECT_EQ(speed_message->dlc, 8u);
+
+    const DbcSignal* speed = find_signal(*speed_message, "DI_vehicleSpeed");
+    ASSERT_NE(speed, nullptr);
+    EXPECT_EQ(speed->start_bit, 12u);
+    EXPECT_EQ(speed->length, 12u);
+    EXPECT_TRUE(speed->little_endian);
+    EXPECT_FALSE(speed->is_signed);
+    EXPECT_DOUBLE_EQ(speed->factor, 0.08);
+    EXPECT_DOUBLE_EQ(speed->offset, -40.0);
+    EXPECT_EQ(speed->unit, "kph");
+
+    const uint8_t frame[8] = {0xC3, 0x49, 0x1F, 0x00, 0x02, 0x00, 0x00, 0x00};
+    EXPECT_NEAR(decode_physical(*speed, frame), 0.0, 1e-9);
+}
+
+TEST(DbcParserTest, ParsesMultiplexedAndMotorolaSignals) {
+    std::istringstream dbc(
+        "BO_ 322 ID142VCLEFT_liftgateStatus: 8 VehicleBus\n"
+        " SG_ VCLEFT_liftgateStatusIndex M : 0|2@1+ (1,0) [0|2] \"\"  Receiver\n"
+        " SG_ VCLEFT_liftgatePosition m1 : 21|7@1- (1,46) [-5|95] \"deg\"  Receiver\n"
+        "\n"
+        "BO_ 2147483905 ExtendedMsg: 8 VehicleBus\n"
+        " SG_ GTW_bmpState : 7|8@0+ (1,0) [0|255] \"\"  Receiver\n"
+        "\n"
+        "CM_ SG_ 322 VCLEFT_liftgatePosition \"comment\";\n");
+    auto db = parse_dbc(dbc);
+    ASSERT_TRUE(db.ok()) << db.status();
+    ASSERT_EQ(db->messages.size(), 2u);
+
+    const auto& liftgate = db->messages[0];
+    ASSERT_NE(liftgate.multiplexor(), nullptr);
+    EXPECT_EQ(liftgate.multiplexor()->name, "VCLEFT_liftgateStatusIndex");
+    const DbcSignal* position = find_signal(liftgate, "VCLEFT_liftgatePosition");
+    ASSERT_NE(position, nullptr);
+    EXPECT_EQ(position->multiplex, DbcSignal::Multiplex::MULTIPLEXED);
+    EXPECT_EQ(position->mux_value, 1u);
+    EXPECT_TRUE(position->is_signed);
+
+    const auto& extended = db->messages[1];
+    EXPECT_TRUE(extended.extended);
+    EXPECT_EQ(extended.id, 0x101u);
+    EXPECT_FALSE(extended.signals[0].little_endian);
+}
+
+TEST(DbcParserTest, RejectsMalformedSignal) {
+    std::istringstream dbc("BO_ 1 Msg: 8 Node\n SG_ Broken : garbage\n");
+    EXPECT_FALSE(parse_dbc(dbc).ok());
+}
+
+TEST(DbcIndexTest, IndexesModel3Dbc) {
+    auto index = DbcIndex::build_from_file(kModel3Dbc);
+    ASSERT_TRUE(index.ok()) << index.status();
+    EXPECT_EQ((*index)->message_count(), 159u);
+    EXPECT_EQ((*index)->signal_count(), 2752u);
+    EXPECT_EQ((*index)->count_messages({"DI_vehicleSpeed", "DI_uiSpeed", "NoSuchSignal"}), 1u);
+}
+
+TEST(DbcIndexTest, LoadsOnlyMappedMessagesAsParsedInFull) {
+    auto full = parse_dbc_file(kModel3Dbc);
+    ASSERT_TRUE(full.ok()) << full.status();
+    auto lazy = parse_dbc_file_for_signals(kModel3Dbc, {"DI_vehicleSpeed", "VCLEFT_liftgatePosition"});
+    ASSERT_TRUE(lazy.ok()) << lazy.status();
+
+    ASSERT_EQ(lazy->messages.size(), 2u);
+    for (const auto& message : lazy->messages) {
+        const DbcMessage* reference = full->find_message_for_signal(message.signals.front().name);
+        ASSERT_NE(reference, nullptr);
+        EXPECT_EQ(message.id, reference->id);
+        EXPECT_EQ(message.name, reference->name);
+        ASSERT_EQ(message.signals.size(), reference->signals.size());
+        for (size_t i = 0; i < message.signals.size(); ++i) {
+            EXPECT_EQ(message.signals[i].name, reference->signals[i].name);
+            EXPECT_EQ(message.signals[i].start_bit, reference->signals[i].start_bit);
+            EXPECT_EQ(message.signals[i].multiplex, reference->signals[i].multiplex);
+        }
+    }
+
+    auto header = generate_decoders(*lazy, {"DI_vehicleSpeed", "VCLEFT_liftgatePosition"}, "test");
+    auto reference_header = generate_decoders(*full, {"DI_vehicleSpeed", "VCLEFT_liftgatePosition"}, "test");
+    ASSERT_TRUE(header.ok()) << header.status();
+    EXPECT_EQ(*header, *reference_header);
+}
+
+TEST(DbcIndexTest, SubsetDropsOtherMessagesAndTheirStatements) {
+    auto index = DbcIndex::build(
+        "VERSION \"\"\r\n"
+        "BU_: VehicleBus\r\n"
+        "\r\n"
+        "BO_ 257 Kept: 8 VehicleBus\r\n"
+        " SG_ KeptSignal : 0|8@1+ (1,0) [0|255] \"\"  Receiver\r\n"
+        "\r\n"
+        "BO_ 258 Dropped: 8 VehicleBus\r\n"
+        " SG_ DroppedSignal : 0|8@1+ (1,0) [0|255] \"\"  Receiver\r\n"
+        "\r\n"
+        "CM_ SG_ 257 KeptSignal \"kept\";\r\n"
+        "CM_ SG_ 258 DroppedSignal \"spans\r\n"
+        "two lines\";\r\n"
+        "BA_DEF_ BO_ \"GenMsgCycleTime\" INT 0 65535;\r\n"
+        "BA_ \"GenMsgCycleTime\" BO_ 258 100;\r\n"
+        "BA_ \"GenMsgCycleTime\" BO_ 257 10;\r\n"
+        "VAL_ 258 DroppedSignal 0 \"OFF\" 1 \"ON\" ;\r\n"
+        "VAL_ 257 KeptSignal 0 \"OFF\" 1 \"ON\" ;\r\n");
+    ASSERT_TRUE(index.ok()) << index.status();
+
+    auto subset = (*index)->subset_text({"KeptSignal"});
+    EXPECT_NE(subset.find("BO_ 257 Kept"), std::string::npos);
+    EXPECT_NE(subset.find("CM_ SG_ 257"), std::string::npos);
+    EXPECT_NE(subset.find("BA_ \"GenMsgCycleTime\" BO_ 257"), std::string::npos);
+    EXPECT_NE(subset.find("VAL_ 257"), std::string::npos);
+    EXPECT_NE(subset.find("BA_DEF_ BO_"), std::string::npos);
+    EXPECT_EQ(subset.find("258"), std::string::npos);
+    EXPECT_EQ(subset.find("two lines"), std::string::npos);
+
+    std::istringstream in(subset);
+    auto db = parse_dbc(in);
+    ASSERT_TRUE(db.ok()) << db.status();
+    ASSERT_EQ(db->messages.size(), 1u);
+    EXPECT_EQ(db->messages[0].signals[0].name, "KeptSignal");
+}
+
+TEST(DbcIndexTest, SubsetSkipsSemicolonsInsideMultiLineComments) {
+    auto index = DbcIndex::build(
+        "BO_ 257 Kept: 8 VehicleBus\n"
+        " SG_ KeptSignal : 0|8@1+ (1,0) [0|255] \"\"  Receiver\n"
+        "\n"
+        "BO_ 258 Dropped: 8 VehicleBus\n"
+        " SG_ DroppedSignal : 0|8@1+ (1,0) [0|255] \"\"  Receiver\n"
+        "\n"
+        "CM_ SG_ 258 DroppedSignal \"first line;\n"
+        "a \\\"quoted\\\"; line;\n"
+        "CM_ SG_ 257 KeptSignal looks like a statement\";\n"
+        "CM_ SG_ 257 KeptSignal \"kept;\n"
+        "CM_ SG_ 258 DroppedSignal inside the kept comment\";\n"
+        "VAL_ 257 KeptSignal 0 \"OFF\" 1 \"ON\" ;\n");
+    ASSERT_TRUE(index.ok()) << index.status();
+
+    auto subset = (*index)->subset_text({"KeptSignal"});
+    EXPECT_EQ(subset.find("first line"), std::string::npos);
+    EXPECT_EQ(subset.find("quoted"), std::string::npos);
+    EXPECT_EQ(subset.find("looks like a statement"), std::string::npos);
+    EXPECT_NE(subset.find("CM_ SG_ 257 KeptSignal \"kept;\n"), std::string::npos);
+    EXPECT_NE(subset.find("inside the kept comment"), std::string::npos);
+    EXPECT_NE(subset.find("VAL_ 257"), std::string::npos);
+}
+
+TEST(DecoderCodegenTest, GeneratesOnlyMappedMessages) {
+    auto db = parse_dbc_file(kModel3Dbc);
+    ASSERT_TRUE(db.ok()) << db.status();
+
+    auto header = generate_decoders(*db, {"DI_vehicleSpeed", "VCLEFT_liftgatePosition"}, "test");
+    ASSERT_TRUE(header.ok()) << header.status();
+
+    EXPECT_NE(header->find("case 0x257:"), std::string::npos);
+    EXPECT_NE(header->find("case 0x142:"), std::string::npos);
+    EXPECT_NE(header->find("extract_intel<12, 12>(data)) * 0.08 - 40.0"), std::string::npos);
+    EXPECT_NE(header->find("if (mux == 1)"), std::string::npos);
+    EXPECT_EQ(header->find("case 0x113:"), std::string::npos);
+    EXPECT_NE(header->find("kSignalMessageIds = {0x142, 0x257};"), std::string::npos);
+}
+
+TEST(DecoderCodegenTest, FailsOnUnknownSignal) {
+    auto db = parse_dbc_file(kModel3Dbc);
+    ASSERT_TRUE(db.ok()) << db.status();
+    auto header = generate_decoders(*db, {"NoSuchSignal"}, "test");
+    EXPECT_FALSE(header.ok());
+}
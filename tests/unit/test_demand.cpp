@@ -0,0 +1,120 @@
+/**
+ * @file test_demand.cpp
+ * @brief Unit tests for demand-driven decoding plans
+ */
+
+#include <gtest/gtest.h>
+
+#include "demand.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+using namespace can2vss;
+
+namespace {
+
+std::vector<DemandSignal> mapping() {
+    return {
+        {"Vehicle.Speed", "DI_vehicleSpeed", {}},
+        {"Vehicle.Acceleration.Longitudinal", "", {"Vehicle.Speed"}},
+        {"Vehicle.Private.HarshBraking", "", {"Vehicle.Acceleration.Longitudinal"}},
+        {"Vehicle.Powertrain.Gear", "DI_gear", {}},
+        {"Vehicle.Powertrain.IsParked", "", {"Vehicle.Powertrain.Gear"}},
+        {"Vehicle.Cabin.Temperature", "VCRIGHT_cabinTemp", {}},
+    };
+}
+
+}  // namespace
+
+TEST(DemandTest, ParsesPathsAndSkipsComments) {
+    auto patterns = parse_demand("# consumers\nVehicle.Speed\n\n  Vehicle.Powertrain \r\n#Vehicle.Cabin\n");
+    EXPECT_EQ(patterns, (std::vector<std::string>{"Vehicle.Speed", "Vehicle.Powertrain"}));
+}
+
+TEST(DemandTest, MatchesPathsAndBranches) {
+    std::vector<std::string> patterns = {"Vehicle.Speed", "Vehicle.Powertrain"};
+    EXPECT_TRUE(is_demanded("Vehicle.Speed", patterns));
+    EXPECT_TRUE(is_demanded("Vehicle.Powertrain.Gear", patterns));
+    EXPECT_FALSE(is_demanded("Vehicle.SpeedLimit", patterns));
+    EXPECT_FALSE(is_demanded("Vehicle", patterns));
+}
+
+TEST(DemandTest, ActivatesUpstreamOfDemandedSignals) {
+    auto signals = mapping();
+    auto plan = plan_demand(signals, {"Vehicle.Private.HarshBraking"});
+
+    EXPECT_EQ(plan.published, (std::vector<bool>{false, false, true, false, false, false}));
+    EXPECT_EQ(plan.active, (std::vector<bool>{true, true, true, false, false, false}));
+    EXPECT_EQ(plan.can_signals, (std::unordered_set<std::string>{"DI_vehicleSpeed"}));
+    EXPECT_EQ(plan.published_count, 1u);
+    EXPECT_EQ(plan.active_count, 3u);
+}
+
+TEST(DemandTest, NothingDemandedDisablesEverything) {
+    auto plan = plan_demand(mapping(), {});
+    EXPECT_EQ(plan.active_count, 0u);
+    EXPECT_TRUE(plan.can_signals.empty());
+}
+
+TEST(DemandTest, FileReloadsOnChange) {
+    char path[] = "/tmp/can2vss-demand-XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    unlink(path);
+
+    DemandFile demand(path);
+    EXPECT_TRUE(demand.reload_if_changed());
+    EXPECT_FALSE(demand.exists());
+    EXPECT_FALSE(demand.reload_if_changed());
+
+    std::ofstream(path) << "Vehicle.Speed\n";
+    EXPECT_TRUE(demand.reload_if_changed());
+    EXPECT_TRUE(demand.exists());
+    EXPECT_EQ(demand.patterns(), (std::vector<std::string>{"Vehicle.Speed"}));
+    EXPECT_FALSE(demand.reload_if_changed());
+
+    unlink(path);
+    EXPECT_TRUE(demand.reload_if_changed());
+    EXPECT_FALSE(demand.exists());
+    EXPECT_TRUE(demand.patterns().empty());
+}
+
+TEST(DemandTest, WatcherHandsOverPlansWithoutBlockingTheLoop) {
+    char path[] = "/tmp/can2vss-demand-XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    std::ofstream(path) << "Vehicle.Powertrain.IsParked\n";
+
+    std::atomic<int> listened{0};
+    DemandWatcher watcher(path, mapping(), std::chrono::milliseconds(5),
+                          [&](const DemandUpdate&) { listened.fetch_add(1); });
+    EXPECT_TRUE(watcher.check());
+    EXPECT_FALSE(watcher.check());
+    EXPECT_EQ(listened.load(), 1);
+
+    auto first = watcher.take();
+    ASSERT_NE(first, nullptr);
+    EXPECT_FALSE(first->everything);
+    EXPECT_EQ(first->plan.can_signals, (std::unordered_set<std::string>{"DI_gear"}));
+    EXPECT_EQ(watcher.take(), nullptr);
+
+    // The watcher thread notices the file going away and plans everything
+    watcher.start();
+    unlink(path);
+    std::unique_ptr<DemandUpdate> second;
+    for (int i = 0; i < 1000 && !second; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        second = watcher.take();
+    }
+    ASSERT_NE(second, nullptr);
+    EXPECT_TRUE(second->everything);
+    watcher.retire(std::move(first));
+    watcher.stop();
+    EXPECT_EQ(listened.load(), 2);
+}
@@ -0,0 +1,148 @@
+/**
+ * @file test_event_loop.cpp
+ * @brief Unit tests for the coroutine event loop
+ */
+
+#include <gtest/gtest.h>
+
+#include "event_loop.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+
+using namespace can2vss;
+using namespace std::chrono_literals;
+
+TEST(EventLoopTest, TimersResumeInDeadlineOrder) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.initialize());
+    std::string order;
+
+    auto sleeper = [&](char name, std::chrono::milliseconds delay) -> Task {
+        co_await loop.sleep_for(delay);
+        order += name;
+        if (order.size() == 3) {
+            loop.stop();
+        }
+    };
+    sleeper('c', 30ms);
+    sleeper('a', 5ms);
+    sleeper('b', 15ms);
+    EXPECT_EQ(loop.pending(), 3u);
+
+    loop.run();
+    EXPECT_EQ(order, "abc");
+    EXPECT_EQ(loop.pending(), 0u);
+}
+
+TEST(EventLoopTest, PeriodicTaskKeepsItsSchedule) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.initialize());
+    int ticks = 0;
+    const auto start = EventLoop::Clock::now();
+
+    auto ticker = [&]() -> Task {
+        auto next = EventLoop::Clock::now();
+        while (ticks < 5) {
+            next += 10ms;
+            co_await loop.sleep_until(next);
+            ++ticks;
+        }
+        loop.stop();
+    };
+    ticker();
+    loop.run();
+
+    EXPECT_EQ(ticks, 5);
+    EXPECT_GE(EventLoop::Clock::now() - start, 50ms);
+}
+
+TEST(EventLoopTest, LaggingTimerYieldsToOtherWork) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.initialize());
+    int fd = eventfd(1, EFD_NONBLOCK);  // readable from the start
+    ASSERT_GE(fd, 0);
+    int lagging_rounds = 0;
+    bool read_done = false;
+
+    // Deadlines already passed, as for a periodic task that fell behind
+    auto lagging = [&]() -> Task {
+        auto next = EventLoop::Clock::now() - 1s;
+        while (!read_done && lagging_rounds < 100000) {
+            next += 1ms;
+            co_await loop.sleep_until(next);
+            ++lagging_rounds;
+        }
+        loop.stop();
+    };
+    auto reader = [&]() -> Task {
+        co_await loop.readable(fd);
+        read_done = true;
+    };
+    lagging();
+    EXPECT_EQ(lagging_rounds, 0);  // suspended although its deadline has passed
+    reader();
+
+    loop.run();
+    EXPECT_TRUE(read_done);
+    EXPECT_LE(lagging_rounds, 2);
+    close(fd);
+}
+
+TEST(EventLoopTest, ReadableResumesWhenDataArrives) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.initialize());
+    int fd = eventfd(0, EFD_NONBLOCK);
+    ASSERT_GE(fd, 0);
+    uint64_t total = 0;
+
+    auto reader = [&]() -> Task {
+        while (total < 3) {
+            co_await loop.readable(fd);
+            uint64_t value = 0;
+            if (read(fd, &value, sizeof(value)) == sizeof(value)) {
+                total += value;
+            }
+        }
+        loop.stop();
+    };
+    auto writer = [&]() -> Task {
+        for (int i = 0; i < 3; ++i) {
+            co_await loop.sleep_for(2ms);
+            uint64_t one = 1;
+            [[maybe_unused]] auto n = write(fd, &one, sizeof(one));
+        }
+    };
+    reader();
+    writer();
+    loop.run();
+
+    EXPECT_EQ(total, 3u);
+    close(fd);
+}
+
+TEST(EventLoopTest, StopFromAnotherThreadEndsRun) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.initialize());
+    bool resumed = false;
+
+    // Suspended forever; its frame is freed by the loop's destructor
+    auto waiter = [&]() -> Task {
+        co_await loop.sleep_for(1h);
+        resumed = true;
+    };
+    waiter();
+
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(10ms);
+        loop.stop();
+    });
+    loop.run();
+    stopper.join();
+
+    EXPECT_FALSE(resumed);
+    EXPECT_EQ(loop.pending(), 1u);
+}
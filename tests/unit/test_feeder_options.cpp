@@ -0,0 +1,59 @@
+/**
+ * @file test_feeder_options.cpp
+ * @brief Unit tests for command line parsing
+ */
+
+#include <gtest/gtest.h>
+
+#include "feeder_options.h"
+
+#include <string>
+#include <vector>
+
+using namespace can2vss;
+
+namespace {
+
+std::optional<FeederOptions> parse(std::vector<std::string> args) {
+    args.insert(args.begin(), "can2vss-feeder");
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(arg.data());
+    }
+    return parse_options(static_cast<int>(argv.size()), argv.data());
+}
+
+}  // namespace
+
+TEST(FeederOptionsTest, PositionalArgumentsOnly) {
+    auto options = parse({"vehicle.dbc", "mappings.yaml", "can0", "localhost:55555"});
+    ASSERT_TRUE(options.has_value());
+    EXPECT_EQ(options->dbc_file, "vehicle.dbc");
+    EXPECT_EQ(options->kuksa_address, "localhost:55555");
+    EXPECT_FALSE(options->low_latency.enabled);
+    EXPECT_EQ(options->low_latency.rx_cpu, -1);
+    EXPECT_TRUE(options->low_latency.lock_memory);
+
+    EXPECT_FALSE(parse({"vehicle.dbc", "mappings.yaml", "can0"}).has_value());
+}
+
+TEST(FeederOptionsTest, LowLatencyOptions) {
+    auto options = parse({"--low-latency", "vehicle.dbc", "--rx-cpu=3", "mappings.yaml", "--rt-priority=80",
+                          "--no-mlock", "can0", "localhost:55555"});
+    ASSERT_TRUE(options.has_value());
+    EXPECT_TRUE(options->low_latency.enabled);
+    EXPECT_EQ(options->low_latency.rx_cpu, 3);
+    EXPECT_EQ(options->low_latency.rt_priority, 80);
+    EXPECT_FALSE(options->low_latency.lock_memory);
+    EXPECT_EQ(options->can_interface, "can0");
+}
+
+TEST(FeederOptionsTest, RejectsInvalidValues) {
+    const std::vector<std::string> positional = {"vehicle.dbc", "mappings.yaml", "can0", "localhost:55555"};
+    for (const char* option : {"--rx-cpu=-1", "--rx-cpu=x", "--rx-cpu", "--rt-priority=0", "--rt-priority=100",
+                               "--unknown"}) {
+        auto args = positional;
+        args.push_back(option);
+        EXPECT_FALSE(parse(args).has_value()) << option;
+    }
+}
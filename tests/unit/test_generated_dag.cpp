@@ -0,0 +1,288 @@
+/**
+ * @file test_generated_dag.cpp
+ * @brief Tests of the code can2vss-codegen generates for tests/unit/data/generated_mappings.yaml
+ */
+
+#include <gtest/gtest.h>
+
+#include "can2vss_generated_dag.h"
+#include "can2vss_generated_decoders.h"
+
+#include <cmath>
+#include <map>
+#include <optional>
+#include <string>
+#include <variant>
+
+namespace dag = can2vss::generated_dag;
+
+namespace {
+
+using Output = std::variant<bool, uint8_t, float, double, can2vss::StructRef>;
+
+// Decoded signals only used by interpreted nodes (DI_gear) have no input slot
+std::optional<size_t> input_index(std::string_view name) {
+    for (size_t i = 0; i < dag::kInputNames.size(); ++i) {
+        if (dag::kInputNames[i] == name) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+/// Evaluates the DAG without new input and collects the published outputs
+std::map<std::string, Output> evaluate(dag::State& state, std::chrono::steady_clock::time_point now) {
+    std::map<std::string, Output> outputs;
+    dag::evaluate(state, now, [&](size_t node, auto value) {
+        outputs[std::string(dag::kNodeNames[node])] = Output{value};
+    });
+    return outputs;
+}
+
+/// Decodes a frame with the generated decoders, feeds the DAG and collects
+/// the published outputs by VSS path
+std::map<std::string, Output> run_frame(dag::State& state, uint32_t can_id, const uint8_t (&data)[8],
+                                        std::chrono::steady_clock::time_point now) {
+    can2vss::generated::decode_frame(can_id, data, 8, [&](size_t signal, double value) {
+        if (auto input = input_index(can2vss::generated::kSignalNames[signal])) {
+            dag::set_input(state, *input, value);
+        }
+    });
+
+    return evaluate(state, now);
+}
+
+}  // namespace
+
+TEST(GeneratedDagTest, CompilesOnlyNativeNodes) {
+    EXPECT_EQ(dag::kNodeCount, 6u);
+    for (auto name : dag::kNodeNames) {
+        EXPECT_NE(name, "Vehicle.Powertrain.Transmission.SelectedGear");
+        EXPECT_NE(name, "Vehicle.Powertrain.Transmission.IsParked");
+    }
+    // DI_gear is still decoded for the interpreted part
+    EXPECT_EQ(can2vss::generated::kSignalCount, 4u);
+}
+
+TEST(GeneratedDagTest, EvaluatesDerivedSignalsWithTypedValues) {
+    dag::State state;
+    const auto start = std::chrono::steady_clock::now();
+
+    // DI_vehicleSpeed raw 1000 -> 0.08 * 1000 - 40 = 40 kph
+    const uint8_t speed_frame[8] = {0x00, 0x80, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00};
+    auto outputs = run_frame(state, 0x257, speed_frame, start);
+
+    ASSERT_EQ(outputs.size(), 3u);
+    EXPECT_FLOAT_EQ(std::get<float>(outputs["Vehicle.Speed"]), 40.0f);
+    EXPECT_NEAR(std::get<double>(outputs["Vehicle.SpeedMetersPerSecond"]), 40.0 / 3.6, 1e-5);
+    EXPECT_TRUE(std::get<bool>(outputs["Vehicle.IsMoving"]));
+}
+
+TEST(GeneratedDagTest, ValueMappingAndIntervalThrottle) {
+    dag::State state;
+    const auto start = std::chrono::steady_clock::now();
+
+    // 0x118: DI_brakePedalState = 1 (bits 19-20), DI_accelPedalPos = 100 -> 40 %
+    uint8_t frame[8] = {0x00, 0x00, 0x08, 0x00, 100, 0x00, 0x00, 0x00};
+    auto outputs = run_frame(state, 0x118, frame, start);
+    EXPECT_TRUE(std::get<bool>(outputs["Vehicle.Chassis.Brake.IsPressed"]));
+    EXPECT_EQ(std::get<uint8_t>(outputs["Vehicle.OBD.RelativeAcceleratorPosition"]), 40);
+
+    // Within interval_ms the accelerator is updated but held
+    frame[4] = 50;
+    outputs = run_frame(state, 0x118, frame, start + std::chrono::milliseconds(10));
+    EXPECT_EQ(outputs.count("Vehicle.OBD.RelativeAcceleratorPosition"), 0u);
+    const can2vss::TypedValue stored = dag::read(state, 1);
+    EXPECT_EQ(stored.type, can2vss::SlotType::UINT8);
+    EXPECT_EQ(stored.u, 20u);
+
+    frame[4] = 60;
+    outputs = run_frame(state, 0x118, frame, start + std::chrono::milliseconds(500));
+    EXPECT_EQ(outputs.count("Vehicle.OBD.RelativeAcceleratorPosition"), 0u);
+    EXPECT_TRUE(evaluate(state, start + std::chrono::milliseconds(990)).empty());
+
+    // The latest held value goes out when the interval ends, without new input
+    outputs = evaluate(state, start + std::chrono::milliseconds(1000));
+    ASSERT_EQ(outputs.size(), 1u);
+    EXPECT_EQ(std::get<uint8_t>(outputs["Vehicle.OBD.RelativeAcceleratorPosition"]), 24);
+    EXPECT_TRUE(evaluate(state, start + std::chrono::milliseconds(3000)).empty());
+
+    // After a quiet interval a new value is published right away
+    frame[4] = 100;
+    outputs = run_frame(state, 0x118, frame, start + std::chrono::milliseconds(3010));
+    EXPECT_EQ(std::get<uint8_t>(outputs["Vehicle.OBD.RelativeAcceleratorPosition"]), 40);
+
+    // DI_brakePedalState = 2 has no mapping entry: no output
+    frame[2] = 0x10;
+    outputs = run_frame(state, 0x118, frame, start + std::chrono::milliseconds(3020));
+    EXPECT_EQ(outputs.count("Vehicle.Chassis.Brake.IsPressed"), 0u);
+}
+
+TEST(GeneratedDagTest, ValuesLiveInTypedSlotArrays) {
+    // Struct fields get slots of their own: MotionState adds a bool and two doubles
+    EXPECT_EQ(dag::kBoolSlots, 3u);
+    EXPECT_EQ(dag::kUintSlots, 1u);
+    EXPECT_EQ(dag::kFloatSlots, 1u);
+    EXPECT_EQ(dag::kDoubleSlots, 3u);
+
+    dag::State state;
+    const uint8_t speed_frame[8] = {0x00, 0x80, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00};
+    run_frame(state, 0x257, speed_frame, std::chrono::steady_clock::now());
+
+    for (size_t node = 0; node < dag::kNodeCount; ++node) {
+        if (dag::kNodeNames[node] == "Vehicle.Speed") {
+            EXPECT_EQ(dag::kNodeSlots[node].type, can2vss::SlotType::FLOAT);
+            EXPECT_FLOAT_EQ(state.floats[dag::kNodeSlots[node].index], 40.0f);
+            EXPECT_FLOAT_EQ(dag::read(state, node).f, 40.0f);
+        } else if (dag::kNodeNames[node] == "Vehicle.IsMoving") {
+            EXPECT_TRUE(state.bools[dag::kNodeSlots[node].index]);
+            EXPECT_TRUE(dag::read(state, node).b);
+        }
+    }
+}
+
+TEST(GeneratedDagTest, StructFieldsUpdateIndividually) {
+    ASSERT_EQ(dag::kStructCount, 1u);
+    EXPECT_EQ(dag::kStructs[0].type, "Types.MotionState");
+    ASSERT_EQ(dag::kStructs[0].field_count, 3u);
+
+    auto field = [](std::string_view name) {
+        for (const auto& info : dag::kStructFields) {
+            if (info.name == name) {
+                return info.slot;
+            }
+        }
+        ADD_FAILURE() << "no field " << name;
+        return can2vss::SlotRef{};
+    };
+
+    dag::State state;
+    const auto start = std::chrono::steady_clock::now();
+
+    // Needs both the speed and the pedal position before it is published
+    const uint8_t speed_frame[8] = {0x00, 0x80, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00};
+    auto outputs = run_frame(state, 0x257, speed_frame, start);
+    EXPECT_EQ(outputs.count("Vehicle.MotionState"), 0u);
+
+    uint8_t pedal_frame[8] = {0x00, 0x00, 0x00, 0x00, 100, 0x00, 0x00, 0x00};
+    outputs = run_frame(state, 0x118, pedal_frame, start);
+    ASSERT_EQ(outputs.count("Vehicle.MotionState"), 1u);
+    EXPECT_EQ(std::get<can2vss::StructRef>(outputs["Vehicle.MotionState"]).index, 0u);
+    EXPECT_DOUBLE_EQ(dag::read_slot(state, field("speed")).d, 40.0);
+    EXPECT_TRUE(dag::read_slot(state, field("moving")).b);
+    EXPECT_DOUBLE_EQ(dag::read_slot(state, field("pedal")).d, 40.0);
+
+    // A pedal-only change leaves the speed-derived fields alone
+    state.doubles[field("speed").index] = -1.0;
+    pedal_frame[4] = 50;
+    outputs = run_frame(state, 0x118, pedal_frame, start + std::chrono::milliseconds(10));
+    ASSERT_EQ(outputs.count("Vehicle.MotionState"), 1u);
+    EXPECT_DOUBLE_EQ(dag::read_slot(state, field("pedal")).d, 20.0);
+    EXPECT_DOUBLE_EQ(dag::read_slot(state, field("speed")).d, -1.0);
+
+    const can2vss::TypedValue stored = dag::read(state, 4);
+    EXPECT_EQ(stored.type, can2vss::SlotType::STRUCT);
+}
+
+TEST(GeneratedDagTest, TypedValueKeepsDeclaredType) {
+    auto value = can2vss::TypedValue::of(int16_t{-3});
+    EXPECT_EQ(value.type, can2vss::SlotType::INT16);
+    EXPECT_EQ(value.i, -3);
+    EXPECT_TRUE(value.has_value());
+    EXPECT_FALSE(can2vss::TypedValue().has_value());
+    EXPECT_EQ(can2vss::TypedValue::of(2.5f).f, 2.5f);
+}
+
+TEST(GeneratedDagTest, DerivedNodesWaitForValidInputs) {
+    dag::State state;
+    std::map<std::string, Output> outputs;
+    dag::evaluate(state, std::chrono::steady_clock::now(), [&](size_t node, auto value) {
+        outputs[std::string(dag::kNodeNames[node])] = Output{value};
+    });
+    EXPECT_TRUE(outputs.empty());
+}
+
+TEST(GeneratedDagTest, InvalidInputInvalidatesDerivedNodes) {
+    dag::State state;
+    const auto start = std::chrono::steady_clock::now();
+    const uint8_t speed_frame[8] = {0x00, 0x80, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00};
+    uint8_t pedal_frame[8] = {0x00, 0x00, 0x00, 0x00, 100, 0x00, 0x00, 0x00};
+    run_frame(state, 0x257, speed_frame, start);
+    ASSERT_EQ(run_frame(state, 0x118, pedal_frame, start).count("Vehicle.MotionState"), 1u);
+
+    // An out-of-range speed invalidates everything derived from it, directly or not
+    const auto speed = input_index("DI_vehicleSpeed");
+    ASSERT_TRUE(speed.has_value());
+    dag::invalidate_input(state, *speed);
+    EXPECT_TRUE(evaluate(state, start + std::chrono::milliseconds(10)).empty());
+    for (size_t node = 0; node < dag::kNodeCount; ++node) {
+        const bool derived = dag::kNodeNames[node] == "Vehicle.Speed" ||
+            dag::kNodeNames[node] == "Vehicle.SpeedMetersPerSecond" ||
+            dag::kNodeNames[node] == "Vehicle.IsMoving" || dag::kNodeNames[node] == "Vehicle.MotionState";
+        EXPECT_EQ(state.node_valid[node], !derived) << dag::kNodeNames[node];
+    }
+
+    // The struct does not go out with a stale speed while the pedal moves
+    pedal_frame[4] = 50;
+    auto outputs = run_frame(state, 0x118, pedal_frame, start + std::chrono::milliseconds(20));
+    EXPECT_EQ(outputs.count("Vehicle.MotionState"), 0u);
+
+    // A valid speed brings all of them back
+    outputs = run_frame(state, 0x257, speed_frame, start + std::chrono::milliseconds(30));
+    EXPECT_EQ(outputs.count("Vehicle.Speed"), 1u);
+    EXPECT_EQ(outputs.count("Vehicle.SpeedMetersPerSecond"), 1u);
+    EXPECT_EQ(outputs.count("Vehicle.IsMoving"), 1u);
+    ASSERT_EQ(outputs.count("Vehicle.MotionState"), 1u);
+}
+
+TEST(GeneratedDagTest, ValueOutsideIntegerTypeInvalidatesNode) {
+    dag::State state;
+    const auto start = std::chrono::steady_clock::now();
+    const size_t pedal = *input_index("DI_accelPedalPos");
+    dag::set_input(state, pedal, 40.0);
+    ASSERT_EQ(std::get<uint8_t>(evaluate(state, start)["Vehicle.OBD.RelativeAcceleratorPosition"]), 40);
+
+    // Neither 300 nor NaN fits the uint8 node: it goes invalid instead of publishing a wrapped value
+    for (double value : {300.0, -1.0, std::nan("")}) {
+        dag::set_input(state, pedal, 40.0);
+        evaluate(state, start);
+        dag::set_input(state, pedal, value);
+        EXPECT_TRUE(evaluate(state, start + std::chrono::milliseconds(2000)).empty()) << value;
+        EXPECT_FALSE(state.node_valid[1]) << value;
+    }
+}
+
+TEST(GeneratedDagTest, HeldIntegerValueIsPublishedUnchanged) {
+    dag::State state;
+    const auto start = std::chrono::steady_clock::now();
+    const size_t pedal = *input_index("DI_accelPedalPos");
+    dag::set_input(state, pedal, 0.0);
+    evaluate(state, start);
+
+    // The largest value uint8 holds is held in the widened slot and narrowed back exactly
+    dag::set_input(state, pedal, 254.6);
+    EXPECT_TRUE(evaluate(state, start + std::chrono::milliseconds(10)).empty());
+    EXPECT_EQ(state.uints[0], 255u);
+    auto outputs = evaluate(state, start + std::chrono::milliseconds(1000));
+    EXPECT_EQ(std::get<uint8_t>(outputs["Vehicle.OBD.RelativeAcceleratorPosition"]), 255);
+
+    // One more does not fit: the slot keeps the last value the type holds and nothing is held
+    dag::set_input(state, pedal, 255.6);
+    EXPECT_TRUE(evaluate(state, start + std::chrono::milliseconds(1010)).empty());
+    EXPECT_EQ(state.uints[0], 255u);
+    EXPECT_FALSE(state.held[1]);
+    EXPECT_TRUE(evaluate(state, start + std::chrono::milliseconds(3000)).empty());
+}
+
+TEST(GeneratedDagTest, InvalidInputDropsHeldValue) {
+    dag::State state;
+    const auto start = std::chrono::steady_clock::now();
+    uint8_t frame[8] = {0x00, 0x00, 0x08, 0x00, 100, 0x00, 0x00, 0x00};
+    run_frame(state, 0x118, frame, start);
+    frame[4] = 50;
+    run_frame(state, 0x118, frame, start + std::chrono::milliseconds(10));
+
+    dag::invalidate_input(state, *input_index("DI_accelPedalPos"));
+    EXPECT_EQ(evaluate(state, start + std::chrono::milliseconds(1000)).count("Vehicle.OBD.RelativeAcceleratorPosition"),
+              0u);
+}
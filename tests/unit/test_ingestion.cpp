@@ -0,0 +1,148 @@
+/**
+ * @file test_ingestion.cpp
+ * @brief Unit tests for the MPSC queue and multi-source ingestion
+ */
+
+#include <gtest/gtest.h>
+
+#include "ingestion.h"
+#include "mpsc_queue.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace can2vss;
+
+TEST(MpscQueueTest, PreservesOrderAndReportsFull) {
+    MpscQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.try_push(int{i}));
+    }
+    EXPECT_FALSE(queue.try_push(4));
+    EXPECT_EQ(queue.size_approx(), 4u);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+    EXPECT_TRUE(queue.try_push(5));  // wraps around
+    ASSERT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, 5);
+}
+
+TEST(IngestionQueueTest, ReportsCapacityForBudgeting) {
+    struct Update {
+        double value = 0.0;
+        char name[40] = {};
+    };
+    EXPECT_EQ(IngestionQueue<Update>().capacity(), IngestionQueue<Update>::kDefaultCapacity);
+    EXPECT_EQ(IngestionQueue<Update>(1000).capacity(), 1024u);
+    // Each slot holds the update, its source and the slot sequence
+    EXPECT_GE(IngestionQueue<Update>::entry_bytes(), sizeof(Update) + 2 * sizeof(size_t));
+}
+
+TEST(IngestionQueueTest, KeepsPerSourceOrderAcrossProducers) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+
+    struct Update {
+        int source = -1;
+        int sequence = -1;
+    };
+    IngestionQueue<Update> queue(256);
+    std::vector<size_t> ids;
+    for (int p = 0; p < kProducers; ++p) {
+        ids.push_back(queue.add_source("source" + std::to_string(p)));
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer;) {
+                if (queue.push(ids[p], Update{p, i})) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(kProducers, 0);
+    std::vector<Update> batch;
+    int received = 0;
+    while (received < kProducers * kPerProducer) {
+        batch.clear();
+        if (queue.drain(batch, 64) == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_LE(batch.size(), 64u);
+        for (const auto& update : batch) {
+            ASSERT_EQ(update.sequence, next[update.source]) << "source " << update.source;
+            ++next[update.source];
+        }
+        received += static_cast<int>(batch.size());
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    for (int p = 0; p < kProducers; ++p) {
+        EXPECT_EQ(queue.source(ids[p]).dequeued.load(), static_cast<uint64_t>(kPerProducer));
+        EXPECT_EQ(queue.source(ids[p]).depth(), 0u);
+    }
+}
+
+TEST(IngestionQueueTest, CountsDropsAndDepthPerSource) {
+    IngestionQueue<int> queue(4);
+    const size_t noisy = queue.add_source("noisy");
+    const size_t quiet = queue.add_source("quiet");
+
+    EXPECT_TRUE(queue.push(quiet, 1));
+    for (int i = 0; i < 5; ++i) {
+        queue.push(noisy, int{i});
+    }
+    EXPECT_EQ(queue.source(noisy).pushed.load(), 3u);
+    EXPECT_EQ(queue.source(noisy).dropped.load(), 2u);
+    EXPECT_EQ(queue.source(noisy).depth(), 3u);
+    EXPECT_EQ(queue.source(quiet).depth(), 1u);
+
+    Metrics metrics;
+    queue.register_metrics(metrics);
+    std::vector<int> out;
+    EXPECT_EQ(queue.drain(out, 2), 2u);
+    EXPECT_EQ(out, (std::vector<int>{1, 0}));
+    for (const auto& [name, value] : metrics.snapshot()) {
+        if (name == "ingest.noisy.depth") {
+            EXPECT_EQ(value, 2);
+        } else if (name == "ingest.noisy.dropped") {
+            EXPECT_EQ(value, 2);
+        } else if (name == "ingest.quiet.depth") {
+            EXPECT_EQ(value, 0);
+        }
+    }
+}
+
+TEST(SourceThreadTest, PollsIntoQueue) {
+    IngestionQueue<int> queue(64);
+    std::atomic<int> polls{0};
+    SourceThread<int> thread(
+        queue, "counter", [&] { return std::vector<int>{polls.fetch_add(1)}; }, std::chrono::milliseconds(1));
+    thread.start();
+
+    std::vector<int> out;
+    while (out.size() < 5) {
+        queue.drain(out, 16);
+        std::this_thread::yield();
+    }
+    thread.stop();
+    for (size_t i = 0; i < out.size(); ++i) {
+        EXPECT_EQ(out[i], static_cast<int>(i));
+    }
+    EXPECT_EQ(queue.source(0).name, "counter");
+}
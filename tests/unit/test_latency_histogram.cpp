@@ -0,0 +1,63 @@
+/**
+ * @file test_latency_histogram.cpp
+ * @brief Unit tests for LatencyHistogram
+ */
+
+#include <gtest/gtest.h>
+
+#include "latency_histogram.h"
+
+using namespace can2vss;
+using namespace std::chrono_literals;
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+    LatencyHistogram h("empty");
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_EQ(h.min_ns(), 0u);
+    EXPECT_EQ(h.percentile_ns(99), 0u);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketError) {
+    LatencyHistogram h("uniform");
+    for (int i = 1; i <= 10000; ++i) {
+        h.record(std::chrono::nanoseconds(i * 100));
+    }
+    EXPECT_EQ(h.count(), 10000u);
+    EXPECT_EQ(h.min_ns(), 100u);
+    EXPECT_EQ(h.max_ns(), 1000000u);
+
+    // 8 sub-buckets per power of two: at most 12.5% above the true value
+    EXPECT_GE(h.percentile_ns(50), 500000u);
+    EXPECT_LE(h.percentile_ns(50), 562500u);
+    EXPECT_GE(h.percentile_ns(99), 990000u);
+    EXPECT_LE(h.percentile_ns(99), 1000000u);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram h("small");
+    h.record(3ns);
+    h.record(5ns);
+    EXPECT_EQ(h.percentile_ns(50), 3u);
+    EXPECT_EQ(h.percentile_ns(100), 5u);
+}
+
+TEST(LatencyHistogramTest, Reset) {
+    LatencyHistogram h("reset");
+    h.record(10us);
+    h.reset();
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_EQ(h.max_ns(), 0u);
+}
+
+TEST(LatencyHistogramTest, Merge) {
+    LatencyHistogram a("a");
+    LatencyHistogram b("b");
+    a.record(2us);
+    b.record(1us);
+    b.record(8us);
+    a.merge(b);
+    EXPECT_EQ(a.count(), 3u);
+    EXPECT_EQ(a.min_ns(), 1000u);
+    EXPECT_EQ(a.max_ns(), 8000u);
+    EXPECT_NEAR(a.mean_ns(), 11000.0 / 3, 1.0);
+}
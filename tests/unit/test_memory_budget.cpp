@@ -0,0 +1,185 @@
+/**
+ * @file test_memory_budget.cpp
+ * @brief Unit tests for memory accounting and budget-driven buffer sizing
+ */
+
+#include <gtest/gtest.h>
+
+#include "alloc_tracker.h"
+#include "can2vss_generated_dag.h"
+#include "dbc_parser.h"
+#include "mapping_loader.h"
+#include "memory_budget.h"
+#include "synthetic_mappings.h"
+
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace can2vss;
+
+namespace {
+
+constexpr int64_t kMiB = 1024 * 1024;
+
+/// A DBC of `messages` messages of `signals` signals, named as bench::synthetic_source() in file order
+std::string synthetic_dbc(size_t messages, size_t signals) {
+    std::string dbc = "VERSION \"\"\n\nBU_: Receiver VehicleBus\n\n";
+    for (size_t m = 0; m < messages; ++m) {
+        dbc += "BO_ " + std::to_string(m + 1) + " Message" + std::to_string(m) + ": 8 VehicleBus\n";
+        for (size_t s = 0; s < signals; ++s) {
+            dbc += " SG_ " + bench::synthetic_source(m * signals + s) + " : " + std::to_string(s * 3) +
+                   "|3@1+ (0.5,-10) [-10|-6.5] \"unit\"  Receiver\n";
+        }
+        dbc += "\n";
+    }
+    return dbc;
+}
+
+}  // namespace
+
+TEST(MemoryBudgetTest, KeepsPreferredSizesWhenTheyFit) {
+    std::vector<BufferDemand> demands = {
+        {"queues", 64, 4096, 256, 3},
+        {"trace", 16, 1 << 16, 4096},
+    };
+    auto sizes = size_buffers(16 * kMiB, demands);
+    ASSERT_TRUE(sizes.ok()) << sizes.status();
+    EXPECT_EQ(*sizes, (std::vector<size_t>{4096, 1 << 16}));
+}
+
+TEST(MemoryBudgetTest, HalvesTheLargestBufferFirst) {
+    std::vector<BufferDemand> demands = {
+        {"queues", 64, 4096, 256, 3},  // 768 KiB
+        {"trace", 16, 1 << 16, 4096},  // 1 MiB
+    };
+    auto sizes = size_buffers(kMiB, demands);
+    ASSERT_TRUE(sizes.ok()) << sizes.status();
+    EXPECT_EQ(*sizes, (std::vector<size_t>{2048, 1 << 15}));
+
+    int64_t total = 0;
+    for (size_t i = 0; i < demands.size(); ++i) {
+        total += static_cast<int64_t>(demands[i].entry_bytes * (*sizes)[i] * demands[i].count);
+        EXPECT_GE((*sizes)[i], demands[i].minimum_entries);
+    }
+    EXPECT_LE(total, kMiB);
+}
+
+TEST(MemoryBudgetTest, RefusesWhenMinimumsDoNotFit) {
+    std::vector<BufferDemand> demands = {
+        {"queues", 64, 4096, 256, 3},
+        {"trace", 16, 1 << 16, 4096},
+    };
+    auto sizes = size_buffers(64 * 1024, demands);
+    ASSERT_FALSE(sizes.ok());
+    EXPECT_EQ(sizes.status().code(), absl::StatusCode::kResourceExhausted);
+
+    EXPECT_FALSE(size_buffers(-1, {}).ok());
+    EXPECT_TRUE(size_buffers(0, {}).ok());
+}
+
+TEST(MemoryBudgetTest, LedgerChargesHeapGrowthToSubsystem) {
+    MemoryLedger ledger;
+    auto block = std::make_unique<char[]>(kMiB);
+    ledger.mark("one MiB");
+    block.reset();
+    ledger.mark("release");
+
+    // The allocator rounds the block up, and the ledger's own bookkeeping
+    // may show in either entry
+    constexpr int64_t kTolerance = 64 * 1024;
+    ASSERT_EQ(ledger.entries().size(), 2u);
+    EXPECT_GE(ledger.entries()[0].heap_bytes, kMiB - kTolerance);
+    EXPECT_LT(ledger.entries()[0].heap_bytes, kMiB + kTolerance);
+    EXPECT_LE(ledger.entries()[1].heap_bytes, -kMiB + kTolerance);
+    EXPECT_GT(ledger.entries()[1].heap_bytes, -kMiB - kTolerance);
+
+    auto report = ledger.report();
+    EXPECT_NE(report.find("one MiB"), std::string::npos);
+    EXPECT_NE(report.find("peak"), std::string::npos);
+}
+
+TEST(MemoryBudgetTest, ReadsProcessMemory) {
+    EXPECT_GT(current_memory_usage().rss_bytes, 0);
+    EXPECT_GE(peak_rss_bytes(), current_memory_usage().rss_bytes);
+}
+
+// A synthetic mapping of 5000 VSS signals loaded as the feeder loads it,
+// with the DBC messages and generated DAG state it keeps, and evaluated for
+// a stream of updates: the peak heap of all of it stays within a budget
+TEST(MemoryBudgetTest, LargeMappingStaysWithinPeakBound) {
+    constexpr size_t kSignals = 5000;
+    constexpr int64_t kBudget = 96 * kMiB;  // YAML parsing alone peaks near 40 MiB
+    const std::string yaml = bench::synthetic_mapping_yaml(kSignals, bench::MappingKind::MIXED);
+    const std::string dbc = synthetic_dbc(250, 20);
+    HeapAccountingScope accounting;
+    const int64_t heap_before = thread_heap_bytes();
+    reset_thread_heap_peak();
+    {
+        auto config = load_mappings(YAML::Load(yaml));
+        ASSERT_TRUE(config.ok()) << config.status();
+        ASSERT_EQ(config->mappings.size(), kSignals);
+        std::set<std::string> mapped;
+        for (const auto& [signal_name, mapping] : config->mappings) {
+            mapped.insert(mapping.source.name);
+        }
+        auto index = DbcIndex::build(dbc);
+        ASSERT_TRUE(index.ok()) << index.status();
+        auto database = (*index)->load_messages(mapped);
+        ASSERT_TRUE(database.ok()) << database.status();
+        EXPECT_EQ(database->messages.size(), 250u);
+        auto state = std::make_unique<generated_dag::State>();
+
+        vssdag::SignalProcessorDAG processor;
+        ASSERT_TRUE(processor.initialize(config->mappings));
+        const int64_t held = thread_heap_bytes() - heap_before;
+        EXPECT_LT(held, kBudget / 2) << "held " << format_bytes(held);
+
+        // Every signal updated in every batch; value mappings see 0 and 1
+        std::vector<vssdag::SignalUpdate> batch(kSignals);
+        for (size_t round = 0; round < 20; ++round) {
+            const auto now = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < kSignals; ++i) {
+                batch[i].signal_name = bench::synthetic_source(i);
+                if (i % 3 == 2) {
+                    batch[i].value = static_cast<int64_t>(round % 2);
+                } else {
+                    batch[i].value = static_cast<double>(round + i);
+                }
+                batch[i].timestamp = now;
+            }
+            auto signals = processor.process_signal_updates(batch);
+            EXPECT_LE(signals.size(), kSignals);
+        }
+    }
+    const int64_t peak = thread_heap_peak_bytes() - heap_before;
+    EXPECT_LT(peak, kBudget) << "peak heap " << format_bytes(peak);
+
+    // Everything is released again once the mapping is gone
+    EXPECT_LT(thread_heap_bytes() - heap_before, 64 * 1024);
+}
+
+TEST(MemoryBudgetTest, HeapIsOnlyCountedInsideAnAccountingScope) {
+    const int64_t before = thread_heap_bytes();
+    auto block = std::make_unique<char[]>(kMiB);
+    EXPECT_EQ(thread_heap_bytes(), before);
+    block.reset();
+    EXPECT_EQ(thread_heap_bytes(), before);
+
+    {
+        HeapAccountingScope accounting;
+        block = std::make_unique<char[]>(kMiB);
+        EXPECT_GE(thread_heap_bytes() - before, kMiB);
+        block.reset();
+    }
+    EXPECT_EQ(thread_heap_bytes(), before);
+}
+
+TEST(MemoryBudgetTest, FormatsBytes) {
+    EXPECT_EQ(format_bytes(512), "512 B");
+    EXPECT_EQ(format_bytes(1536), "1.5 KiB");
+    EXPECT_EQ(format_bytes(3 * kMiB), "3.0 MiB");
+    EXPECT_EQ(format_bytes(-2048), "-2.0 KiB");
+}
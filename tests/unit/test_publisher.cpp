@@ -0,0 +1,302 @@
+/**
+ * @file test_publisher.cpp
+ * @brief Unit tests for publish priorities and the publish lanes
+ */
+
+#include <gtest/gtest.h>
+
+#include "publisher.h"
+#include "signal_priority.h"
+#include "struct_buffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace can2vss;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// Broker stand-in recording the paths it was asked to set, in order
+class RecordingBackend : public PublishBackend {
+public:
+    absl::Status set(const PublishRequest& request,
+                     const vss::types::QualifiedValue<vss::types::Value>& value) override {
+        (void)value;
+        while (paused_.load()) {
+            std::this_thread::sleep_for(100us);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        paths_.push_back(*request.path);
+        return absl::OkStatus();
+    }
+
+    void pause(bool paused) { paused_ = paused; }
+
+    std::vector<std::string> paths() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return paths_;
+    }
+
+private:
+    std::atomic<bool> paused_{false};
+    mutable std::mutex mutex_;
+    std::vector<std::string> paths_;
+};
+
+/// Broker stand-in offering a publish stream that records batch sizes
+class StreamBackend : public PublishBackend {
+public:
+    absl::Status set(const PublishRequest& request,
+                     const vss::types::QualifiedValue<vss::types::Value>& value) override {
+        (void)request;
+        (void)value;
+        ++sets_;
+        return absl::OkStatus();
+    }
+
+    absl::Status open_stream() override { return absl::OkStatus(); }
+
+    absl::Status write_batch(const std::vector<PublishEntry>& batch) override {
+        if (fail_writes_) {
+            return absl::UnavailableError("stream reset");
+        }
+        batches_.push_back(batch.size());
+        return absl::OkStatus();
+    }
+
+    bool wait_acknowledged(uint64_t batches, std::chrono::milliseconds timeout) override {
+        (void)timeout;
+        return acknowledge_ && batches <= batches_.size();
+    }
+
+    void fail_writes() { fail_writes_ = true; }
+    void stop_acknowledging() { acknowledge_ = false; }
+
+    // Read after the lane stopped
+    const std::vector<size_t>& batches() const { return batches_; }
+    size_t sets() const { return sets_; }
+
+private:
+    bool fail_writes_ = false;
+    bool acknowledge_ = true;
+    std::vector<size_t> batches_;
+    size_t sets_ = 0;
+};
+
+PublishRequest request_for(const std::string& path) {
+    PublishRequest request;
+    request.path = &path;
+    request.qualified_value.value = 1.0;
+    request.qualified_value.quality = vss::types::SignalQuality::VALID;
+    request.enqueued_at = std::chrono::steady_clock::now();
+    return request;
+}
+
+}  // namespace
+
+TEST(SignalPriorityTest, ParsesNamesAndAliases) {
+    EXPECT_EQ(signal_priority_from_string("high"), SignalPriority::HIGH);
+    EXPECT_EQ(signal_priority_from_string("normal"), SignalPriority::NORMAL);
+    EXPECT_EQ(signal_priority_from_string("bulk"), SignalPriority::BULK);
+    EXPECT_EQ(signal_priority_from_string("low"), SignalPriority::BULK);
+    EXPECT_FALSE(signal_priority_from_string("HIGH").has_value());
+    EXPECT_FALSE(signal_priority_from_string("").has_value());
+    for (auto priority : kAllSignalPriorities) {
+        EXPECT_EQ(signal_priority_from_string(to_string(priority)), priority);
+    }
+}
+
+TEST(PublisherTest, RoundsFollowPriorityWeights) {
+    RecordingBackend backend;
+    Publisher lane("main", &backend,
+                   {{SignalPriority::BULK, 1, 64}, {SignalPriority::HIGH, 16, 64}, {SignalPriority::NORMAL, 4, 64}});
+
+    // Queued before the lane starts, so the rounds see full queues
+    const std::string high = "high";
+    const std::string normal = "normal";
+    const std::string bulk = "bulk";
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(lane.enqueue(SignalPriority::HIGH, request_for(high)));
+    }
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(lane.enqueue(SignalPriority::NORMAL, request_for(normal)));
+    }
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(lane.enqueue(SignalPriority::BULK, request_for(bulk)));
+    }
+    lane.start();
+    lane.stop();
+
+    // Per round: up to 16 high, then 4 normal, then 1 bulk
+    std::vector<std::string> expected;
+    expected.insert(expected.end(), 16, high);
+    expected.insert(expected.end(), 4, normal);
+    expected.push_back(bulk);
+    expected.insert(expected.end(), 4, high);
+    expected.insert(expected.end(), 4, normal);
+    expected.push_back(bulk);
+    expected.insert(expected.end(), 2, normal);
+    expected.push_back(bulk);
+    EXPECT_EQ(backend.paths(), expected);
+    EXPECT_EQ(lane.published(), 33u);
+}
+
+TEST(PublisherTest, FullQueueDropsOnlyWithDropPolicy) {
+    const std::string path = "Vehicle.Speed";
+    RecordingBackend backend;
+    Publisher lane("main", &backend, {{SignalPriority::NORMAL, 1, 4, QueueFullPolicy::DROP}});
+    for (int i = 0; i < 6; ++i) {
+        lane.enqueue(SignalPriority::NORMAL, request_for(path));
+    }
+    EXPECT_EQ(lane.dropped(), 2u);
+    EXPECT_EQ(lane.blocked(), 0u);
+}
+
+TEST(PublisherTest, FullQueueBlocksUntilTheLaneHasRoom) {
+    const std::string path = "Vehicle.Speed";
+    RecordingBackend backend;
+    Publisher lane("main", &backend, {{SignalPriority::NORMAL, 1, 4, QueueFullPolicy::BLOCK}});
+    backend.pause(true);
+    lane.start();
+
+    // A stalled broker fills the queue; the producer then waits instead of dropping
+    std::atomic<int> enqueued{0};
+    std::thread producer([&] {
+        for (int i = 0; i < 100; ++i) {
+            lane.enqueue(SignalPriority::NORMAL, request_for(path));
+            ++enqueued;
+        }
+    });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_LT(enqueued.load(), 100);
+    EXPECT_GT(lane.blocked(), 0u);
+
+    backend.pause(false);
+    producer.join();
+    lane.stop();
+    EXPECT_EQ(lane.dropped(), 0u);
+    EXPECT_EQ(backend.paths().size(), 100u);
+}
+
+TEST(PublisherTest, StoppedLaneDropsInsteadOfBlocking) {
+    const std::string path = "Vehicle.Speed";
+    RecordingBackend backend;
+    Publisher lane("main", &backend, {{SignalPriority::NORMAL, 1, 2, QueueFullPolicy::BLOCK}});
+    for (int i = 0; i < 3; ++i) {
+        lane.enqueue(SignalPriority::NORMAL, request_for(path));
+    }
+    EXPECT_EQ(lane.dropped(), 1u);
+}
+
+TEST(PublishValueCacheTest, KeepsOneValuePerNodeAndReusesStructs) {
+    const std::string speed = "Vehicle.Speed";
+    const std::string location = "Vehicle.CurrentLocation";
+    StructBuffer buffer("Types.Location", {{"Latitude", SlotType::DOUBLE}, {"Longitude", SlotType::DOUBLE}});
+    const TypedValue fields[] = {TypedValue::of(48.1), TypedValue::of(11.6)};
+    buffer.store(fields);
+
+    PublishRequest scalar;
+    scalar.path = &speed;
+    scalar.typed = TypedValue::of(42.0);
+    scalar.node = 3;
+    PublishRequest structure;
+    structure.path = &location;
+    structure.typed = TypedValue::structure({0});
+    structure.structure = &buffer;
+    structure.node = 1;
+
+    PublishValueCache cache;
+    const auto& speed_value = cache.build(scalar);
+    EXPECT_EQ(cache.size(), 4u);
+    EXPECT_EQ(std::get<double>(*speed_value.value), 42.0);
+
+    using StructPtr = std::shared_ptr<vss::types::StructValue>;
+    const vss::types::StructValue* first = std::get<StructPtr>(*cache.build(structure).value).get();
+    const vss::types::StructValue* second = std::get<StructPtr>(*cache.build(structure).value).get();
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(cache.size(), 4u);
+
+    // Another node's value is untouched
+    EXPECT_EQ(std::get<double>(*cache.build(scalar).value), 42.0);
+}
+
+TEST(PublisherTest, StreamSendsQueuedValuesAsBatches) {
+    const std::string path = "Vehicle.Speed";
+    StreamBackend backend;
+    Publisher lane("main", &backend, {{SignalPriority::NORMAL, 1, 1024}});
+    for (int i = 0; i < 300; ++i) {
+        ASSERT_TRUE(lane.enqueue(SignalPriority::NORMAL, request_for(path)));
+    }
+    lane.start();
+    lane.stop();
+
+    EXPECT_TRUE(lane.streaming());
+    EXPECT_EQ(backend.batches(), (std::vector<size_t>{256, 44}));
+    EXPECT_EQ(backend.sets(), 0u);
+    EXPECT_EQ(lane.published(), 300u);
+}
+
+TEST(PublisherTest, FailedStreamWriteFallsBackToSet) {
+    const std::string path = "Vehicle.Speed";
+    StreamBackend backend;
+    backend.fail_writes();
+    Publisher lane("main", &backend, {{SignalPriority::NORMAL, 1, 1024}});
+    for (int i = 0; i < 300; ++i) {
+        ASSERT_TRUE(lane.enqueue(SignalPriority::NORMAL, request_for(path)));
+    }
+    lane.start();
+    lane.stop();
+
+    // The failed batch is re-sent value by value, the rest never batched
+    EXPECT_FALSE(lane.streaming());
+    EXPECT_TRUE(backend.batches().empty());
+    EXPECT_EQ(backend.sets(), 300u);
+    EXPECT_EQ(lane.published(), 300u);
+    EXPECT_EQ(lane.failed(), 0u);
+}
+
+TEST(PublisherTest, StalledAcknowledgementsLimitBatchesInFlight) {
+    const std::string path = "Vehicle.Speed";
+    StreamBackend backend;
+    backend.stop_acknowledging();
+    Publisher lane("main", &backend, {{SignalPriority::NORMAL, 1, 4096}});
+    for (int i = 0; i < 10 * 256; ++i) {
+        ASSERT_TRUE(lane.enqueue(SignalPriority::NORMAL, request_for(path)));
+    }
+    lane.start();
+    lane.stop();
+
+    // Eight batches may be unacknowledged; the ninth waits, times out and
+    // goes out with set(), as does everything after it
+    EXPECT_FALSE(lane.streaming());
+    EXPECT_EQ(backend.batches(), std::vector<size_t>(8, 256));
+    EXPECT_EQ(backend.sets(), 2u * 256);
+    EXPECT_EQ(lane.published(), 10u * 256);
+}
+
+TEST(PublishValueCacheTest, ReplacesStructsStillHeldElsewhere) {
+    const std::string location = "Vehicle.CurrentLocation";
+    StructBuffer buffer("Types.Location", {{"Latitude", SlotType::DOUBLE}, {"Longitude", SlotType::DOUBLE}});
+    TypedValue fields[] = {TypedValue::of(48.1), TypedValue::of(11.6)};
+    buffer.store(fields);
+    PublishRequest structure;
+    structure.path = &location;
+    structure.typed = TypedValue::structure({0});
+    structure.structure = &buffer;
+
+    // A stream batch keeps a copy of the value until the broker has it
+    PublishValueCache cache;
+    const auto batched = cache.build(structure);
+    fields[0] = TypedValue::of(48.2);
+    buffer.store(fields);
+
+    using StructPtr = std::shared_ptr<vss::types::StructValue>;
+    const auto& next = cache.build(structure);
+    EXPECT_NE(std::get<StructPtr>(*next.value), std::get<StructPtr>(*batched.value));
+    EXPECT_EQ(std::get<StructPtr>(*batched.value).use_count(), 1);
+}
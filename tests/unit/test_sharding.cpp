@@ -0,0 +1,111 @@
+/**
+ * @file test_sharding.cpp
+ * @brief Unit tests for partitioning a mapping across shards
+ */
+
+#include <gtest/gtest.h>
+
+#include "sharding.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace can2vss;
+
+namespace {
+
+ShardSignal can_signal(const std::string& name, uint64_t can_id) {
+    return {name, can_id, {}};
+}
+
+ShardSignal derived(const std::string& name, std::vector<std::string> deps) {
+    return {name, std::nullopt, std::move(deps)};
+}
+
+int shard_of(const std::vector<ShardSignal>& signals, const ShardPlan& plan, const std::string& name) {
+    for (size_t i = 0; i < signals.size(); ++i) {
+        if (signals[i].name == name) {
+            return plan.shard_of[i];
+        }
+    }
+    return -1;
+}
+
+}  // namespace
+
+TEST(ShardingTest, SingleShardTakesEverything) {
+    std::vector<ShardSignal> signals = {can_signal("A", 1), can_signal("B", 2), derived("C", {"A"})};
+    auto plan = plan_shards(signals, 1);
+    EXPECT_EQ(plan.shard_of, (std::vector<int>{0, 0, 0}));
+    EXPECT_EQ(plan.signals_per_shard, (std::vector<size_t>{3}));
+    EXPECT_EQ(plan.messages_per_shard, (std::vector<size_t>{2}));
+}
+
+TEST(ShardingTest, KeepsDependenciesAndMessagesTogether) {
+    std::vector<ShardSignal> signals = {
+        can_signal("Speed", 0x257),
+        can_signal("SpeedUnits", 0x257),        // same message as Speed
+        derived("Acceleration", {"Speed"}),
+        derived("HarshBraking", {"Acceleration"}),
+        can_signal("Gear", 0x118),
+        derived("IsParked", {"Gear"}),
+        can_signal("Soc", 0x292),
+        can_signal("BattVoltage", 0x132),
+        derived("BattPower", {"BattVoltage", "BattCurrent"}),
+        can_signal("BattCurrent", 0x132),
+    };
+    auto plan = plan_shards(signals, 3);
+
+    const int speed = shard_of(signals, plan, "Speed");
+    EXPECT_EQ(shard_of(signals, plan, "SpeedUnits"), speed);
+    EXPECT_EQ(shard_of(signals, plan, "Acceleration"), speed);
+    EXPECT_EQ(shard_of(signals, plan, "HarshBraking"), speed);
+    EXPECT_EQ(shard_of(signals, plan, "IsParked"), shard_of(signals, plan, "Gear"));
+    EXPECT_EQ(shard_of(signals, plan, "BattPower"), shard_of(signals, plan, "BattVoltage"));
+    EXPECT_EQ(shard_of(signals, plan, "BattCurrent"), shard_of(signals, plan, "BattVoltage"));
+
+    // Groups of 4, 3, 2 and 1 signals over three shards: 4 | 3 | 2 + 1
+    auto sizes = plan.signals_per_shard;
+    std::sort(sizes.begin(), sizes.end());
+    EXPECT_EQ(sizes, (std::vector<size_t>{3, 3, 4}));
+    EXPECT_EQ(plan.largest_group, 4u);
+
+    size_t messages = 0;
+    for (size_t count : plan.messages_per_shard) {
+        messages += count;
+    }
+    EXPECT_EQ(messages, 4u);  // every message is decoded by exactly one shard
+}
+
+TEST(ShardingTest, BalancesIndependentSignals) {
+    std::vector<ShardSignal> signals;
+    for (uint64_t id = 0; id < 1000; ++id) {
+        signals.push_back(can_signal("Signal" + std::to_string(id), id));
+    }
+    auto plan = plan_shards(signals, 4);
+    EXPECT_EQ(plan.signals_per_shard, (std::vector<size_t>{250, 250, 250, 250}));
+    EXPECT_EQ(plan.largest_group, 1u);
+}
+
+TEST(ShardingTest, PlanDoesNotDependOnInputOrder) {
+    std::vector<ShardSignal> signals;
+    for (int i = 0; i < 200; ++i) {
+        signals.push_back(can_signal("Raw" + std::to_string(i), static_cast<uint64_t>(i / 3)));
+        if (i % 5 == 0) {
+            signals.push_back(derived("Derived" + std::to_string(i), {"Raw" + std::to_string(i)}));
+        }
+    }
+    auto plan = plan_shards(signals, 3);
+    std::map<std::string, int> expected;
+    for (size_t i = 0; i < signals.size(); ++i) {
+        expected[signals[i].name] = plan.shard_of[i];
+    }
+
+    std::mt19937 rng(42);
+    std::shuffle(signals.begin(), signals.end(), rng);
+    auto shuffled = plan_shards(signals, 3);
+    for (size_t i = 0; i < signals.size(); ++i) {
+        EXPECT_EQ(shuffled.shard_of[i], expected[signals[i].name]) << signals[i].name;
+    }
+}
@@ -0,0 +1,449 @@
+/**
+ * @file test_signal_operators.cpp
+ * @brief Unit tests for the native signal operators
+ */
+
+#include <gtest/gtest.h>
+
+#include "signal_operators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <optional>
+#include <random>
+
+using namespace can2vss;
+
+namespace {
+
+using std::chrono::milliseconds;
+
+const OperatorClock::time_point kStart{std::chrono::seconds(1000)};
+
+OperatorSpec window_operator(std::string name, std::string input, bool input_is_operator = false,
+                             WindowSpec window = {}) {
+    OperatorSpec spec;
+    spec.name = std::move(name);
+    spec.input = std::move(input);
+    spec.input_is_operator = input_is_operator;
+    spec.window = window;
+    return spec;
+}
+
+/// Recomputes the aggregate of the window ending at `end` from scratch: the
+/// window is [end - duration, end), so a sample at `end` only counts for the next
+double brute_force(const std::deque<std::pair<OperatorClock::time_point, double>>& history,
+                   OperatorClock::time_point end, milliseconds duration, WindowFunction function) {
+    std::vector<double> values;
+    for (const auto& [time, value] : history) {
+        if (time >= end - duration && time < end) {
+            values.push_back(value);
+        }
+    }
+    double mean = 0.0;
+    for (double v : values) {
+        mean += v / static_cast<double>(values.size());
+    }
+    switch (function) {
+        case WindowFunction::MIN:
+            return *std::min_element(values.begin(), values.end());
+        case WindowFunction::MAX:
+            return *std::max_element(values.begin(), values.end());
+        case WindowFunction::MEAN:
+            return mean;
+        case WindowFunction::STDDEV: {
+            double variance = 0.0;
+            for (double v : values) {
+                variance += (v - mean) * (v - mean) / static_cast<double>(values.size());
+            }
+            return std::sqrt(variance);
+        }
+    }
+    return 0.0;
+}
+
+}  // namespace
+
+TEST(SignalOperatorsTest, ParsesWindowFunctions) {
+    EXPECT_EQ(window_function_from_string("min"), WindowFunction::MIN);
+    EXPECT_EQ(window_function_from_string("avg"), WindowFunction::MEAN);
+    EXPECT_EQ(window_function_from_string("stddev"), WindowFunction::STDDEV);
+    EXPECT_FALSE(window_function_from_string("median").has_value());
+    EXPECT_EQ(operator_kind_from_key("window"), OperatorSpec::Kind::WINDOW);
+    EXPECT_EQ(operator_kind_from_key("derivative"), OperatorSpec::Kind::DERIVATIVE);
+    EXPECT_EQ(operator_kind_from_key("low_pass"), OperatorSpec::Kind::LOW_PASS);
+    EXPECT_EQ(operator_kind_from_key("event"), OperatorSpec::Kind::EVENT);
+    EXPECT_FALSE(operator_kind_from_key("code").has_value());
+}
+
+TEST(SignalOperatorsTest, SlidingWindowsMatchBruteForce) {
+    for (auto function : {WindowFunction::MIN, WindowFunction::MAX, WindowFunction::MEAN, WindowFunction::STDDEV}) {
+        WindowSpec spec{function, 1000, 250, 4096};
+        WindowAggregator window(spec);
+        std::deque<std::pair<OperatorClock::time_point, double>> history;
+
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> gap(1, 40);
+        std::normal_distribution<double> speed(80.0, 15.0);
+        auto time = kStart;
+        std::optional<OperatorClock::time_point> first;
+        int emissions = 0;
+        for (int i = 0; i < 5000; ++i) {
+            time += milliseconds(gap(random));
+            const double value = speed(random);
+            first = first.value_or(time);
+            history.emplace_back(time, value);
+            OperatorSample out;
+            if (window.update(value, time, &out)) {
+                ++emissions;
+                ASSERT_NEAR(out.value, brute_force(history, out.time, milliseconds(1000), function), 1e-9)
+                    << "function " << static_cast<int>(function) << " at sample " << i;
+                // Boundaries are multiples of every_ms after the first sample
+                EXPECT_EQ((out.time - *first) % milliseconds(250), milliseconds(0));
+            }
+        }
+        EXPECT_GT(emissions, 300);
+        EXPECT_EQ(window.overflowed(), 0u);
+    }
+}
+
+TEST(SignalOperatorsTest, TumblingWindowEmitsOncePerWindow) {
+    WindowAggregator window({WindowFunction::MEAN, 1000, 0, 64});
+    OperatorSample out;
+    int emissions = 0;
+    for (int ms = 0; ms < 3000; ms += 100) {
+        emissions += window.update(ms < 1000 ? 10.0 : 20.0, kStart + milliseconds(ms), &out);
+    }
+    EXPECT_EQ(emissions, 2);
+    EXPECT_EQ(out.time, kStart + milliseconds(2000));
+    EXPECT_DOUBLE_EQ(out.value, 20.0);
+
+    // A gap over several boundaries emits only the latest, empty windows nothing
+    EXPECT_TRUE(window.update(30.0, kStart + milliseconds(3000), &out));
+    EXPECT_FALSE(window.update(30.0, kStart + milliseconds(9500), &out));
+    EXPECT_TRUE(window.update(30.0, kStart + milliseconds(10000), &out));
+    EXPECT_EQ(out.time, kStart + milliseconds(10000));
+}
+
+TEST(SignalOperatorsTest, FlushClosesWindowWithoutFurtherSample) {
+    WindowAggregator window({WindowFunction::MEAN, 1000, 0, 64});
+    OperatorSample out;
+    EXPECT_FALSE(window.flush(kStart, &out));
+    for (int ms = 0; ms < 1000; ms += 100) {
+        window.update(ms / 100, kStart + milliseconds(ms), &out);
+    }
+
+    // The signal stops; the periodic tick closes [0, 1000) once it has ended
+    EXPECT_FALSE(window.flush(kStart + milliseconds(950), &out));
+    ASSERT_TRUE(window.flush(kStart + milliseconds(1050), &out));
+    EXPECT_EQ(out.time, kStart + milliseconds(1000));
+    EXPECT_DOUBLE_EQ(out.value, 4.5);
+    EXPECT_FALSE(window.flush(kStart + milliseconds(1100), &out));
+
+    // Later windows hold no samples and are not emitted
+    EXPECT_FALSE(window.flush(kStart + milliseconds(5000), &out));
+    EXPECT_FALSE(window.update(7.0, kStart + milliseconds(5500), &out));
+    ASSERT_TRUE(window.flush(kStart + milliseconds(6000), &out));
+    EXPECT_EQ(out.time, kStart + milliseconds(6000));
+    EXPECT_DOUBLE_EQ(out.value, 7.0);
+}
+
+TEST(SignalOperatorsTest, SampleOnABoundaryBelongsToTheNextWindowOnly) {
+    // Periodic samples every 100 ms, aligned with the 1 s window boundaries,
+    // and a spike exactly on the boundary at 1000 ms
+    WindowAggregator max({WindowFunction::MAX, 1000, 0, 64});
+    WindowAggregator mean({WindowFunction::MEAN, 1000, 0, 64});
+    std::vector<OperatorSample> maxima;
+    std::vector<OperatorSample> means;
+    for (int ms = 0; ms <= 3000; ms += 100) {
+        const auto time = kStart + milliseconds(ms);
+        OperatorSample out;
+        if (max.update(ms == 1000 ? 100.0 : 1.0, time, &out)) {
+            maxima.push_back(out);
+        }
+        if (mean.update(ms / 100, time, &out)) {
+            means.push_back(out);
+        }
+    }
+
+    // [0, 1000) ends before the spike, [1000, 2000) holds it
+    ASSERT_EQ(maxima.size(), 3u);
+    EXPECT_EQ(maxima[0].time, kStart + milliseconds(1000));
+    EXPECT_DOUBLE_EQ(maxima[0].value, 1.0);
+    EXPECT_DOUBLE_EQ(maxima[1].value, 100.0);
+    EXPECT_DOUBLE_EQ(maxima[2].value, 1.0);
+
+    // Every window holds exactly its ten samples: indices 10k to 10k + 9
+    ASSERT_EQ(means.size(), 3u);
+    for (size_t k = 0; k < means.size(); ++k) {
+        EXPECT_DOUBLE_EQ(means[k].value, 10.0 * static_cast<double>(k) + 4.5) << "window " << k;
+    }
+}
+
+TEST(SignalOperatorsTest, FullWindowDropsOldestSamples) {
+    WindowAggregator window({WindowFunction::MAX, 1000, 0, 4});
+    OperatorSample out;
+    const double values[] = {9.0, 1.0, 2.0, 3.0, 4.0};
+    for (int i = 0; i < 5; ++i) {
+        window.update(values[i], kStart + milliseconds(i), &out);
+    }
+    EXPECT_EQ(window.size(), 4u);
+    EXPECT_EQ(window.overflowed(), 1u);
+    EXPECT_EQ(window.current(), 4.0);
+}
+
+TEST(SignalOperatorsTest, GraphChainsOperators) {
+    auto mean = window_operator("Vehicle.Speed.Mean", "DI_vehicleSpeed", false, {WindowFunction::MEAN, 100, 0, 64});
+    auto peak = window_operator("Vehicle.Speed.PeakMean", "Vehicle.Speed.Mean", true,
+                                {WindowFunction::MAX, 1000, 0, 64});
+
+    OperatorGraph graph;
+    ASSERT_TRUE(graph.initialize({peak, mean}).ok());
+    ASSERT_EQ(graph.inputs(), (std::vector<std::string>{"DI_vehicleSpeed"}));
+    EXPECT_EQ(graph.input_index("DI_vehicleSpeed"), 0);
+    EXPECT_EQ(graph.input_index("Vehicle.Speed.Mean"), -1);
+
+    size_t peak_outputs = 0;
+    for (int ms = 0; ms <= 2500; ms += 10) {
+        graph.push(0, ms < 1500 ? ms / 10.0 : 0.0, kStart + milliseconds(ms));
+    }
+    for (const auto& output : graph.outputs()) {
+        if (graph.spec(output.op).name == "Vehicle.Speed.PeakMean") {
+            ++peak_outputs;
+        }
+    }
+    EXPECT_EQ(graph.outputs().size() - peak_outputs, 25u);
+    EXPECT_EQ(peak_outputs, 2u);
+    graph.clear_outputs();
+    EXPECT_TRUE(graph.outputs().empty());
+}
+
+TEST(SignalOperatorsTest, GraphTickFeedsClosedWindowsDownstream) {
+    auto mean = window_operator("Vehicle.Speed.Mean", "DI_vehicleSpeed", false, {WindowFunction::MEAN, 100, 0, 64});
+    auto peak = window_operator("Vehicle.Speed.PeakMean", "Vehicle.Speed.Mean", true,
+                                {WindowFunction::MAX, 1000, 0, 64});
+    OperatorGraph graph;
+    ASSERT_TRUE(graph.initialize({peak, mean}).ok());
+
+    // One burst, then the signal stops: only ticks close the windows
+    for (int ms = 0; ms < 100; ms += 10) {
+        graph.push(0, 50.0, kStart + milliseconds(ms));
+    }
+    EXPECT_TRUE(graph.outputs().empty());
+    for (int ms = 0; ms <= 2000; ms += 50) {
+        graph.tick(kStart + milliseconds(ms));
+    }
+    ASSERT_EQ(graph.outputs().size(), 2u);
+    EXPECT_EQ(graph.spec(graph.outputs()[0].op).name, "Vehicle.Speed.Mean");
+    EXPECT_EQ(graph.outputs()[0].sample.time, kStart + milliseconds(100));
+    EXPECT_EQ(graph.spec(graph.outputs()[1].op).name, "Vehicle.Speed.PeakMean");
+    EXPECT_EQ(graph.outputs()[1].sample.time, kStart + milliseconds(1100));
+    EXPECT_DOUBLE_EQ(graph.outputs()[1].sample.value, 50.0);
+}
+
+TEST(SignalOperatorsTest, DerivativeUsesSampleTimestamps) {
+    Derivative derivative({1.0 / 3.6, 50});
+    OperatorSample out;
+    EXPECT_FALSE(derivative.update(0.0, kStart, &out));
+    // Too close to the last used sample
+    EXPECT_FALSE(derivative.update(1.0, kStart + milliseconds(20), &out));
+    // 36 km/h in 1 s, with uneven spacing: 10 m/s²
+    ASSERT_TRUE(derivative.update(3.6, kStart + milliseconds(100), &out));
+    EXPECT_NEAR(out.value, 10.0, 1e-9);
+    ASSERT_TRUE(derivative.update(36.0, kStart + milliseconds(1000), &out));
+    EXPECT_NEAR(out.value, 10.0, 1e-9);
+    EXPECT_EQ(out.time, kStart + milliseconds(1000));
+}
+
+TEST(SignalOperatorsTest, IntegratorSkipsLongGaps) {
+    // km/h over seconds to km
+    Integrator integral({1.0 / 3600.0, 2000});
+    OperatorSample out;
+    for (int s = 0; s <= 3600; ++s) {
+        const double speed = s < 1800 ? 60.0 : 60.0 + (s - 1800) / 30.0;
+        ASSERT_TRUE(integral.update(speed, kStart + std::chrono::seconds(s), &out));
+    }
+    // 30 km at 60 km/h, then 30 min ramping from 60 to 120 km/h: 45 km
+    EXPECT_NEAR(out.value, 75.0, 1e-9);
+
+    // The signal was lost for 10 s: not integrated
+    integral.update(120.0, kStart + std::chrono::seconds(3610), &out);
+    EXPECT_NEAR(out.value, 75.0, 1e-9);
+}
+
+TEST(SignalOperatorsTest, LowPassDoesNotDependOnSampleRate) {
+    for (int period_ms : {1, 10, 100}) {
+        LowPassFilter filter({1000});
+        OperatorSample out;
+        filter.update(0.0, kStart, &out);
+        for (int ms = period_ms; ms <= 1000; ms += period_ms) {
+            filter.update(1.0, kStart + milliseconds(ms), &out);
+        }
+        // A step reaches 1 - 1/e after one time constant
+        EXPECT_NEAR(out.value, 1.0 - std::exp(-1.0), 1e-9) << period_ms << " ms period";
+    }
+}
+
+TEST(SignalOperatorsTest, MedianRejectsSpikes) {
+    MovingMedian median({5});
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+    std::deque<double> history;
+    OperatorSample out;
+    for (int i = 0; i < 1000; ++i) {
+        const double value = i % 50 == 0 ? 1e6 : 80.0 + noise(random);
+        ASSERT_TRUE(median.update(value, kStart + milliseconds(i), &out));
+        history.push_back(value);
+        if (history.size() > 5) {
+            history.pop_front();
+        }
+        std::vector<double> sorted(history.begin(), history.end());
+        std::sort(sorted.begin(), sorted.end());
+        const size_t n = sorted.size();
+        const double expected = n % 2 == 1 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+        ASSERT_DOUBLE_EQ(out.value, expected) << "at sample " << i;
+        if (i >= 4) {
+            EXPECT_LT(out.value, 100.0);
+        }
+    }
+}
+
+TEST(SignalOperatorsTest, GraphChainsFilters) {
+    OperatorSpec speed;
+    speed.name = "Vehicle.Speed.Filtered";
+    speed.input = "DI_vehicleSpeed";
+    speed.kind = OperatorSpec::Kind::LOW_PASS;
+    speed.low_pass.time_constant_ms = 200;
+    OperatorSpec acceleration;
+    acceleration.name = "Vehicle.Acceleration.Longitudinal";
+    acceleration.input = speed.name;
+    acceleration.input_is_operator = true;
+    acceleration.kind = OperatorSpec::Kind::DERIVATIVE;
+    acceleration.derivative.scale = 1.0 / 3.6;
+
+    OperatorGraph graph;
+    ASSERT_TRUE(graph.initialize({acceleration, speed}).ok());
+    // Constant 3.6 km/h per second once the filter has settled: 1 m/s²
+    for (int ms = 0; ms <= 5000; ms += 10) {
+        graph.push(0, ms * 0.0036, kStart + milliseconds(ms));
+    }
+    graph.push(0, std::nan(""), kStart + milliseconds(5010));
+    const auto& last = graph.outputs().back();
+    EXPECT_EQ(graph.spec(last.op).name, "Vehicle.Acceleration.Longitudinal");
+    EXPECT_EQ(last.sample.time, kStart + milliseconds(5000));
+    EXPECT_NEAR(last.sample.value, 1.0, 1e-6);
+}
+
+TEST(SignalOperatorsTest, EventNeedsDurationAndHonoursHysteresis) {
+    EventDetector event({EventSpec::Trigger::BELOW, -4.0, 1.0, 100, 0});
+    OperatorSample out;
+    // The initial state is emitted once
+    ASSERT_TRUE(event.update(0.0, kStart, &out));
+    EXPECT_EQ(out.value, 0.0);
+    EXPECT_FALSE(event.update(0.0, kStart + milliseconds(10), &out));
+
+    // Too short: released before min_duration_ms
+    EXPECT_FALSE(event.update(-5.0, kStart + milliseconds(20), &out));
+    EXPECT_FALSE(event.update(-2.0, kStart + milliseconds(60), &out));
+    EXPECT_FALSE(event.update(-5.0, kStart + milliseconds(100), &out));
+    EXPECT_FALSE(event.update(-3.5, kStart + milliseconds(150), &out));  // in the band: resets the pending start
+    EXPECT_FALSE(event.update(-5.0, kStart + milliseconds(200), &out));
+    EXPECT_FALSE(event.update(-5.0, kStart + milliseconds(250), &out));
+    ASSERT_TRUE(event.update(-5.0, kStart + milliseconds(300), &out));
+    EXPECT_EQ(out.value, 1.0);
+    EXPECT_EQ(out.time, kStart + milliseconds(300));
+
+    // Chatter inside the hysteresis band does not end it
+    for (int ms = 310; ms < 600; ms += 10) {
+        EXPECT_FALSE(event.update(ms % 20 == 0 ? -3.5 : -4.5, kStart + milliseconds(ms), &out));
+    }
+    ASSERT_TRUE(event.update(-3.0, kStart + milliseconds(600), &out));
+    EXPECT_EQ(out.value, 0.0);
+    EXPECT_FALSE(event.active());
+}
+
+TEST(SignalOperatorsTest, EventDipIntoTheBandRestartsThePendingWindow) {
+    EventDetector event({EventSpec::Trigger::ABOVE, 10.0, 2.0, 100, 0});
+    OperatorSample out;
+    ASSERT_TRUE(event.update(0.0, kStart, &out));
+    EXPECT_FALSE(event.update(11.0, kStart + milliseconds(10), &out));
+    EXPECT_FALSE(event.update(9.0, kStart + milliseconds(60), &out));  // in the band, not past it
+    EXPECT_FALSE(event.update(11.0, kStart + milliseconds(80), &out));
+
+    // 100 ms after the first crossing, but only 30 ms after the last one
+    EXPECT_FALSE(event.update(11.0, kStart + milliseconds(110), &out));
+    EXPECT_FALSE(event.update(11.0, kStart + milliseconds(179), &out));
+    ASSERT_TRUE(event.update(11.0, kStart + milliseconds(180), &out));
+    EXPECT_EQ(out.value, 1.0);
+    EXPECT_EQ(out.time, kStart + milliseconds(180));
+
+    // Once active, the same dip does not end it
+    EXPECT_FALSE(event.update(9.0, kStart + milliseconds(200), &out));
+    EXPECT_TRUE(event.active());
+}
+
+TEST(SignalOperatorsTest, EventCooldownSuppressesRetrigger) {
+    EventDetector event({EventSpec::Trigger::ABOVE, 10.0, 0.0, 0, 1000});
+    OperatorSample out;
+    ASSERT_TRUE(event.update(11.0, kStart, &out));
+    EXPECT_EQ(out.value, 1.0);
+    EXPECT_TRUE(event.update(9.0, kStart + milliseconds(100), &out));
+    EXPECT_FALSE(event.update(11.0, kStart + milliseconds(500), &out));
+    EXPECT_FALSE(event.update(11.0, kStart + milliseconds(1000), &out));
+    ASSERT_TRUE(event.update(11.0, kStart + milliseconds(1100), &out));
+    EXPECT_TRUE(event.active());
+}
+
+TEST(SignalOperatorsTest, GraphDetectsHarshBraking) {
+    OperatorSpec acceleration;
+    acceleration.name = "Vehicle.Acceleration.Longitudinal";
+    acceleration.input = "DI_vehicleSpeed";
+    acceleration.kind = OperatorSpec::Kind::DERIVATIVE;
+    acceleration.derivative.scale = 1.0 / 3.6;
+    OperatorSpec braking;
+    braking.name = "Telemetry.HarshBraking";
+    braking.input = acceleration.name;
+    braking.input_is_operator = true;
+    braking.kind = OperatorSpec::Kind::EVENT;
+    braking.event = {EventSpec::Trigger::BELOW, -4.0, 1.0, 200, 2000};
+
+    OperatorGraph graph;
+    ASSERT_TRUE(graph.initialize({acceleration, braking}).ok());
+    // 100 km/h, braking at 5 m/s² from 1 s to 3 s, then constant speed
+    double speed = 100.0;
+    for (int ms = 0; ms <= 5000; ms += 10) {
+        if (ms > 1000 && ms <= 3000) {
+            speed -= 5.0 * 3.6 * 0.01;
+        }
+        graph.push(0, speed, kStart + milliseconds(ms));
+    }
+    std::vector<OperatorSample> events;
+    for (const auto& output : graph.outputs()) {
+        if (graph.spec(output.op).name == braking.name) {
+            events.push_back(output.sample);
+        }
+    }
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].value, 0.0);
+    EXPECT_EQ(events[1].value, 1.0);
+    EXPECT_EQ(events[1].time, kStart + milliseconds(1210));
+    EXPECT_EQ(events[2].value, 0.0);
+    EXPECT_EQ(events[2].time, kStart + milliseconds(3010));
+}
+
+TEST(SignalOperatorsTest, GraphRejectsBadSpecs) {
+    OperatorGraph graph;
+    EXPECT_FALSE(graph.initialize({window_operator("A", "B", true), window_operator("B", "A", true)}).ok());
+    EXPECT_FALSE(graph.initialize({window_operator("C", "Vehicle.Speed", true)}).ok());
+    EXPECT_FALSE(graph.initialize({window_operator("D", "DI_vehicleSpeed", false, {WindowFunction::MEAN, 0})}).ok());
+
+    auto median = window_operator("F", "DI_vehicleSpeed");
+    median.kind = OperatorSpec::Kind::MEDIAN;
+    median.median.samples = kMaxMedianSamples + 1;
+    EXPECT_FALSE(graph.initialize({median}).ok());
+
+    auto ok = window_operator("E", "DI_vehicleSpeed");
+    EXPECT_FALSE(graph.initialize({ok, ok}).ok());
+    EXPECT_TRUE(graph.initialize({ok}).ok());
+}
@@ -0,0 +1,69 @@
+/**
+ * @file test_stage_profiler.cpp
+ * @brief Unit tests for the --profile stage profiler
+ */
+
+#include <gtest/gtest.h>
+
+#include "stage_profiler.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+using namespace can2vss;
+
+TEST(StageProfilerTest, DisabledScopeRecordsNothing) {
+    ProfileScope scope(nullptr, ProfileStage::POLL);
+}
+
+TEST(StageProfilerTest, CountsCallsTimeAndAllocations) {
+    StageProfiler profiler(16);
+    {
+        ProfileScope scope(&profiler, ProfileStage::DAG);
+        auto value = std::make_unique<int>(42);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    {
+        ProfileScope scope(&profiler, ProfileStage::DAG);
+    }
+
+    const auto& dag = profiler.stats(ProfileStage::DAG);
+    EXPECT_EQ(dag.calls, 2u);
+    EXPECT_EQ(dag.allocations, 1u);
+    EXPECT_EQ(dag.deallocations, 1u);
+    EXPECT_GE(profiler.ticks_to_ns(dag.ticks), 1e6);
+    EXPECT_LE(profiler.ticks_to_ns(dag.max_ticks), profiler.ticks_to_ns(dag.ticks));
+    EXPECT_EQ(profiler.stats(ProfileStage::POLL).calls, 0u);
+
+    const std::string report = profiler.report();
+    EXPECT_NE(report.find("dag"), std::string::npos);
+    EXPECT_NE(report.find("publish"), std::string::npos);
+}
+
+TEST(StageProfilerTest, ChromeTraceKeepsMostRecentEvents) {
+    StageProfiler profiler(2);
+    for (auto stage : {ProfileStage::POLL, ProfileStage::DAG, ProfileStage::PUBLISH}) {
+        ProfileScope scope(&profiler, stage);
+    }
+    EXPECT_EQ(profiler.events(), 3u);
+
+    const std::string path = ::testing::TempDir() + "can2vss_trace_test.json";
+    ASSERT_TRUE(profiler.write_chrome_trace(path));
+    std::ifstream in(path);
+    std::stringstream json;
+    json << in.rdbuf();
+    std::remove(path.c_str());
+
+    const std::string trace = json.str();
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\"", 0), 0u);
+    EXPECT_EQ(trace.find("\"name\":\"poll\""), std::string::npos);
+    const auto dag = trace.find("\"name\":\"dag\"");
+    const auto publish = trace.find("\"name\":\"publish\"");
+    ASSERT_NE(dag, std::string::npos);
+    ASSERT_NE(publish, std::string::npos);
+    EXPECT_LT(dag, publish);
+    EXPECT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+}
@@ -0,0 +1,34 @@
+/**
+ * @file test_startup_timer.cpp
+ * @brief Unit tests for StartupTimer
+ */
+
+#include <gtest/gtest.h>
+
+#include "startup_timer.h"
+
+#include <thread>
+
+using namespace can2vss;
+using namespace std::chrono_literals;
+
+TEST(StartupTimerTest, PhasesAreConsecutive) {
+    StartupTimer timer;
+    std::this_thread::sleep_for(2ms);
+    timer.mark("first");
+    timer.mark("second");
+
+    ASSERT_EQ(timer.phases().size(), 2u);
+    EXPECT_EQ(timer.phases()[0].name, "first");
+    EXPECT_GE(timer.phases()[0].duration, 2ms);
+    EXPECT_LT(timer.phases()[1].duration, timer.phases()[0].duration);
+    EXPECT_GE(timer.elapsed(), timer.phases()[0].duration + timer.phases()[1].duration);
+}
+
+TEST(StartupTimerTest, ReportListsPhasesAndTotal) {
+    StartupTimer timer;
+    timer.mark("mapping YAML parse");
+    const std::string report = timer.report();
+    EXPECT_NE(report.find("mapping YAML parse"), std::string::npos);
+    EXPECT_NE(report.find("total"), std::string::npos);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file test_struct_buffer.cpp
+ * @brief Unit tests for the seqlock struct signal buffer
+ */
+
+#include <gtest/gtest.h>
+
+#include "struct_buffer.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace can2vss;
+
+namespace {
+
+StructBuffer make_buffer() {
+    return StructBuffer("Types.Sample",
+                        {{"flag", SlotType::BOOL}, {"count", SlotType::INT32}, {"level", SlotType::FLOAT},
+                         {"total", SlotType::DOUBLE}});
+}
+
+}  // namespace
+
+TEST(StructBufferTest, EmptyUntilFirstStore) {
+    StructBuffer buffer = make_buffer();
+    TypedValue values[4];
+    EXPECT_FALSE(buffer.load(values));
+    EXPECT_EQ(buffer.type_name(), "Types.Sample");
+    EXPECT_EQ(buffer.fields().size(), 4u);
+}
+
+TEST(StructBufferTest, LoadReturnsStoredFieldsWithTheirTypes) {
+    StructBuffer buffer = make_buffer();
+    const TypedValue stored[4] = {TypedValue::of(true), TypedValue::of(int32_t{-7}), TypedValue::of(1.5f),
+                                  TypedValue::of(2.25)};
+    buffer.store(stored);
+
+    TypedValue loaded[4];
+    ASSERT_TRUE(buffer.load(loaded));
+    EXPECT_EQ(loaded[0].type, SlotType::BOOL);
+    EXPECT_TRUE(loaded[0].b);
+    EXPECT_EQ(loaded[1].type, SlotType::INT32);
+    EXPECT_EQ(loaded[1].i, -7);
+    EXPECT_EQ(loaded[2].type, SlotType::FLOAT);
+    EXPECT_FLOAT_EQ(loaded[2].f, 1.5f);
+    EXPECT_EQ(loaded[3].type, SlotType::DOUBLE);
+    EXPECT_DOUBLE_EQ(loaded[3].d, 2.25);
+}
+
+TEST(StructBufferTest, ReadersNeverSeeTornStructs) {
+    StructBuffer buffer("Types.Pair", {{"a", SlotType::INT64}, {"b", SlotType::INT64}});
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::thread reader([&] {
+        TypedValue values[2];
+        while (!done.load(std::memory_order_acquire)) {
+            if (buffer.load(values) && values[0].i != -values[1].i) {
+                torn.fetch_add(1);
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    TypedValue values[2];
+    for (int64_t i = 0; i < 100000; ++i) {
+        values[0] = TypedValue::of(i);
+        values[1] = TypedValue::of(-i);
+        buffer.store(values);
+        if (i % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    EXPECT_EQ(torn.load(), 0);
+}
@@ -0,0 +1,187 @@
+/**
+ * @file can2vss_codegen.cpp
+ * @brief Build-time generator of specialized CAN decoders and DAG evaluation
+ *
+ * Usage: can2vss-codegen <dbc_file> <mapping_yaml_file> <output_header> [<dag_header>]
+ *
+ * Reads the mapping to find which DBC signals are used, parses only the DBC
+ * messages holding them and writes a header with compile-time specialized
+ * decode functions for exactly those signals.
+ * If a DAG header is requested, also writes typed evaluation code for the
+ * natively expressible part of the mapping DAG. Outputs are only rewritten
+ * when their content changes.
+ */
+
+#include "dag_codegen.h"
+#include "decoder_codegen.h"
+#include "dbc_parser.h"
+#include "signal_operators.h"
+
+#include <yaml-cpp/yaml.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+std::set<std::string> collect_mapped_signals(const YAML::Node& root) {
+    std::set<std::string> names;
+    for (const auto& mapping_node : root["mappings"]) {
+        const auto& source = mapping_node["source"];
+        if (!source || !source["name"]) {
+            continue;
+        }
+        std::string type = source["type"] ? source["type"].as<std::string>() : "";
+        if (type == "dbc" || type == "can") {
+            names.insert(source["name"].as<std::string>());
+        }
+    }
+    return names;
+}
+
+bool is_operator_transform(const YAML::Node& transform) {
+    if (!transform || !transform.IsMap()) {
+        return false;
+    }
+    for (const auto& entry : transform) {
+        if (can2vss::operator_kind_from_key(entry.first.as<std::string>())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<can2vss::DagNodeSpec> collect_dag_specs(const YAML::Node& root) {
+    std::vector<can2vss::DagNodeSpec> specs;
+    for (const auto& mapping_node : root["mappings"]) {
+        if (!mapping_node["signal"]) {
+            continue;
+        }
+        can2vss::DagNodeSpec spec;
+        spec.name = mapping_node["signal"].as<std::string>();
+        if (const auto& source = mapping_node["source"]) {
+            spec.source_type = source["type"] ? source["type"].as<std::string>() : "";
+            spec.source_name = source["name"] ? source["name"].as<std::string>() : "";
+        }
+        spec.datatype = mapping_node["datatype"] ? mapping_node["datatype"].as<std::string>() : "";
+        if (mapping_node["struct_type"]) {
+            spec.datatype = "struct";
+            spec.struct_type = mapping_node["struct_type"].as<std::string>();
+        }
+        spec.interval_ms = mapping_node["interval_ms"].as<int>(0);
+        spec.update_trigger = mapping_node["update_trigger"] ? mapping_node["update_trigger"].as<std::string>() : "";
+        if (const auto& deps = mapping_node["depends_on"]) {
+            for (const auto& dep : deps) {
+                spec.depends_on.push_back(dep.as<std::string>());
+            }
+        }
+        if (const auto& transform = mapping_node["transform"]; is_operator_transform(transform)) {
+            // Computed by the operator stage, whose output is the node's input
+            spec.source_type = std::string(can2vss::kOperatorSourceType);
+            spec.source_name = spec.name;
+            spec.depends_on.clear();
+        } else if (transform) {
+            if (transform["code"] || transform["math"]) {
+                spec.transform = can2vss::DagNodeSpec::Transform::CODE;
+                spec.code = (transform["code"] ? transform["code"] : transform["math"]).as<std::string>();
+            } else if (transform["mapping"]) {
+                spec.transform = can2vss::DagNodeSpec::Transform::VALUE_MAP;
+                for (const auto& item : transform["mapping"]) {
+                    spec.value_map.emplace_back(item["from"].as<std::string>(), item["to"].as<std::string>());
+                }
+            }
+        }
+        specs.push_back(std::move(spec));
+    }
+    return specs;
+}
+
+bool write_if_changed(const std::string& path, const std::string& content) {
+    std::ifstream existing(path);
+    if (existing) {
+        std::stringstream current;
+        current << existing.rdbuf();
+        if (current.str() == content) {
+            return true;
+        }
+    }
+    // A bare file name has no directory to create
+    if (const auto directory = std::filesystem::path(path).parent_path(); !directory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            std::cerr << "can2vss-codegen: can not create " << directory.string() << ": " << error.message()
+                      << "\n";
+            return false;
+        }
+    }
+    std::ofstream out(path);
+    out << content;
+    return static_cast<bool>(out);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 4 && argc != 5) {
+        std::cerr << "Usage: " << argv[0] << " <dbc_file> <mapping_yaml_file> <output_header> [<dag_header>]\n";
+        return 1;
+    }
+    const std::string dbc_file = argv[1];
+    const std::string yaml_file = argv[2];
+    const std::string output = argv[3];
+
+    YAML::Node root;
+    try {
+        root = YAML::LoadFile(yaml_file);
+    } catch (const YAML::Exception& e) {
+        std::cerr << "can2vss-codegen: failed to load " << yaml_file << ": " << e.what() << "\n";
+        return 1;
+    }
+    if (!root["mappings"]) {
+        std::cerr << "can2vss-codegen: no 'mappings' section in " << yaml_file << "\n";
+        return 1;
+    }
+
+    auto mapped = collect_mapped_signals(root);
+    auto db = can2vss::parse_dbc_file_for_signals(dbc_file, mapped);
+    if (!db.ok()) {
+        std::cerr << "can2vss-codegen: " << db.status() << "\n";
+        return 1;
+    }
+    auto description = std::filesystem::path(dbc_file).filename().string() + " and " +
+                       std::filesystem::path(yaml_file).filename().string();
+    auto header = can2vss::generate_decoders(*db, mapped, description);
+    if (!header.ok()) {
+        std::cerr << "can2vss-codegen: " << header.status() << "\n";
+        return 1;
+    }
+
+    if (!write_if_changed(output, *header)) {
+        std::cerr << "can2vss-codegen: failed to write " << output << "\n";
+        return 1;
+    }
+    std::cout << "can2vss-codegen: " << mapped.size() << " signals -> " << output << "\n";
+
+    if (argc == 5) {
+        const std::string dag_output = argv[4];
+        auto dag = can2vss::generate_dag(collect_dag_specs(root), description);
+        if (!dag.ok()) {
+            std::cerr << "can2vss-codegen: " << dag.status() << "\n";
+            return 1;
+        }
+        if (!write_if_changed(dag_output, dag->header)) {
+            std::cerr << "can2vss-codegen: failed to write " << dag_output << "\n";
+            return 1;
+        }
+        for (const auto& [name, reason] : dag->interpreted) {
+            std::cout << "can2vss-codegen: " << name << " stays interpreted: " << reason << "\n";
+        }
+        std::cout << "can2vss-codegen: " << dag->generated.size() << " DAG nodes -> " << dag_output << "\n";
+    }
+    return 0;
+}